@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <nit/enum/card_abstraction.h>
+#include <nit/enum/hand_potential_table.h>
+
+#include "guard.h"
+
+namespace po = boost::program_options;
+
+namespace {
+
+int runBuckets(int argc, char** argv) {
+  po::options_description desc(
+      "hold'em card abstraction, the bucket of every holding on a street");
+  // clang-format off
+  desc.add_options()
+      ("help,?", "produce help message")
+      ("table,t", po::value<std::string>(), "look the holdings up in a table")
+      ("build,b", po::value<std::string>(), "build a table and write it here")
+      ("street,s", po::value<std::string>()->default_value("flop"),
+       "the street of the table to build, flop, turn or river")
+      ("buckets,k", po::value<size_t>()->default_value(200),
+       "the number of buckets")
+      ("quantiles,q", po::value<size_t>()->default_value(16),
+       "the quantiles of the equity histogram on the flop and turn")
+      ("iterations,i", po::value<size_t>()->default_value(20),
+       "the most k-medians iterations")
+      ("seed", po::value<uint64_t>()->default_value(0),
+       "the seed of the k-means++ centers")
+      ("threads,j", po::value<size_t>()->default_value(
+           std::max(1u, std::thread::hardware_concurrency())),
+       "threads to enumerate and cluster with")
+      ("board", po::value<std::string>(), "the flop, turn or river")
+      ("hand,h", po::value<std::vector<std::string>>(),
+       "the holdings to show, all of them if none are given");
+  // clang-format on
+
+  po::positional_options_description p;
+  p.add("board", 1);
+  p.add("hand", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(
+        po::command_line_parser(argc, argv).options(desc).positional(p).run(),
+        vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Option error: " << err.what() << "\n\n" << desc << std::endl;
+    return 1;
+  }
+  po::notify(vm);
+
+  if (vm.count("help") || argc == 1) {
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("build")) {
+    const std::string street = vm["street"].as<std::string>();
+    size_t cards = street == "flop" ? 3 : street == "turn" ? 4
+                                        : street == "river" ? 5 : 0;
+    if (cards == 0) {
+      std::cerr << "the street is flop, turn or river" << std::endl;
+      return 1;
+    }
+    nit::AbstractionOptions options;
+    options.buckets = vm["buckets"].as<size_t>();
+    options.quantiles = vm["quantiles"].as<size_t>();
+    options.iterations = vm["iterations"].as<size_t>();
+    options.threads = vm["threads"].as<size_t>();
+    options.seed = vm["seed"].as<uint64_t>();
+    const std::string path = vm["build"].as<std::string>();
+    double cost = nit::CardAbstraction::build(path, cards, options);
+    std::cout << "wrote " << nit::HandPotentialTable::boards(cards).size()
+              << " boards to " << path << ", mean distance to the bucket "
+              << cost << std::endl;
+    return 0;
+  }
+
+  if (!vm.count("table") || !vm.count("board")) {
+    std::cerr << "a table and a board are needed" << std::endl;
+    return 1;
+  }
+  nit::CardAbstraction table(vm["table"].as<std::string>());
+  const std::string board = vm["board"].as<std::string>();
+  const nit::CardSet cards(board);
+  std::vector<std::string> hands;
+  if (vm.count("hand")) {
+    hands = vm["hand"].as<std::vector<std::string>>();
+  } else {
+    for (size_t hi = 1; hi < nit::STANDARD_DECK_SIZE; hi++) {
+      for (size_t lo = 0; lo < hi; lo++) {
+        nit::CardSet hand((UINT64_C(1) << hi) | (UINT64_C(1) << lo));
+        if (!hand.intersects(cards))
+          hands.push_back(hand.str());
+      }
+    }
+  }
+  for (const std::string& hand : hands)
+    std::cout << "The hand " << hand << " on " << board << " is in bucket "
+              << table.bucket(cards, nit::CardSet(hand)) << " of "
+              << table.buckets() << std::endl;
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return guard([&argc, &argv] { return runBuckets(argc, argv); });
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <nit/enum/hand_potential_enumerator.h>
+#include <nit/enum/hand_potential_table.h>
+
+#include "guard.h"
+
+namespace po = boost::program_options;
+
+namespace {
+
+void print(const std::string& hand, const std::string& board,
+           const nit::HandPotential& potential) {
+  std::cout << "The hand " << hand << " on " << board << " has strength "
+            << potential.strength << ", EHS " << potential.ehs << ", EHS2 "
+            << potential.ehs2 << ", PPot " << potential.ppot << ", NPot "
+            << potential.npot << std::endl;
+}
+
+int runEhs(int argc, char** argv) {
+  po::options_description desc(
+      "hold'em hand strength and potential of every holding on a board");
+  // clang-format off
+  desc.add_options()
+      ("help,?", "produce help message")
+      ("table,t", po::value<std::string>(), "look the holdings up in a table")
+      ("build,b", po::value<std::string>(), "build a table and write it here")
+      ("street,s", po::value<std::string>()->default_value("flop"),
+       "the street of the table to build, flop, turn or river")
+      ("threads,j", po::value<size_t>()->default_value(
+           std::max(1u, std::thread::hardware_concurrency())),
+       "threads to enumerate with")
+      ("board", po::value<std::string>(), "the flop, turn or river")
+      ("hand,h", po::value<std::vector<std::string>>(),
+       "the holdings to show, all of them if none are given");
+  // clang-format on
+
+  po::positional_options_description p;
+  p.add("board", 1);
+  p.add("hand", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(
+        po::command_line_parser(argc, argv).options(desc).positional(p).run(),
+        vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Option error: " << err.what() << "\n\n" << desc << std::endl;
+    return 1;
+  }
+  po::notify(vm);
+
+  if (vm.count("help") || argc == 1) {
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  nit::HandPotentialEnumerator enumerator(vm["threads"].as<size_t>());
+  if (vm.count("build")) {
+    const std::string street = vm["street"].as<std::string>();
+    size_t cards = street == "flop" ? 3 : street == "turn" ? 4
+                                        : street == "river" ? 5 : 0;
+    if (cards == 0) {
+      std::cerr << "the street is flop, turn or river" << std::endl;
+      return 1;
+    }
+    const std::string path = vm["build"].as<std::string>();
+    nit::HandPotentialTable::build(path, cards, enumerator);
+    std::cout << "wrote " << nit::HandPotentialTable::boards(cards).size()
+              << " boards to " << path << std::endl;
+    return 0;
+  }
+
+  if (!vm.count("board")) {
+    std::cerr << "a board is needed" << std::endl;
+    return 1;
+  }
+  const std::string board = vm["board"].as<std::string>();
+  const nit::CardSet cards(board);
+  std::vector<std::string> hands;
+  if (vm.count("hand")) {
+    hands = vm["hand"].as<std::vector<std::string>>();
+  } else {
+    for (size_t hi = 1; hi < nit::STANDARD_DECK_SIZE; hi++) {
+      for (size_t lo = 0; lo < hi; lo++) {
+        nit::CardSet hand((UINT64_C(1) << hi) | (UINT64_C(1) << lo));
+        if (!hand.intersects(cards))
+          hands.push_back(hand.str());
+      }
+    }
+  }
+
+  if (vm.count("table")) {
+    nit::HandPotentialTable table(vm["table"].as<std::string>());
+    for (const std::string& hand : hands)
+      print(hand, board, table.get(cards, nit::CardSet(hand)));
+    return 0;
+  }
+
+  std::vector<nit::HandPotential> potentials = enumerator.calculate(cards);
+  for (const std::string& hand : hands) {
+    nit::CardSet holding(hand);
+    if (holding.size() != 2 || holding.intersects(cards)) {
+      std::cerr << "a holding has two cards off the board: " << hand
+                << std::endl;
+      return 1;
+    }
+    print(hand, board, potentials[holding.colex()]);
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return guard([&argc, &argv] { return runEhs(argc, argv); });
+}
@@ -1,10 +1,15 @@
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include <boost/program_options.hpp>
 
+#include <nit/enum/equity_planner.h>
+#include <nit/enum/partial_result.h>
 #include <nit/enum/showdown_enumerator.h>
 #include <nit/eval/make_evaluator.h>
 
@@ -14,6 +19,88 @@ namespace po = boost::program_options;
 
 namespace {
 
+/// print the equity of each hand, along with the raw shares
+void printResults(const std::vector<std::string>& hands,
+                  const std::vector<nit::EquityResult>& results,
+                  const std::vector<std::string>& shares) {
+  double total = 0.0;
+  for (const nit::EquityResult& result : results) {
+    total += result.winShares + result.tieShares;
+  }
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    double equity = (results[i].winShares + results[i].tieShares) / total;
+    std::string handDesc =
+        (i < hands.size()) ? "The hand " + hands[i] : "A random hand";
+    std::cout << handDesc << " has " << equity * 100. << " % equity ("
+              << shares[i] << ")" << std::endl;
+  }
+}
+
+/// print exact results, the shares are printed as integers
+void printExactResults(const std::vector<std::string>& hands,
+                       const std::vector<nit::ExactEquityResult>& exact) {
+  std::vector<nit::EquityResult> results;
+  std::vector<std::string> shares;
+  for (const nit::ExactEquityResult& result : exact) {
+    results.push_back(result.toEquityResult());
+    shares.push_back(result.str());
+  }
+  printResults(hands, results, shares);
+}
+
+/// parse a pot given as amount:i,j,... where i, j index the hands
+nit::Pot parsePot(const std::string& spec) {
+  nit::Pot pot;
+  size_t colon = spec.find(':');
+  try {
+    if (colon == std::string::npos)
+      throw std::invalid_argument(spec);
+    size_t end = 0;
+    pot.amount = std::stod(spec.substr(0, colon), &end);
+    if (end != colon)
+      throw std::invalid_argument(spec);
+    std::stringstream players(spec.substr(colon + 1));
+    std::string player;
+    while (std::getline(players, player, ',')) {
+      pot.players.push_back(std::stoul(player, &end));
+      if (end != player.size())
+        throw std::invalid_argument(spec);
+    }
+  } catch (const std::exception&) {
+    throw nit::InvalidArgument("pots are given as amount:i,j,...")
+        << nit::errinfo_value(spec);
+  }
+  return pot;
+}
+
+/// print the amount each hand is expected to win
+void printWinnings(const std::vector<std::string>& hands,
+                   const std::vector<double>& won) {
+  for (size_t i = 0; i < won.size(); ++i) {
+    std::string handDesc =
+        (i < hands.size()) ? "The hand " + hands[i] : "A random hand";
+    std::cout << handDesc << " wins " << won[i] << " on average" << std::endl;
+  }
+}
+
+/// merge the partial results of a sharded run, and print them
+int runMerge(const std::vector<std::string>& files, bool quiet) {
+  std::vector<nit::PartialResult> partials;
+  for (const std::string& file : files) {
+    std::ifstream in(file);
+    if (!in) {
+      std::cerr << "could not open " << file << std::endl;
+      return 1;
+    }
+    partials.push_back(nit::PartialResult::read(in));
+  }
+  nit::PartialResult merged = nit::mergePartialResults(partials);
+  if (!quiet)
+    printExactResults(merged.hands, merged.results);
+  return 0;
+}
+
 int runEval(int argc, char** argv) {
   po::options_description desc("nit-eval, a poker hand evaluator");
 
@@ -24,6 +111,24 @@ int runEval(int argc, char** argv) {
        "game to use for evaluation")
       ("board,b", po::value<std::string>(), "community cards for he/o/o8")
       ("hand,h", po::value<std::vector<std::string>>(), "a hand for evaluation")
+      ("exact,x", "count the shares exactly, weights must be whole numbers")
+      ("shard,s", po::value<std::string>(),
+       "enumerate only shard i/N, and print its partial result")
+      ("merge,m", po::value<std::vector<std::string>>()->multitoken(),
+       "merge the partial result files of all shards of a query")
+      ("checkpoint,c", po::value<std::string>(),
+       "save progress to a file, and resume from it, implies --exact")
+      ("checkpoint-interval", po::value<double>()->default_value(60.0),
+       "seconds between checkpoints")
+      ("budget,t", po::value<double>(),
+       "seconds to spend, enumerate if it fits and sample otherwise")
+      ("dry-run,n", "print the plan for the budget, and do not run it")
+      ("pot,p", po::value<std::vector<std::string>>()->multitoken(),
+       "a pot and the hands which can win it, as amount:i,j,...")
+      ("runs,r", po::value<size_t>()->default_value(1),
+       "run the board out this many times, from the same deck")
+      ("eval-cache", po::value<size_t>()->default_value(0),
+       "cache this many evaluations, worth it for omaha and the lowball games")
       ("quiet,q", "produces no output");
   // clang-format on
 
@@ -33,7 +138,11 @@ int runEval(int argc, char** argv) {
 
   po::variables_map vm;
   try {
-    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(p)
+                  .run(),
+              vm);
   } catch (const std::exception& err) {
     std::cerr << "Option error: " << err.what() << "\n\n" << desc << std::endl;
     return 1;
@@ -46,12 +155,29 @@ int runEval(int argc, char** argv) {
     return 1;
   }
 
+  bool quiet = vm.count("quiet") > 0;
+
+  if (vm.count("merge"))
+    return runMerge(vm["merge"].as<std::vector<std::string>>(), quiet);
+
+  if (!vm.count("hand")) {
+    std::cerr << "no hands to evaluate\n\n" << desc << std::endl;
+    return 1;
+  }
+
   // extract the options
   std::string game = vm["game"].as<std::string>();
   std::string board = vm.count("board") ? vm["board"].as<std::string>() : "";
   std::vector<std::string> hands = vm["hand"].as<std::vector<std::string>>();
 
-  bool quiet = vm.count("quiet") > 0;
+  nit::EnumerationOptions options;
+  if (vm.count("shard"))
+    options.shard = nit::Shard::parse(vm["shard"].as<std::string>());
+  if (vm.count("checkpoint")) {
+    options.checkpointFile = vm["checkpoint"].as<std::string>();
+    options.checkpointInterval = vm["checkpoint-interval"].as<double>();
+  }
+  options.evaluationCache = vm["eval-cache"].as<size_t>();
 
   // allocate evaluator and create card distributions
   std::unique_ptr<nit::PokerHandEvaluator> evaluator = nit::makeEvaluator(game);
@@ -67,23 +193,94 @@ int runEval(int argc, char** argv) {
     handDists.back().fill(evaluator->handSize());
   }
 
-  // calculate the results and print them
-  nit::ShowdownEnumerator showdown;
-  std::vector<nit::EquityResult> results =
-      showdown.calculateEquity(handDists, nit::CardSet(board), *evaluator);
+  // run it more than once, each board for an equal part of the pot
+  size_t runs = vm["runs"].as<size_t>();
+  if (runs > 1) {
+    nit::MultiBoardResult result =
+        nit::ShowdownEnumerator().calculateMultiBoardEquity(
+            handDists, std::vector<nit::CardSet>(runs, nit::CardSet(board)),
+            *evaluator, options);
+    if (!quiet) {
+      for (size_t b = 0; b < runs; b++) {
+        std::cout << "Board " << b + 1 << ":" << std::endl;
+        std::vector<std::string> shares;
+        for (const nit::EquityResult& r : result.boards[b])
+          shares.push_back(r.str());
+        printResults(hands, result.boards[b], shares);
+      }
+      std::cout << "All boards:" << std::endl;
+      std::vector<std::string> shares;
+      for (const nit::EquityResult& r : result.combined)
+        shares.push_back(r.str());
+      printResults(hands, result.combined, shares);
+    }
+    return 0;
+  }
 
-  double total = 0.0;
-  for (const nit::EquityResult& result : results) {
-    total += result.winShares + result.tieShares;
+  // award every pot from the same enumeration
+  if (vm.count("pot")) {
+    std::vector<nit::Pot> pots;
+    for (const std::string& spec : vm["pot"].as<std::vector<std::string>>())
+      pots.push_back(parsePot(spec));
+    nit::SidePotVisitor visitor(pots, handDists.size());
+    nit::ShowdownEnumerator().visit(handDists, nit::CardSet(board), *evaluator,
+                                    visitor, options);
+    if (!quiet)
+      printWinnings(hands, visitor.winnings());
+    return 0;
   }
 
-  if (!quiet) {
-    for (size_t i = 0; i < results.size(); ++i) {
-      double equity = (results[i].winShares + results[i].tieShares) / total;
-      std::string handDesc =
-          (i < hands.size()) ? "The hand " + hands[i] : "A random hand";
-      std::cout << handDesc << " has " << equity * 100. << " % equity ("
-                << results[i].str() << ")" << std::endl;
+  // plan the query within the budget
+  if (vm.count("budget") || vm.count("dry-run")) {
+    double budget = vm.count("budget") ? vm["budget"].as<double>() : 60.0;
+    nit::EquityPlanner planner;
+    if (vm.count("dry-run")) {
+      std::cout << planner.plan(handDists, nit::CardSet(board), *evaluator,
+                                budget)
+                       .str();
+      return 0;
+    }
+    nit::PlannedEquity planned = planner.calculateEquity(
+        handDists, nit::CardSet(board), *evaluator, budget,
+        options.evaluationCache);
+    if (!quiet) {
+      std::vector<std::string> shares;
+      for (const nit::EquityResult& result : planned.results)
+        shares.push_back(result.str());
+      printResults(hands, planned.results, shares);
+      if (planned.plan.method == nit::EquityMethod::MonteCarlo)
+        std::cout << "sampled " << planned.plan.samples << " deals, +/- "
+                  << planned.errorBound * 100. << " %" << std::endl;
+    }
+    return 0;
+  }
+
+  // calculate the results and print them
+  nit::ShowdownEnumerator showdown;
+  if (vm.count("shard")) {
+    nit::PartialResult partial;
+    partial.game = game;
+    partial.board = board;
+    partial.hands = hands;
+    partial.shard = options.shard;
+    partial.results = showdown.calculateExactEquity(
+        handDists, nit::CardSet(board), *evaluator, options);
+    if (!quiet)
+      partial.write(std::cout);
+  } else if (vm.count("exact") || vm.count("checkpoint")) {
+    std::vector<nit::ExactEquityResult> results = showdown.calculateExactEquity(
+        handDists, nit::CardSet(board), *evaluator, options);
+    if (!quiet)
+      printExactResults(hands, results);
+  } else {
+    std::vector<nit::EquityResult> results =
+        showdown.calculateEquity(handDists, nit::CardSet(board), *evaluator,
+                                 options);
+    if (!quiet) {
+      std::vector<std::string> shares;
+      for (const nit::EquityResult& result : results)
+        shares.push_back(result.str());
+      printResults(hands, results, shares);
     }
   }
 
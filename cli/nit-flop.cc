@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <nit/enum/flop_equity_table.h>
+#include <nit/eval/make_evaluator.h>
+#include <nit/util/parallel_for.h>
+
+#include "guard.h"
+
+namespace po = boost::program_options;
+
+namespace {
+
+const char* const kHandClasses[nit::NUM_EVAL_TYPES] = {
+    "high card",   "one pair", "three flush", "three straight",
+    "two pair",    "trips",    "three straight flush",
+    "straight",    "flush",    "full house",  "quads",
+    "straight flush"};
+
+/// enumerate the holdings of every flop class, on a few threads
+void buildTable(const std::string& path, size_t nthreads) {
+  const std::vector<uint64_t>& flops = nit::FlopEquityTable::flops();
+  std::vector<nit::FlopHoldingEntry> entries(flops.size() *
+                                             nit::FlopEquityTable::kHoldings);
+  std::vector<std::unique_ptr<nit::PokerHandEvaluator>> pevals;
+  for (size_t t = 0; t < nthreads; t++)
+    pevals.push_back(nit::makeEvaluator("h"));
+  nit::parallelFor(flops.size(), nthreads, [&](size_t thread, size_t i) {
+    std::vector<nit::FlopHoldingEntry> flop =
+        nit::FlopEquityTable::build(nit::CardSet(flops[i]), *pevals[thread]);
+    std::copy(flop.begin(), flop.end(),
+              entries.begin() + i * nit::FlopEquityTable::kHoldings);
+  });
+
+  nit::FlopEquityTable::write(path, entries);
+  std::cout << "wrote " << flops.size() << " flops to " << path << std::endl;
+}
+
+int runFlop(int argc, char** argv) {
+  po::options_description desc(
+      "hold'em equity and strength of a holding on the flop, from a table");
+  // clang-format off
+  desc.add_options()
+      ("help,?", "produce help message")
+      ("table,t", po::value<std::string>(), "the table to read")
+      ("build,b", po::value<std::string>(), "build a table and write it here")
+      ("threads,j", po::value<size_t>()->default_value(
+           std::max(1u, std::thread::hardware_concurrency())),
+       "threads to build the table with")
+      ("flop,f", po::value<std::string>(), "the flop")
+      ("hand,h", po::value<std::vector<std::string>>(),
+       "the holdings to look up, all of them if none are given");
+  // clang-format on
+
+  po::positional_options_description p;
+  p.add("flop", 1);
+  p.add("hand", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(
+        po::command_line_parser(argc, argv).options(desc).positional(p).run(),
+        vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Option error: " << err.what() << "\n\n" << desc << std::endl;
+    return 1;
+  }
+  po::notify(vm);
+
+  if (vm.count("help") || argc == 1) {
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("build")) {
+    buildTable(vm["build"].as<std::string>(),
+               std::max<size_t>(1, vm["threads"].as<size_t>()));
+    return 0;
+  }
+
+  if (!vm.count("table") || !vm.count("flop")) {
+    std::cerr << "a table and a flop are needed, see --table" << std::endl;
+    return 1;
+  }
+  nit::FlopEquityTable table(vm["table"].as<std::string>());
+  const std::string board = vm["flop"].as<std::string>();
+  nit::CardSet flop(board);
+
+  std::vector<std::string> hands;
+  if (vm.count("hand")) {
+    hands = vm["hand"].as<std::vector<std::string>>();
+  } else {
+    for (size_t hi = 1; hi < nit::STANDARD_DECK_SIZE; hi++) {
+      for (size_t lo = 0; lo < hi; lo++) {
+        nit::CardSet hand((UINT64_C(1) << hi) | (UINT64_C(1) << lo));
+        if (!hand.intersects(flop))
+          hands.push_back(hand.str());
+      }
+    }
+  }
+  for (const std::string& hand : hands) {
+    const nit::FlopHoldingEntry& entry = table.get(flop, nit::CardSet(hand));
+    std::cout << "The hand " << hand << " has " << entry.equity * 100.
+              << " % equity against a random hand on " << board << " ("
+              << kHandClasses[entry.handClass] << ", "
+              << nit::FlopEquityTable::drawName(entry.drawClass) << ")"
+              << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return guard([&argc, &argv] { return runFlop(argc, argv); });
+}
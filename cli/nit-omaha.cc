@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <nit/enum/omaha_equity_table.h>
+#include <nit/eval/make_evaluator.h>
+#include <nit/util/parallel_for.h>
+
+#include "guard.h"
+
+namespace po = boost::program_options;
+
+namespace {
+
+/// sample every class against a random hand, on a few threads
+void buildTable(const std::string& path, char game, uint64_t samples,
+                size_t nthreads) {
+  const std::vector<uint64_t>& classes = nit::OmahaEquityTable::classes();
+  std::vector<nit::OmahaClassEquity> entries(classes.size());
+  std::vector<double> bounds(classes.size());
+  std::vector<std::unique_ptr<nit::PokerHandEvaluator>> pevals;
+  for (size_t t = 0; t < nthreads; t++)
+    pevals.push_back(nit::makeEvaluator(std::string(1, game)));
+  nit::parallelFor(classes.size(), nthreads, [&](size_t thread, size_t i) {
+    entries[i] = nit::OmahaEquityTable::sample(
+        *pevals[thread], nit::CardSet(classes[i]), samples, i, bounds[i]);
+  });
+
+  double bound = *std::max_element(bounds.begin(), bounds.end());
+  nit::OmahaEquityTable::write(path, game, samples, bound, entries);
+  std::cout << "wrote " << entries.size() << " classes to " << path
+            << ", equities within " << bound << std::endl;
+}
+
+int runOmaha(int argc, char** argv) {
+  po::options_description desc(
+      "omaha starting hand equity against a random hand, from a table");
+  // clang-format off
+  desc.add_options()
+      ("help,?", "produce help message")
+      ("table,t", po::value<std::string>(), "the table to read")
+      ("build,b", po::value<std::string>(), "build a table and write it here")
+      ("game,g", po::value<std::string>()->default_value("O"),
+       "O for omaha high, o for omaha/8")
+      ("samples", po::value<uint64_t>()->default_value(100000),
+       "deals sampled per class")
+      ("threads,j", po::value<size_t>()->default_value(
+           std::max(1u, std::thread::hardware_concurrency())),
+       "threads to build the table with")
+      ("hand,h", po::value<std::vector<std::string>>(),
+       "the hands to look up");
+  // clang-format on
+
+  po::positional_options_description p;
+  p.add("hand", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(
+        po::command_line_parser(argc, argv).options(desc).positional(p).run(),
+        vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Option error: " << err.what() << "\n\n" << desc << std::endl;
+    return 1;
+  }
+  po::notify(vm);
+
+  if (vm.count("help") || argc == 1) {
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("build")) {
+    std::string game = vm["game"].as<std::string>();
+    if (game != "O" && game != "o") {
+      std::cerr << "the game is O or o" << std::endl;
+      return 1;
+    }
+    buildTable(vm["build"].as<std::string>(), game[0],
+               vm["samples"].as<uint64_t>(),
+               std::max<size_t>(1, vm["threads"].as<size_t>()));
+    return 0;
+  }
+
+  if (!vm.count("table")) {
+    std::cerr << "a table is needed, see --table" << std::endl;
+    return 1;
+  }
+  nit::OmahaEquityTable table(vm["table"].as<std::string>());
+  std::vector<std::string> hands =
+      vm.count("hand") ? vm["hand"].as<std::vector<std::string>>()
+                       : std::vector<std::string>();
+  for (const std::string& hand : hands) {
+    const nit::OmahaClassEquity& entry = table.get(nit::CardSet(hand));
+    std::cout << "The hand " << hand << " has " << entry.equity * 100.
+              << " % equity against a random hand";
+    if (table.game() == 'o')
+      std::cout << " (scoop " << entry.scoop * 100. << " %, high "
+                << entry.high * 100. << " %, low " << entry.low * 100.
+                << " %)";
+    std::cout << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return guard([&argc, &argv] { return runOmaha(argc, argv); });
+}
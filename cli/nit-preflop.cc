@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <nit/enum/preflop_equity_table.h>
+#include <nit/enum/random_opponents_table.h>
+#include <nit/enum/showdown_enumerator.h>
+#include <nit/eval/make_evaluator.h>
+#include <nit/util/parallel_for.h>
+
+#include "guard.h"
+
+namespace po = boost::program_options;
+
+namespace {
+
+/// @returns the equity of the first of two results
+double equity(const std::vector<nit::EquityResult>& results) {
+  double total = 0.0;
+  for (const nit::EquityResult& result : results)
+    total += result.winShares + result.tieShares;
+  return total > 0.0 ? (results[0].winShares + results[0].tieShares) / total
+                     : 0.0;
+}
+
+/**
+ * enumerate every distinct matchup, or those with a hand of one of the
+ * classes if any are given, on a few threads
+ */
+void buildTable(const std::string& path, size_t nthreads,
+                const std::set<std::string>& classes) {
+  std::vector<uint32_t> keys;
+  for (uint32_t key : nit::PreflopEquityTable::keys()) {
+    nit::CardSet a, b;
+    nit::PreflopEquityTable::hands(key, a, b);
+    if (classes.empty() ||
+        classes.count(nit::PreflopEquityTable::handClass(a)) ||
+        classes.count(nit::PreflopEquityTable::handClass(b)))
+      keys.push_back(key);
+  }
+
+  std::vector<nit::PreflopMatchup> entries(keys.size());
+  std::vector<std::unique_ptr<nit::PokerHandEvaluator>> pevals;
+  for (size_t t = 0; t < nthreads; t++)
+    pevals.push_back(nit::makeEvaluator("h"));
+  nit::parallelFor(keys.size(), nthreads, [&](size_t thread, size_t i) {
+    nit::CardSet a, b;
+    nit::PreflopEquityTable::hands(keys[i], a, b);
+    std::vector<nit::CardDistribution> dists = {nit::CardDistribution(a),
+                                                nit::CardDistribution(b)};
+    std::vector<nit::EquityResult> results = nit::ShowdownEnumerator()
+        .calculateEquity(dists, nit::CardSet(), *pevals[thread]);
+    entries[i].key = keys[i];
+    entries[i].wins = static_cast<uint32_t>(results[0].winShares);
+    entries[i].losses = static_cast<uint32_t>(results[1].winShares);
+    entries[i].ties = static_cast<uint32_t>(results[0].tieShares * 2.0);
+  });
+
+  nit::PreflopEquityTable::write(path, entries);
+  std::cout << "wrote " << entries.size() << " matchups to " << path
+            << std::endl;
+}
+
+/**
+ * fill in every class against every number of random opponents, exactly
+ * against one if there is a table of matchups, and by sampling otherwise
+ */
+void buildRandomTable(const std::string& path, size_t nthreads,
+                      const nit::PreflopEquityTable* matchups,
+                      uint64_t samples) {
+  using nit::RandomOpponentsTable;
+  const size_t njobs =
+      RandomOpponentsTable::kClasses * RandomOpponentsTable::kMaxOpponents;
+  RandomOpponentsTable table;
+  std::mutex lock;
+  nit::parallelFor(njobs, nthreads, [&](size_t, size_t job) {
+    size_t cls = job / RandomOpponentsTable::kMaxOpponents;
+    size_t opponents = job % RandomOpponentsTable::kMaxOpponents + 1;
+    nit::RandomOpponentsEquity entry =
+        matchups && opponents == 1
+            ? RandomOpponentsTable::exact(*matchups, cls)
+            : RandomOpponentsTable::sample(cls, opponents, samples, job);
+    std::lock_guard<std::mutex> guard(lock);
+    table.set(cls, opponents, entry);
+  });
+
+  table.save(path);
+  std::cout << "wrote " << njobs << " entries to " << path << std::endl;
+}
+
+/// print the equity of every class of hands against a range, by class
+void printVersus(const nit::PreflopEquityTable& table,
+                 const nit::CardDistribution& range) {
+  std::map<std::string, std::vector<nit::CardSet>> classes;
+  for (size_t hi = 1; hi < nit::STANDARD_DECK_SIZE; hi++) {
+    for (size_t lo = 0; lo < hi; lo++) {
+      nit::CardSet hand((UINT64_C(1) << hi) | (UINT64_C(1) << lo));
+      classes[nit::PreflopEquityTable::handClass(hand)].push_back(hand);
+    }
+  }
+  for (const auto& entry : classes) {
+    nit::CardDistribution hands(entry.second[0]);
+    for (size_t i = 1; i < entry.second.size(); i++)
+      hands.insert(entry.second[i]);
+    std::vector<nit::EquityResult> results =
+        table.calculateEquity(hands, range);
+    if (results[0].winShares + results[0].tieShares + results[1].winShares > 0)
+      std::cout << entry.first << " " << equity(results) << "\n";
+  }
+}
+
+int runPreflop(int argc, char** argv) {
+  po::options_description desc(
+      "heads up hold'em equity before the flop, from a precomputed table");
+  // clang-format off
+  desc.add_options()
+      ("help,?", "produce help message")
+      ("table,t", po::value<std::string>(), "the table to read")
+      ("build,b", po::value<std::string>(), "build a table and write it here")
+      ("threads,j", po::value<size_t>()->default_value(
+           std::max(1u, std::thread::hardware_concurrency())),
+       "threads to build the table with")
+      ("class,c", po::value<std::vector<std::string>>()->multitoken(),
+       "only build the matchups with a hand of these classes, such as AKs")
+      ("versus,v", po::value<std::string>(),
+       "print the equity of every class of hands against a range")
+      ("build-random", po::value<std::string>(),
+       "build a table of every class against 1 to 9 random hands, exact "
+       "against one with --table, and write it here")
+      ("samples", po::value<uint64_t>()->default_value(1000000),
+       "samples of each entry of the random table")
+      ("random,r", po::value<std::string>(),
+       "look up hands in a table of equity against random hands")
+      ("opponents,k", po::value<size_t>(),
+       "the number of random opponents, all of them if not given")
+      ("hand,h", po::value<std::vector<std::string>>(),
+       "the two hands or ranges to look up");
+  // clang-format on
+
+  po::positional_options_description p;
+  p.add("hand", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(
+        po::command_line_parser(argc, argv).options(desc).positional(p).run(),
+        vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Option error: " << err.what() << "\n\n" << desc << std::endl;
+    return 1;
+  }
+  po::notify(vm);
+
+  if (vm.count("help") || argc == 1) {
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("build")) {
+    std::set<std::string> classes;
+    if (vm.count("class"))
+      for (const std::string& name :
+           vm["class"].as<std::vector<std::string>>())
+        classes.insert(name);
+    buildTable(vm["build"].as<std::string>(),
+               std::max<size_t>(1, vm["threads"].as<size_t>()), classes);
+    return 0;
+  }
+
+  if (vm.count("build-random")) {
+    std::unique_ptr<nit::PreflopEquityTable> matchups;
+    if (vm.count("table"))
+      matchups.reset(
+          new nit::PreflopEquityTable(vm["table"].as<std::string>()));
+    buildRandomTable(vm["build-random"].as<std::string>(),
+                     std::max<size_t>(1, vm["threads"].as<size_t>()),
+                     matchups.get(), vm["samples"].as<uint64_t>());
+    return 0;
+  }
+
+  if (vm.count("random")) {
+    nit::RandomOpponentsTable random =
+        nit::RandomOpponentsTable::load(vm["random"].as<std::string>());
+    size_t first = 1;
+    size_t last = nit::RandomOpponentsTable::kMaxOpponents;
+    if (vm.count("opponents"))
+      first = last = vm["opponents"].as<size_t>();
+    std::vector<std::string> hands =
+        vm.count("hand") ? vm["hand"].as<std::vector<std::string>>()
+                         : std::vector<std::string>();
+    for (const std::string& hand : hands) {
+      // either a class, such as AKs, or the cards of a hand
+      size_t cls = 0;
+      while (cls < nit::RandomOpponentsTable::kClasses &&
+             nit::RandomOpponentsTable::className(cls) != hand)
+        cls++;
+      if (cls == nit::RandomOpponentsTable::kClasses)
+        cls = nit::RandomOpponentsTable::classIndex(nit::CardSet(hand));
+      for (size_t k = first; k <= last; k++)
+        std::cout << "The hand " << hand << " has "
+                  << random.get(cls, k).equity * 100.
+                  << " % equity against " << k << " random hands"
+                  << std::endl;
+    }
+    return 0;
+  }
+
+  if (!vm.count("table")) {
+    std::cerr << "a table is needed, see --table" << std::endl;
+    return 1;
+  }
+  nit::PreflopEquityTable table(vm["table"].as<std::string>());
+
+  if (vm.count("versus")) {
+    nit::CardDistribution range;
+    range.parse(vm["versus"].as<std::string>());
+    printVersus(table, range);
+    return 0;
+  }
+
+  std::vector<std::string> hands =
+      vm.count("hand") ? vm["hand"].as<std::vector<std::string>>()
+                       : std::vector<std::string>();
+  if (hands.size() != 2) {
+    std::cerr << "the table is for two hands" << std::endl;
+    return 1;
+  }
+  nit::CardDistribution a, b;
+  a.parse(hands[0]);
+  b.parse(hands[1]);
+  std::vector<nit::EquityResult> results = table.calculateEquity(a, b);
+  for (size_t i = 0; i < 2; i++) {
+    std::vector<nit::EquityResult> view = {results[i], results[1 - i]};
+    std::cout << "The hand " << hands[i] << " has " << equity(view) * 100.
+              << " % equity (" << results[i].str() << ")" << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return guard([&argc, &argv] { return runPreflop(argc, argv); });
+}
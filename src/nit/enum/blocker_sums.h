@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_BLOCKER_SUMS_H_
+#define NIT_ENUM_BLOCKER_SUMS_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include <boost/math/special_functions/binomial.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/card_set.h>
+#include <nit/util/lastbit.h>
+
+namespace nit {
+
+/**
+ * Accumulates the weights of a set of hands, so that the weight of the
+ * hands which share no card with some other set of cards can be found
+ * without visiting the hands.
+ *
+ * For every subset S of every added hand we keep W(S), the weight of the
+ * added hands containing S.  By inclusion-exclusion the weight of the
+ * hands which are blocked by a set of cards D is
+ *
+ *   sum over non-empty S in D of (-1)^(|S|+1) W(S)
+ *
+ * where only subsets up to the hand size can be non-zero.  The subset
+ * sums are stored densely by colex index, and clear() only touches the
+ * entries which were used.
+ */
+class BlockerSums {
+ public:
+  /// @param handSize  the largest number of cards of an added hand
+  explicit BlockerSums(size_t handSize)
+      : m_handSize(handSize), m_total(0.0), m_sums(handSize + 1) {
+    if (handSize > kMaxHandSize)
+      throw InvalidArgument("BlockerSums: hand size is too large");
+    for (size_t k = 1; k <= handSize; k++)
+      m_sums[k].assign(static_cast<size_t>(
+                           boost::math::binomial_coefficient<double>(
+                               static_cast<unsigned>(STANDARD_DECK_SIZE),
+                               static_cast<unsigned>(k))),
+                       0.0);
+  }
+
+  /// add the weight of a hand, weights must be positive
+  void add(uint64_t hand, double weight) {
+    if (weight <= 0.0)
+      return;
+    m_total += weight;
+    // visit every non-empty subset of the hand
+    for (uint64_t sub = hand; sub; sub = (sub - 1) & hand) {
+      size_t k = CardSet(sub).size();
+      size_t index = CardSet(sub).colex();
+      m_sums[k][index] += weight;
+      m_touched.emplace_back(k, index);
+    }
+  }
+
+  /// remove all hands
+  void clear() {
+    for (const std::pair<size_t, size_t>& t : m_touched)
+      m_sums[t.first][t.second] = 0.0;
+    m_touched.clear();
+    m_total = 0.0;
+  }
+
+  /// @returns the weight of all hands
+  double total() const { return m_total; }
+
+  /// @returns the weight of the hands sharing a card with cards
+  double blocked(uint64_t cards) const {
+    int list[STANDARD_DECK_SIZE];
+    size_t n = 0;
+    while (cards) {
+      list[n++] = lastbit(cards);
+      cards &= cards - 1;
+    }
+    return blocked(list, n, 0, 0, 0);
+  }
+
+  /// @returns the weight of the hands sharing no card with cards
+  double disjoint(uint64_t cards) const { return m_total - blocked(cards); }
+
+ private:
+  static const size_t kMaxHandSize = 5;
+
+  // sum of the signed subset weights for all subsets extending subset,
+  // using the cards from list[start] onwards.
+  double blocked(const int* list, size_t n, size_t start, uint64_t subset,
+                 size_t depth) const {
+    double sum = 0.0;
+    for (size_t i = start; i < n; i++) {
+      uint64_t next = subset | UINT64_C(1) << list[i];
+      double w = m_sums[depth + 1][CardSet(next).colex()];
+      // a subset which no hand contains has no hand containing a superset
+      if (w == 0.0)
+        continue;
+      sum += (depth % 2 == 0) ? w : -w;
+      if (depth + 1 < m_handSize)
+        sum += blocked(list, n, i + 1, next, depth + 1);
+    }
+    return sum;
+  }
+
+  size_t m_handSize;
+  double m_total;
+  std::vector<std::vector<double>> m_sums;  // [size][colex]
+  std::vector<std::pair<size_t, size_t>> m_touched;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_BLOCKER_SUMS_H_
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "board_major_enumerator.h"
+
+#include <algorithm>
+
+#include <nit/error.h>
+#include <nit/util/combinations.h>
+
+#include "blocker_sums.h"
+#include "dense_distribution.h"
+#include "simple_deck.h"
+
+namespace nit {
+
+namespace {
+
+/// A live hand of a range on one board.
+struct BoardHand {
+  int code;      ///< the evaluation of the hand on the board
+  double weight;
+  uint64_t mask;
+  size_t index;  ///< the entry of the hand in its distribution
+
+  bool operator<(const BoardHand& other) const { return code < other.code; }
+};
+
+/// The entries of a distribution which can be dealt with the board.
+std::vector<BoardHand> liveHands(const CardDistribution& source,
+                                 const CardSet& board, size_t handsize) {
+  DenseDistribution dist(source);
+  dist.removeCards(board);
+  std::vector<BoardHand> hands;
+  hands.reserve(dist.size());
+  for (size_t i = 0; i < dist.size(); i++) {
+    if (dist[i].size() != handsize)
+      throw InvalidArgument("board major enumeration needs complete hands")
+          << errinfo_value(dist[i].str());
+    hands.push_back(BoardHand{0, dist.weight(i), dist.mask(i), dist.source(i)});
+  }
+  return hands;
+}
+
+/// Evaluate and sort the hands of a range which are live on a board.
+void evaluateHands(const std::vector<BoardHand>& range, const CardSet& board,
+                   const PokerHandEvaluator& peval,
+                   std::vector<BoardHand>& hands) {
+  hands.clear();
+  for (const BoardHand& hand : range) {
+    if ((hand.mask & board.mask()) != 0)
+      continue;
+    hands.push_back(hand);
+    hands.back().code =
+        peval.evaluateHand(CardSet(hand.mask), board).high().code();
+  }
+  std::sort(hands.begin(), hands.end());
+}
+
+/**
+ * Add the shares of a hand against the tuples of the middle opponents,
+ * from opponent m onwards, which share no card with the dead cards or
+ * each other.  Only the first ends[m] hands of each middle opponent, the
+ * ones which do not beat the hand, are visited.  The hands of the last
+ * opponent are counted with the less and equal sums, and the pot is split
+ * among the hands which tie.
+ */
+void shareTuples(const std::vector<const std::vector<BoardHand>*>& middle,
+                 const std::vector<size_t>& ends, size_t m, int code,
+                 uint64_t dead, double weight, size_t ties,
+                 const BlockerSums& less, const BlockerSums& equal,
+                 EquityResult& shares) {
+  if (m == middle.size()) {
+    if (less.total() > 0.0) {
+      double below = weight * less.disjoint(dead);
+      if (ties == 0)
+        shares.winShares += below;
+      else
+        shares.tieShares += below / static_cast<double>(ties + 1);
+    }
+    if (equal.total() > 0.0)
+      shares.tieShares +=
+          weight * equal.disjoint(dead) / static_cast<double>(ties + 2);
+    return;
+  }
+  const std::vector<BoardHand>& hands = *middle[m];
+  for (size_t i = 0; i < ends[m]; i++) {
+    const BoardHand& hand = hands[i];
+    if ((hand.mask & dead) != 0)
+      continue;
+    shareTuples(middle, ends, m + 1, code, dead | hand.mask,
+                weight * hand.weight, ties + (hand.code == code ? 1 : 0),
+                less, equal, shares);
+  }
+}
+
+/**
+ * Award the shares of each hand of the hero against the other ranges.
+ * All lists must be sorted by evaluation.  The largest opponent range is
+ * the last one: the less sums hold its hands which evaluate lower than
+ * the current hand, and the equal sums hold the ones which evaluate the
+ * same, so each of its hands enters each of the sums at most once.  The
+ * hands of the other opponents are enumerated, up to the last one which
+ * does not beat the current hand.  Heads up there are no such opponents,
+ * and the sweep is linear.
+ */
+void sweep(size_t hero, const std::vector<std::vector<BoardHand>>& hands,
+           BlockerSums& less, BlockerSums& equal,
+           std::vector<EquityResult>& results, EquityResult& total) {
+  size_t last = hero == 0 ? 1 : 0;
+  for (size_t p = 0; p < hands.size(); p++)
+    if (p != hero && hands[p].size() > hands[last].size())
+      last = p;
+  std::vector<const std::vector<BoardHand>*> middle;
+  for (size_t p = 0; p < hands.size(); p++)
+    if (p != hero && p != last)
+      middle.push_back(&hands[p]);
+  std::vector<size_t> ends(middle.size(), 0);
+
+  const std::vector<BoardHand>& theirs = hands[last];
+  less.clear();
+  equal.clear();
+  size_t below = 0;  // first opponent hand not in the less sums
+  bool grouped = false;
+  int groupCode = 0;
+  for (const BoardHand& hand : hands[hero]) {
+    while (below < theirs.size() && theirs[below].code < hand.code) {
+      less.add(theirs[below].mask, theirs[below].weight);
+      below++;
+    }
+    if (!grouped || groupCode != hand.code) {
+      equal.clear();
+      for (size_t i = below; i < theirs.size() && theirs[i].code == hand.code;
+           i++)
+        equal.add(theirs[i].mask, theirs[i].weight);
+      for (size_t m = 0; m < middle.size(); m++)
+        while (ends[m] < middle[m]->size() &&
+               (*middle[m])[ends[m]].code <= hand.code)
+          ends[m]++;
+      grouped = true;
+      groupCode = hand.code;
+    }
+    EquityResult shares;
+    shareTuples(middle, ends, 0, hand.code, hand.mask, hand.weight, 0, less,
+                equal, shares);
+    results[hand.index] += shares;
+    total += shares;
+  }
+}
+
+/// Check that the game and board can be enumerated board major.
+void checkGame(const CardSet& board, const PokerHandEvaluator& peval) {
+  if (peval.evaluationSize() != 1 || peval.boardSize() == 0)
+    throw InvalidArgument(
+        "board major enumeration needs a high only game with a board");
+  if (board.size() > peval.boardSize())
+    throw InvalidArgument("too many board cards") << errinfo_value(board.str());
+}
+
+}  // namespace
+
+BoardMajorEnumerator::BoardMajorEnumerator() = default;
+
+RangeEquityResult BoardMajorEnumerator::calculateEquity(
+    const CardDistribution& hero, const CardDistribution& villain,
+    const CardSet& board, const PokerHandEvaluator& peval) const {
+  return calculateEquity(std::vector<CardDistribution>{hero, villain}, board,
+                         peval);
+}
+
+RangeEquityResult BoardMajorEnumerator::calculateEquity(
+    const std::vector<CardDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval) const {
+  if (dists.size() < 2)
+    throw InvalidArgument("board major enumeration needs two or more players")
+        << errinfo_value(std::to_string(dists.size()));
+  checkGame(board, peval);
+  const size_t handsize = peval.handSize();
+  const size_t nplayers = dists.size();
+  std::vector<std::vector<BoardHand>> ranges;
+  RangeEquityResult result;
+  result.players.resize(nplayers);
+  for (const CardDistribution& dist : dists) {
+    ranges.push_back(liveHands(dist, board, handsize));
+    result.hands.emplace_back(dist.size());
+  }
+
+  // the storage is allocated once, and reused for every board
+  std::vector<std::vector<BoardHand>> hands(nplayers);
+  BlockerSums less(handsize);
+  BlockerSums equal(handsize);
+
+  SimpleDeck deck;
+  deck.remove(board);
+  combinations boards(deck.size(), peval.boardSize() - board.size());
+  do {
+    CardSet full = board | deck.peek(boards.getMask());
+    for (size_t p = 0; p < nplayers; p++)
+      evaluateHands(ranges[p], full, peval, hands[p]);
+    for (size_t p = 0; p < nplayers; p++)
+      sweep(p, hands, less, equal, result.hands[p], result.players[p]);
+  } while (boards.next());
+
+  return result;
+}
+
+}  // namespace nit
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_BOARD_MAJOR_ENUMERATOR_H_
+#define NIT_ENUM_BOARD_MAJOR_ENUMERATOR_H_
+
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "card_distribution.h"
+
+namespace nit {
+
+/**
+ * Equity of a range against range calculation.  The players vector holds
+ * the total shares of each player, as ShowdownEnumerator::calculateEquity
+ * would return them.  The hands vector holds, for each player, the shares
+ * won by each entry of the player's distribution, with the same indices as
+ * the distribution.  The shares of an entry include its own weight.
+ */
+struct RangeEquityResult {
+  std::vector<EquityResult> players;
+  std::vector<std::vector<EquityResult>> hands;
+};
+
+/**
+ * An enumerator which walks the boards in the outer loop instead of the
+ * hands.  For every board, each live hand of each range is evaluated
+ * once, the hands are sorted by their evaluation, and the win and tie
+ * weight of every hand is found in a sweep over the largest opponent
+ * range.  Hands of that opponent which share a card with the hand are
+ * removed with per-card blocker sums, see BlockerSums.
+ *
+ * With three or more players, the hands of the other opponents which do
+ * not beat the hand are enumerated, keeping them apart from the hand and
+ * from each other, and each of their tuples is another set of blocking
+ * cards for the sums of the largest range.  Heads up the sweep is linear
+ * in the size of the ranges, and every further player multiplies it by
+ * at most the size of another range.  Only games with a board and a
+ * single high evaluation are supported, and every hand of the
+ * distributions must be complete.
+ */
+class BoardMajorEnumerator {
+ public:
+  BoardMajorEnumerator();
+
+  /**
+   * enumerate a heads up range against range scenario, all boards which
+   * complete the given board are visited.
+   */
+  RangeEquityResult calculateEquity(const CardDistribution& hero,
+                                    const CardDistribution& villain,
+                                    const CardSet& board,
+                                    const PokerHandEvaluator& peval) const;
+
+  /**
+   * enumerate a scenario given as a list of two or more ranges, as
+   * ShowdownEnumerator::calculateEquity takes them.  Throws
+   * InvalidArgument for fewer than two players.
+   */
+  RangeEquityResult calculateEquity(const std::vector<CardDistribution>& dists,
+                                    const CardSet& board,
+                                    const PokerHandEvaluator& peval) const;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_BOARD_MAJOR_ENUMERATOR_H_
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "board_ranking.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <nit/error.h>
+#include <nit/util/combinations.h>
+
+namespace nit {
+
+namespace {
+
+const size_t kMaxHandSize = 4;
+
+/// the cards of a holding, one per set
+size_t splitCards(const CardSet& hand, uint64_t* cards) {
+  size_t n = 0;
+  for (uint64_t rest = hand.mask(); rest != 0; rest &= rest - 1)
+    cards[n++] = rest & ~(rest - 1);
+  return n;
+}
+
+/// @returns the number of evaluations in [lo, hi) of a sorted vector
+uint64_t countBetween(const std::vector<int>& evals, int lo, int hi) {
+  return static_cast<uint64_t>(
+      std::lower_bound(evals.begin(), evals.end(), hi) -
+      std::lower_bound(evals.begin(), evals.end(), lo));
+}
+
+}  // namespace
+
+BoardRanking::BoardRanking(const CardSet& board,
+                           const PokerHandEvaluator& peval)
+    : m_board(board), m_handSize(peval.handSize()) {
+  if (peval.evaluationSize() != 1)
+    throw InvalidArgument("only high hands can be ranked");
+  if (m_handSize == 0 || m_handSize > kMaxHandSize)
+    throw InvalidArgument("holdings of up to four cards can be ranked")
+        << errinfo_value(std::to_string(m_handSize));
+  if (board.size() < 3 || board.size() > 5 ||
+      (board.mask() >> STANDARD_DECK_SIZE) != 0)
+    throw InvalidArgument("a board has three to five cards")
+        << errinfo_value(board.str());
+
+  m_evals.resize(choose(STANDARD_DECK_SIZE, m_handSize));
+  m_subsets.resize(m_handSize - 1);
+  for (size_t k = 1; k < m_handSize; k++)
+    m_subsets[k - 1].resize(choose(STANDARD_DECK_SIZE, k));
+
+  uint64_t cards[kMaxHandSize];
+  combinations holdings(STANDARD_DECK_SIZE, m_handSize);
+  do {
+    const CardSet holding(holdings.getMask());
+    if (holding.intersects(board))
+      continue;
+    const int eval = peval.evaluateHand(holding, board).high().code();
+    m_evals[holding.colex()] = eval;
+    m_all.push_back(eval);
+    splitCards(holding, cards);
+    for (uint32_t subset = 1; subset + 1 < (1u << m_handSize); subset++) {
+      uint64_t mask = 0;
+      size_t k = 0;
+      for (size_t c = 0; c < m_handSize; c++) {
+        if (subset >> c & 1) {
+          mask |= cards[c];
+          k++;
+        }
+      }
+      m_subsets[k - 1][CardSet(mask).colex()].push_back(eval);
+    }
+  } while (holdings.next());
+
+  std::sort(m_all.begin(), m_all.end());
+  m_ranks = m_all;
+  m_ranks.erase(std::unique(m_ranks.begin(), m_ranks.end()), m_ranks.end());
+  for (std::vector<std::vector<int>>& bySubset : m_subsets)
+    for (std::vector<int>& evals : bySubset)
+      std::sort(evals.begin(), evals.end());
+}
+
+int BoardRanking::evaluation(const CardSet& hand) const {
+  if (hand.size() != m_handSize || (hand.mask() >> STANDARD_DECK_SIZE) != 0 ||
+      hand.intersects(m_board))
+    throw InvalidArgument("not a holding off the board")
+        << errinfo_value(hand.str());
+  return m_evals[hand.colex()];
+}
+
+uint64_t BoardRanking::between(const CardSet& hand, int eval, int lo,
+                               int hi) const {
+  // the holdings with none of the hand's cards, by inclusion and
+  // exclusion over the sets of its cards.  The only holding with all of
+  // them is the hand itself.
+  uint64_t cards[kMaxHandSize];
+  splitCards(hand, cards);
+  int64_t count = static_cast<int64_t>(countBetween(m_all, lo, hi));
+  for (uint32_t subset = 1; subset + 1 < (1u << m_handSize); subset++) {
+    uint64_t mask = 0;
+    size_t k = 0;
+    for (size_t c = 0; c < m_handSize; c++) {
+      if (subset >> c & 1) {
+        mask |= cards[c];
+        k++;
+      }
+    }
+    const int64_t n = static_cast<int64_t>(
+        countBetween(m_subsets[k - 1][CardSet(mask).colex()], lo, hi));
+    count += k % 2 == 1 ? -n : n;
+  }
+  if (lo <= eval && eval < hi)
+    count += m_handSize % 2 == 1 ? -1 : 1;
+  return static_cast<uint64_t>(count);
+}
+
+HoldingCounts BoardRanking::counts(const CardSet& hand) const {
+  const int eval = evaluation(hand);
+  HoldingCounts result;
+  result.worse = between(hand, eval, std::numeric_limits<int>::min(), eval);
+  result.ties = between(hand, eval, eval, eval + 1);
+  result.better =
+      between(hand, eval, eval + 1, std::numeric_limits<int>::max());
+  return result;
+}
+
+double BoardRanking::percentile(const CardSet& hand) const {
+  const HoldingCounts c = counts(hand);
+  if (c.total() == 0)
+    return 0.0;
+  return (static_cast<double>(c.worse) + static_cast<double>(c.ties) / 2) /
+         static_cast<double>(c.total());
+}
+
+size_t BoardRanking::nutRank(const CardSet& hand) const {
+  const int eval = evaluation(hand);
+  return static_cast<size_t>(
+      m_ranks.end() - std::lower_bound(m_ranks.begin(), m_ranks.end(), eval));
+}
+
+uint64_t BoardRanking::nutsCombos(const CardSet& hand) const {
+  const int eval = evaluation(hand);
+  // down from the board's nuts, usually a step or two, until a hand the
+  // opponent can still hold
+  for (size_t r = m_ranks.size(); r-- > 0;) {
+    uint64_t n = between(hand, eval, m_ranks[r], m_ranks[r] + 1);
+    if (n > 0)
+      return n;
+  }
+  return 0;
+}
+
+}  // namespace nit
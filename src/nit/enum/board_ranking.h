@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_BOARD_RANKING_H_
+#define NIT_ENUM_BOARD_RANKING_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+namespace nit {
+
+/**
+ * How a hand compares to the holdings an opponent can have, those which
+ * share no card with the hand or the board.
+ */
+struct HoldingCounts {
+  uint64_t worse{0};
+  uint64_t ties{0};
+  uint64_t better{0};
+
+  uint64_t total() const { return worse + ties + better; }
+};
+
+/**
+ * Every holding of a hold'em or omaha board ranked by the hand it makes
+ * on the board as it is.  The evaluations of the holdings are sorted
+ * once, in total and for each set of fewer cards than a holding, among
+ * the holdings with those cards.  The holdings an opponent can have
+ * against a hand are then counted by inclusion and exclusion over the
+ * cards of the hand, a binary search per set of its cards: 2 for hold'em
+ * and 14 for omaha, so a query is O(log n).
+ *
+ * The evaluation of every holding is kept, so the ranking needs the
+ * evaluator only while it is built.  Only evaluators with one
+ * evaluation, the high hand, are ranked.
+ */
+class BoardRanking {
+ public:
+  /**
+   * rank the holdings of peval on a board of three to five cards, throws
+   * InvalidArgument if peval has a low hand or its holdings have more
+   * than four cards
+   */
+  BoardRanking(const CardSet& board, const PokerHandEvaluator& peval);
+
+  const CardSet& board() const { return m_board; }
+  size_t holdings() const { return m_all.size(); }
+
+  /**
+   * @returns how a hand compares to the holdings an opponent can have,
+   * throws InvalidArgument if it is not a holding off the board
+   */
+  HoldingCounts counts(const CardSet& hand) const;
+
+  /// @returns the share of the opponent holdings a hand beats, ties half
+  double percentile(const CardSet& hand) const;
+
+  /**
+   * @returns 1 for the best hand which can be made on the board, 2 for the
+   * next best and so on.  This is the board's ranking, the cards of the
+   * hand do not take any hands away, see counts for that.
+   */
+  size_t nutRank(const CardSet& hand) const;
+
+  /// @returns the number of distinct hands which can be made on the board
+  size_t ranks() const { return m_ranks.size(); }
+
+  /**
+   * @returns the opponent holdings against a hand which make the best
+   * hand still possible for them, the nuts with the hand's cards removed
+   */
+  uint64_t nutsCombos(const CardSet& hand) const;
+
+ private:
+  /// @returns the evaluation of a holding, and checks it
+  int evaluation(const CardSet& hand) const;
+
+  /**
+   * @returns the opponent holdings against a hand with evaluation eval
+   * whose evaluations are in [lo, hi)
+   */
+  uint64_t between(const CardSet& hand, int eval, int lo, int hi) const;
+
+  CardSet m_board;
+  size_t m_handSize;
+  std::vector<int> m_evals;  // [colex of a holding], off the board only
+  std::vector<int> m_all;    // the evaluations of every holding, sorted
+  std::vector<int> m_ranks;  // the distinct evaluations, sorted
+
+  // [k - 1][colex of k cards], the sorted evaluations of the holdings
+  // with those cards, for k less than the hand size
+  std::vector<std::vector<std::vector<int>>> m_subsets;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_BOARD_RANKING_H_
@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "card_abstraction.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+
+#include <nit/error.h>
+#include <nit/util/parallel_for.h>
+
+#include "hand_potential_enumerator.h"
+#include "hand_potential_table.h"
+#include "histogram_clustering.h"
+
+namespace nit {
+
+namespace {
+
+const char kMagic[8] = {'n', 'i', 't', '-', 'a', 'b', '0', '1'};
+
+struct Header {
+  char magic[8];
+  uint32_t boardSize;
+  uint32_t boards;
+  uint32_t holdings;
+  uint32_t buckets;
+  uint32_t quantiles;
+};
+
+const size_t kRiverValues = 65536;
+
+/// @returns the cards of every holding, by colex index
+const std::vector<uint64_t>& holdingMasks() {
+  static const std::vector<uint64_t> masks = [] {
+    std::vector<uint64_t> holdings;
+    for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++)
+      for (size_t lo = 0; lo < hi; lo++)
+        holdings.push_back(UINT64_C(1) << hi | UINT64_C(1) << lo);
+    return holdings;
+  }();
+  return masks;
+}
+
+uint16_t quantize(double x) {
+  return static_cast<uint16_t>(
+      std::lround(std::min(1.0, std::max(0.0, x)) * 65535.0));
+}
+
+/// @returns the suit permutations which leave a board as it is
+std::vector<std::vector<int>> stabilizer(const CardSet& board) {
+  std::vector<std::vector<int>> perms;
+  std::vector<int> perm = {0, 1, 2, 3};
+  do {
+    if (board.rotateSuits(perm[0], perm[1], perm[2], perm[3]) == board)
+      perms.push_back(perm);
+  } while (std::next_permutation(perm.begin(), perm.end()));
+  return perms;
+}
+
+/**
+ * The distinct holdings of a board up to the suit permutations which
+ * leave the board as it is.
+ */
+struct BoardClasses {
+  std::vector<uint16_t> classes;  // the class of each live holding by colex
+  std::vector<size_t> first;      // a holding of each class
+  std::vector<float> counts;      // the holdings in each class
+
+  explicit BoardClasses(const CardSet& board)
+      : classes(CardAbstraction::kHoldings) {
+    const std::vector<std::vector<int>> perms = stabilizer(board);
+    std::vector<int> byKey(CardAbstraction::kHoldings, -1);
+    for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++) {
+      for (size_t lo = 0; lo < hi; lo++) {
+        CardSet holding(UINT64_C(1) << hi | UINT64_C(1) << lo);
+        if (holding.intersects(board))
+          continue;
+        size_t key = holding.colex();
+        for (const std::vector<int>& p : perms)
+          key = std::min(key, holding.rotateSuits(p[0], p[1], p[2], p[3])
+                                  .colex());
+        if (byKey[key] < 0) {
+          byKey[key] = static_cast<int>(first.size());
+          first.push_back(holding.colex());
+          counts.push_back(0.0f);
+        }
+        classes[holding.colex()] = static_cast<uint16_t>(byKey[key]);
+        counts[byKey[key]] += 1.0f;
+      }
+    }
+    // every holding stands for the boards of the class
+    const float boards = 24.0f / perms.size();
+    for (float& count : counts)
+      count *= boards;
+  }
+};
+
+}  // namespace
+
+const size_t CardAbstraction::kHoldings;
+
+CardAbstraction::CardAbstraction(const std::string& path)
+    : m_table(path, kMagic, "a card abstraction"),
+      m_entries(nullptr),
+      m_boardSize(0),
+      m_buckets(0) {
+  const Header header = m_table.header<Header>();
+  if (header.boardSize < 3 || header.boardSize > 5 ||
+      header.boards != HandPotentialTable::boards(header.boardSize).size() ||
+      header.holdings != kHoldings)
+    m_table.reject();
+  m_entries = m_table.entries<Header, uint16_t>(
+      static_cast<size_t>(header.boards) * kHoldings);
+  m_boardSize = header.boardSize;
+  m_buckets = header.buckets;
+}
+
+size_t CardAbstraction::bucket(const CardSet& board,
+                               const CardSet& holding) const {
+  if (board.size() != m_boardSize)
+    throw InvalidArgument("the board is not of the abstraction's street")
+        << errinfo_value(board.str());
+  if (holding.size() != 2 || (holding.mask() >> STANDARD_DECK_SIZE) != 0 ||
+      holding.intersects(board))
+    throw InvalidArgument("a holding has two cards off the board")
+        << errinfo_value(holding.str());
+  return m_entries[HandPotentialTable::boardIndex(board) * kHoldings +
+                   canonizeToBoard(board, holding).colex()];
+}
+
+std::vector<uint16_t> CardAbstraction::features(const CardSet& board,
+                                                size_t quantiles,
+                                                size_t threads) {
+  if (quantiles == 0)
+    throw InvalidArgument("a histogram needs at least one quantile");
+  HandPotentialEnumerator enumerator(threads);
+  if (board.size() == 5) {
+    std::vector<uint16_t> result(kHoldings);
+    std::vector<HandPotential> potentials = enumerator.calculate(board);
+    for (size_t i = 0; i < kHoldings; i++)
+      result[i] = quantize(potentials[i].strength);
+    return result;
+  }
+
+  std::vector<uint16_t> result(kHoldings * quantiles);
+  std::vector<std::vector<double>> strengths = enumerator.nextStrengths(board);
+  for (size_t i = 0; i < kHoldings; i++) {
+    const std::vector<double>& values = strengths[i];
+    if (values.empty())
+      continue;
+    for (size_t q = 0; q < quantiles; q++) {
+      size_t index =
+          static_cast<size_t>((q + 0.5) / quantiles * values.size());
+      result[i * quantiles + q] =
+          quantize(values[std::min(index, values.size() - 1)]);
+    }
+  }
+  return result;
+}
+
+double CardAbstraction::build(const std::string& path, size_t boardSize,
+                              const AbstractionOptions& options) {
+  const std::vector<uint64_t>& boards = HandPotentialTable::boards(boardSize);
+  const bool river = boardSize == 5;
+  const size_t dim = river ? 1 : options.quantiles;
+  const size_t nthreads = std::max<size_t>(1, options.threads);
+  HistogramClustering clustering(dim, options.buckets, nthreads);
+
+  // the classes of holdings of every board, and where their points start
+  std::vector<size_t> offsets(boards.size() + 1, 0);
+  if (!river)
+    for (size_t b = 0; b < boards.size(); b++)
+      offsets[b + 1] =
+          offsets[b] + BoardClasses(CardSet(boards[b])).first.size();
+
+  // on the river the points are the strengths, and the entries hold the
+  // strength of each holding until the buckets are known; before the
+  // river they hold the class of each holding on its board
+  std::vector<uint16_t> entries(boards.size() * kHoldings);
+  std::vector<uint16_t> points(river ? kRiverValues : offsets.back() * dim);
+  std::vector<float> weights(river ? kRiverValues : offsets.back());
+  if (river)
+    for (size_t v = 0; v < kRiverValues; v++)
+      points[v] = static_cast<uint16_t>(v);
+
+  // the river weights are summed per thread, and merged after
+  std::vector<std::vector<float>> riverWeights(
+      nthreads, std::vector<float>(river ? kRiverValues : 0));
+  parallelFor(boards.size(), nthreads, [&](size_t thread, size_t b) {
+    const CardSet board(boards[b]);
+    const BoardClasses classes(board);
+    const std::vector<uint16_t> features =
+        CardAbstraction::features(board, dim);
+    uint16_t* slots = &entries[b * kHoldings];
+    for (size_t c = 0; c < classes.first.size(); c++) {
+      const uint16_t* point = &features[classes.first[c] * dim];
+      if (river) {
+        riverWeights[thread][*point] += classes.counts[c];
+      } else {
+        std::copy(point, point + dim, &points[(offsets[b] + c) * dim]);
+        weights[offsets[b] + c] = classes.counts[c];
+      }
+    }
+    for (size_t h = 0; h < kHoldings; h++)
+      slots[h] = river ? features[h] : classes.classes[h];
+  });
+  if (river)
+    for (const std::vector<float>& part : riverWeights)
+      for (size_t v = 0; v < kRiverValues; v++)
+        weights[v] += part[v];
+
+  // only the strengths which some holding has are clustered
+  std::vector<size_t> byValue;
+  if (river) {
+    byValue.assign(kRiverValues, 0);
+    size_t n = 0;
+    for (size_t v = 0; v < kRiverValues; v++) {
+      if (weights[v] <= 0.0f)
+        continue;
+      byValue[v] = n;
+      points[n] = points[v];
+      weights[n++] = weights[v];
+    }
+    points.resize(n);
+    weights.resize(n);
+  }
+
+  std::vector<uint16_t> buckets =
+      clustering.cluster(points, weights, options.iterations, options.seed);
+  const std::vector<uint64_t>& holdings = holdingMasks();
+  for (size_t b = 0; b < boards.size(); b++) {
+    for (size_t h = 0; h < kHoldings; h++) {
+      uint16_t& slot = entries[b * kHoldings + h];
+      if (holdings[h] & boards[b])
+        slot = 0;
+      else
+        slot = buckets[river ? byValue[slot] : offsets[b] + slot];
+    }
+  }
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.boardSize = static_cast<uint32_t>(boardSize);
+  header.boards = static_cast<uint32_t>(boards.size());
+  header.holdings = static_cast<uint32_t>(kHoldings);
+  header.buckets = static_cast<uint32_t>(clustering.centers().size() / dim);
+  header.quantiles = static_cast<uint32_t>(dim);
+  writeTable(path, header, entries, "a card abstraction");
+  return clustering.cost();
+}
+
+}  // namespace nit
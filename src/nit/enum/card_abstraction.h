@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_CARD_ABSTRACTION_H_
+#define NIT_ENUM_CARD_ABSTRACTION_H_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <nit/eval/card_set.h>
+
+#include "mapped_table.h"
+
+namespace nit {
+
+/**
+ * The parameters of a card abstraction build.
+ */
+struct AbstractionOptions {
+  size_t buckets{200};
+  size_t quantiles{16};  ///< of the histogram of a hand on the flop and turn
+  size_t iterations{20};
+  size_t threads{1};
+  uint64_t seed{0};
+};
+
+/**
+ * A hold'em card abstraction of one street: the bucket of every holding
+ * on every suit isomorphic board, read from a table built by nit-buckets.
+ *
+ * On the flop and the turn a hand is described by its equity histogram,
+ * the expected strength it has after each card which can come next, see
+ * HandPotentialEnumerator::nextStrengths, and the hands are clustered by
+ * the earth mover's distance between their histograms, see
+ * HistogramClustering.  On the river a hand is its strength.  The
+ * holdings which are suit isomorphic on a board are clustered once,
+ * weighted by how often they are dealt.  The buckets are numbered from
+ * the weakest to the strongest hands.
+ *
+ * The file is a header, "nit-ab01", the board size, the number of boards,
+ * the holdings per board, the number of buckets and the quantiles per
+ * histogram as 32 bits, followed by a 16 bit bucket per holding by colex
+ * index, board by board in the order of HandPotentialTable::boards, in
+ * the byte order of the machine.
+ */
+class CardAbstraction {
+ public:
+  static const size_t kHoldings = 1326;
+
+  /// map the table at path, throws InvalidArgument if it is not one
+  explicit CardAbstraction(const std::string& path);
+
+  size_t boardSize() const { return m_boardSize; }
+  size_t buckets() const { return m_buckets; }
+
+  /**
+   * @returns the bucket of a holding on a board of the table's size,
+   * throws InvalidArgument if they are not distinct cards
+   */
+  size_t bucket(const CardSet& board, const CardSet& holding) const;
+
+  /**
+   * @returns the description of every holding on a board, by colex index,
+   * quantiles 16 bit fractions each on the flop and turn, and one on the
+   * river.  The holdings which share a card with the board are all 0.
+   */
+  static std::vector<uint16_t> features(const CardSet& board,
+                                        size_t quantiles, size_t threads = 1);
+
+  /**
+   * build the abstraction of the street with boardSize cards and write
+   * it to path.
+   * @returns the mean distance of the hands to their bucket
+   */
+  static double build(const std::string& path, size_t boardSize,
+                      const AbstractionOptions& options);
+
+ private:
+  MappedTable m_table;
+  const uint16_t* m_entries;
+  size_t m_boardSize;
+  size_t m_buckets;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_CARD_ABSTRACTION_H_
@@ -47,6 +47,11 @@ void CardDistribution::clear() {
 
 CardDistribution CardDistribution::data() const { return *this; }
 
+void CardDistribution::insert(const CardSet& hand, double weight) {
+  m_handList.push_back(hand);
+  m_weights[hand] = weight;
+}
+
 void CardDistribution::fill(int n) {
   CardSet cards;
   cards.fill();
@@ -34,6 +34,11 @@ class CardDistribution {
 
   void removeCards(const CardSet& dead);
 
+  /**
+   * add a hand to the end of the distribution
+   */
+  void insert(const CardSet& hand, double weight = 1.0);
+
   /**
    * return the total weight in the distribution
    */
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "checkpoint.h"
+
+#include <cstdio>
+
+#include <fstream>
+#include <sstream>
+
+namespace nit {
+
+namespace {
+
+const char* const kMagic = "nit-checkpoint 1";
+
+}  // namespace
+
+void Checkpoint::write(std::ostream& out) const {
+  std::ostringstream hex;
+  hex << std::hex << query;
+  out << kMagic << "\n";
+  out << "query " << hex.str() << "\n";
+  out << "position " << position << "\n";
+  for (const ExactEquityResult& result : results)
+    out << "result " << result.str() << "\n";
+}
+
+Checkpoint Checkpoint::read(std::istream& in) {
+  Checkpoint checkpoint;
+  std::string line;
+  if (!std::getline(in, line) || line != kMagic)
+    throw ParseError("not a checkpoint") << errinfo_value(line);
+
+  bool hasQuery = false;
+  bool hasPosition = false;
+  while (std::getline(in, line)) {
+    if (line.empty())
+      continue;
+    std::istringstream fields(line);
+    std::string key;
+    fields >> key;
+    if (key == "query") {
+      hasQuery = static_cast<bool>(fields >> std::hex >> checkpoint.query);
+    } else if (key == "position") {
+      hasPosition = static_cast<bool>(fields >> checkpoint.position);
+    } else if (key == "result") {
+      ExactEquityResult result;
+      std::string win, tie;
+      if (!(fields >> win >> tie >> result.scale) ||
+          !UInt128::parse(win, result.winShares) ||
+          !UInt128::parse(tie, result.tieShares))
+        throw ParseError("bad result in checkpoint") << errinfo_value(line);
+      checkpoint.results.push_back(result);
+    } else {
+      throw ParseError("unknown line in checkpoint") << errinfo_value(line);
+    }
+  }
+  if (!hasQuery || !hasPosition)
+    throw ParseError("incomplete checkpoint");
+  return checkpoint;
+}
+
+void Checkpoint::save(const std::string& path) const {
+  std::string temp = path + ".tmp";
+  {
+    std::ofstream out(temp, std::ios::trunc);
+    write(out);
+    out.flush();
+    if (!out)
+      throw InvalidArgument("could not write checkpoint") << errinfo_value(temp);
+  }
+  if (std::rename(temp.c_str(), path.c_str()) != 0)
+    throw InvalidArgument("could not replace checkpoint")
+        << errinfo_value(path);
+}
+
+bool Checkpoint::load(const std::string& path, Checkpoint& checkpoint) {
+  std::ifstream in(path);
+  if (!in)
+    return false;
+  checkpoint = read(in);
+  return true;
+}
+
+}  // namespace nit
@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_CHECKPOINT_H_
+#define NIT_ENUM_CHECKPOINT_H_
+
+#include <cstdint>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+namespace nit {
+
+/**
+ * The saved state of an exact enumeration.  The deals of an enumeration
+ * are numbered in the order they are visited, see Shard, so the number of
+ * the next deal is all that is needed to put the distribution walker and
+ * the partition enumerator back where they were.  Along with it we keep
+ * the exact shares counted so far, and a fingerprint of the query, so
+ * that a checkpoint is never resumed by a different enumeration.
+ *
+ * The text format is one "key value" pair per line:
+ *
+ *   nit-checkpoint 1
+ *   query <fingerprint in hex>
+ *   position <next deal>
+ *   result <win> <tie> <scale>
+ */
+struct Checkpoint {
+  uint64_t query{0};     ///< fingerprint of the enumeration
+  uint64_t position{0};  ///< the number of the next deal to enumerate
+  std::vector<ExactEquityResult> results;
+
+  void write(std::ostream& out) const;
+
+  /// read a checkpoint, throws ParseError on malformed input
+  static Checkpoint read(std::istream& in);
+
+  /**
+   * write the checkpoint to path.  It is written to a temporary file
+   * first, which is then renamed over path, so an interrupted save never
+   * leaves a truncated checkpoint behind.
+   */
+  void save(const std::string& path) const;
+
+  /// @returns false if there is no checkpoint at path
+  static bool load(const std::string& path, Checkpoint& checkpoint);
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_CHECKPOINT_H_
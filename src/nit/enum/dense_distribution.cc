@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "dense_distribution.h"
+
+#include <nit/util/combinations.h>
+
+namespace nit {
+
+DenseDistribution::DenseDistribution() { push(0, 1.0, 0); }
+
+DenseDistribution::DenseDistribution(const CardDistribution& dist) {
+  m_masks.reserve(dist.size());
+  m_weights.reserve(dist.size());
+  m_sources.reserve(dist.size());
+  for (size_t i = 0; i < dist.size(); i++) {
+    const CardSet& hand = dist[i];
+    double weight = dist[hand];
+    if (weight != 0.0)
+      push(hand.mask(), weight, i);
+  }
+}
+
+CardDistribution DenseDistribution::toCardDistribution() const {
+  CardDistribution dist;
+  dist.clear();
+  for (size_t i = 0; i < size(); i++)
+    dist.insert(CardSet(m_masks[i]), m_weights[i]);
+  return dist;
+}
+
+void DenseDistribution::fill(size_t n) {
+  m_masks.clear();
+  m_weights.clear();
+  m_sources.clear();
+  combinations hands(STANDARD_DECK_SIZE, n);
+  size_t source = 0;
+  do {
+    push(hands.getMask(), 1.0, source++);
+  } while (hands.next());
+}
+
+void DenseDistribution::removeCards(const CardSet& dead) {
+  const uint64_t deadmask = dead.mask();
+  const size_t n = size();
+  std::vector<uint8_t> live(n);
+  const uint64_t* masks = m_masks.data();
+  for (size_t i = 0; i < n; i++)
+    live[i] = (masks[i] & deadmask) == 0;
+
+  size_t kept = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (live[i]) {
+      m_masks[kept] = m_masks[i];
+      m_weights[kept] = m_weights[i];
+      m_sources[kept] = m_sources[i];
+      kept++;
+    }
+  }
+  m_masks.resize(kept);
+  m_weights.resize(kept);
+  m_sources.resize(kept);
+}
+
+double DenseDistribution::weight(const CardSet& hand) const {
+  for (size_t i = 0; i < size(); i++)
+    if (m_masks[i] == hand.mask())
+      return m_weights[i];
+  return 0.0;
+}
+
+double DenseDistribution::weight() const {
+  double total = 0.0;
+  for (double w : m_weights)
+    total += w;
+  return total;
+}
+
+void DenseDistribution::push(uint64_t mask, double weight, size_t source) {
+  m_masks.push_back(mask);
+  m_weights.push_back(weight);
+  m_sources.push_back(source);
+}
+
+}  // namespace nit
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_DENSE_DISTRIBUTION_H_
+#define NIT_ENUM_DENSE_DISTRIBUTION_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include <nit/eval/card_set.h>
+
+#include "card_distribution.h"
+
+namespace nit {
+
+/**
+ * A flat representation of a card distribution for the enumerators.
+ *
+ * The live entries, those with a non-zero weight, are kept as a structure
+ * of arrays: the card masks, the weights, and the index of the entry in
+ * the CardDistribution it was made from.  Entries are found by position,
+ * so the enumerators never look a weight up by hand.
+ */
+class DenseDistribution {
+ public:
+  DenseDistribution();  //!< the random distribution, one empty hand
+  explicit DenseDistribution(const CardDistribution& dist);
+
+  /// @returns a CardDistribution with the live entries of this one
+  CardDistribution toCardDistribution() const;
+
+  /// fill with all n card combinations of the deck, all weighted one
+  void fill(size_t n);
+
+  /**
+   * drop the entries which share a card with dead.  The scan over the
+   * masks has no branches, so the compiler can vectorize it.
+   */
+  void removeCards(const CardSet& dead);
+
+  /// @returns the number of live entries
+  size_t size() const { return m_masks.size(); }
+
+  /// @returns the cards of entry i
+  CardSet operator[](size_t i) const { return CardSet(m_masks[i]); }
+
+  uint64_t mask(size_t i) const { return m_masks[i]; }
+  double weight(size_t i) const { return m_weights[i]; }
+
+  /// @returns the index of entry i in the source CardDistribution
+  size_t source(size_t i) const { return m_sources[i]; }
+
+  /**
+   * @returns the weight of a hand, zero for hands not in the
+   * distribution.  This scans the entries, it is not for inner loops.
+   */
+  double weight(const CardSet& hand) const;
+
+  /// @returns the total weight in the distribution
+  double weight() const;
+
+  const std::vector<uint64_t>& masks() const { return m_masks; }
+  const std::vector<double>& weights() const { return m_weights; }
+
+ private:
+  void push(uint64_t mask, double weight, size_t source);
+
+  std::vector<uint64_t> m_masks;
+  std::vector<double> m_weights;
+  std::vector<size_t> m_sources;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_DENSE_DISTRIBUTION_H_
@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_DISTRIBUTION_WALKER_H_
+#define NIT_ENUM_DISTRIBUTION_WALKER_H_
+
+#include <cstdint>
+
+#include <limits>
+#include <vector>
+
+#include <nit/eval/card_set.h>
+#include <nit/util/lastbit.h>
+
+#include "dense_distribution.h"
+
+namespace nit {
+
+/**
+ * A depth first walker over the hands of a list of card distributions.
+ * It generates the same tuples of distribution indices as an Odometer
+ * over the distribution sizes, in the same order, but it only stops on
+ * tuples where no two hands share a card, and no hand shares a card with
+ * the initial dead cards.
+ *
+ * The dead card mask and the tuple weight are carried level by level, so
+ * a conflict at level i prunes the whole subtree below it.  For each
+ * distribution we precompute, for every card, the bitmap of entries which
+ * contain that card.  Entering a level then removes all conflicting
+ * entries in bulk, one bitmap per dead card, instead of testing every
+ * entry.  Entries with a zero weight are dropped up front.  The indices
+ * are positions in the DenseDistributions, see DenseDistribution::source.
+ *
+ * usage example:
+ *
+ *   DistributionWalker walker(dists, board);
+ *   while (walker.next()) {
+ *     // walker[i] is the index of the hand in dists[i]
+ *   }
+ *
+ * Unlike the Odometer, next() must be called before the first tuple is
+ * read, as there may be no valid tuple at all.
+ */
+class DistributionWalker {
+ public:
+  DistributionWalker(const std::vector<DenseDistribution>& dists,
+                     const CardSet& dead = CardSet())
+      : m_levels(dists.size()),
+        m_started(false),
+        m_masks(dists.size()),
+        m_weights(dists.size()),
+        m_words(dists.size()),
+        m_base(dists.size()),
+        m_cardIndex(dists.size()),
+        m_live(dists.size()),
+        m_cursor(dists.size(), none()),
+        m_dead(dists.size() + 1, dead.mask()),
+        m_weight(dists.size() + 1, 1.0) {
+    for (size_t i = 0; i < m_levels; i++) {
+      const DenseDistribution& dist = dists[i];
+      size_t n = dist.size();
+      size_t words = (n + 63) / 64;
+      m_words[i] = words;
+      m_masks[i].resize(n);
+      m_weights[i].resize(n);
+      m_base[i].assign(words, 0);
+      m_cardIndex[i].assign(STANDARD_DECK_SIZE * words, 0);
+      m_live[i].assign(words, 0);
+
+      for (size_t j = 0; j < n; j++) {
+        uint64_t mask = dist.mask(j);
+        m_masks[i][j] = mask;
+        m_weights[i][j] = dist.weight(j);
+        uint64_t bit = UINT64_C(1) << (j % 64);
+        if (m_weights[i][j] != 0.0 && (mask & dead.mask()) == 0)
+          m_base[i][j / 64] |= bit;
+        while (mask) {
+          m_cardIndex[i][lastbit(mask) * words + j / 64] |= bit;
+          mask &= mask - 1;
+        }
+      }
+    }
+  }
+
+  /// @returns the number of distributions walked
+  size_t size() const { return m_levels; }
+
+  /**
+   * advance to the next conflict free tuple
+   *
+   * @returns false when the walk is over
+   */
+  bool next() {
+    if (m_levels == 0)
+      return false;
+    size_t level = m_levels - 1;
+    if (!m_started) {
+      m_started = true;
+      level = 0;
+      enter(0);
+    }
+    while (true) {
+      if (advance(level)) {
+        if (level + 1 == m_levels)
+          return true;
+        enter(++level);
+      } else {
+        if (level == 0)
+          return false;
+        --level;
+      }
+    }
+  }
+
+  /// @returns the index of the current hand of the ith distribution
+  size_t operator[](size_t i) const { return m_cursor[i]; }
+
+  /// @returns the current hand of the ith distribution
+  CardSet hand(size_t i) const { return CardSet(m_masks[i][m_cursor[i]]); }
+
+  /// @returns the initial dead cards plus all cards of the current tuple
+  CardSet dead() const { return CardSet(m_dead[m_levels]); }
+
+  /// @returns the product of the weights of the current tuple
+  double weight() const { return m_weight[m_levels]; }
+
+  /**
+   * @returns an estimate of the fraction of the walk before the current
+   * tuple, reading the indices as the digits of an odometer over the
+   * distribution sizes.  Each tuple takes up tupleFraction() of the walk.
+   */
+  double fraction() const {
+    double sum = 0.0;
+    double scale = 1.0;
+    for (size_t i = 0; i < m_levels; i++) {
+      scale /= static_cast<double>(m_masks[i].size());
+      sum += static_cast<double>(m_cursor[i]) * scale;
+    }
+    return sum;
+  }
+
+  double tupleFraction() const {
+    double scale = 1.0;
+    for (size_t i = 0; i < m_levels; i++)
+      scale /= static_cast<double>(m_masks[i].size());
+    return scale;
+  }
+
+ private:
+  static size_t none() { return std::numeric_limits<size_t>::max(); }
+
+  // compute the live entries of a level from the dead cards above it
+  void enter(size_t level) {
+    const size_t words = m_words[level];
+    std::vector<uint64_t>& live = m_live[level];
+    live = m_base[level];
+    // the initial dead cards are already folded into the base bitmap
+    uint64_t added = m_dead[level] & ~m_dead[0];
+    while (added) {
+      const uint64_t* conflicts = &m_cardIndex[level][lastbit(added) * words];
+      for (size_t w = 0; w < words; w++)
+        live[w] &= ~conflicts[w];
+      added &= added - 1;
+    }
+    m_cursor[level] = none();
+  }
+
+  // move the cursor of a level to its next live entry
+  bool advance(size_t level) {
+    const std::vector<uint64_t>& live = m_live[level];
+    size_t start = m_cursor[level] == none() ? 0 : m_cursor[level] + 1;
+    for (size_t w = start / 64; w < live.size(); w++) {
+      uint64_t bits = live[w];
+      if (w == start / 64)
+        bits &= ~UINT64_C(0) << (start % 64);
+      if (bits) {
+        size_t j = w * 64 + lastbit(bits);
+        m_cursor[level] = j;
+        m_dead[level + 1] = m_dead[level] | m_masks[level][j];
+        m_weight[level + 1] = m_weight[level] * m_weights[level][j];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t m_levels;
+  bool m_started;
+  std::vector<std::vector<uint64_t>> m_masks;    // hand masks per entry
+  std::vector<std::vector<double>> m_weights;    // weight per entry
+  std::vector<size_t> m_words;                   // bitmap words per level
+  std::vector<std::vector<uint64_t>> m_base;     // live against initial dead
+  std::vector<std::vector<uint64_t>> m_cardIndex;  // [card * words + word]
+  std::vector<std::vector<uint64_t>> m_live;     // live entries per level
+  std::vector<size_t> m_cursor;                  // current entry per level
+  std::vector<uint64_t> m_dead;                  // dead cards above a level
+  std::vector<double> m_weight;                  // weight above a level
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_DISTRIBUTION_WALKER_H_
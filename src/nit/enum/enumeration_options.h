@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_ENUMERATION_OPTIONS_H_
+#define NIT_ENUM_ENUMERATION_OPTIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include <nit/error.h>
+
+namespace nit {
+
+struct EquityDistribution;
+
+/**
+ * One of count equal slices of an enumeration.  The deals of an
+ * enumeration are numbered in the order they are visited, and shard i of
+ * N gets the contiguous range [T*i/N, T*(i+1)/N) of the T deals.  The
+ * split only depends on the query, so shards can be run by separate
+ * processes, and the exact results of all shards add up to the exact
+ * result of the whole enumeration.
+ */
+struct Shard {
+  size_t index{0};
+  size_t count{1};
+
+  Shard() = default;
+  Shard(size_t i, size_t n) : index(i), count(n) {}
+
+  /// parse a shard given as "i/N"
+  static Shard parse(const std::string& spec) {
+    size_t slash = spec.find('/');
+    Shard shard;
+    if (slash == std::string::npos ||
+        !number(spec.substr(0, slash), shard.index) ||
+        !number(spec.substr(slash + 1), shard.count))
+      throw InvalidArgument("shards are given as index/count")
+          << errinfo_value(spec);
+    if (shard.count == 0 || shard.index >= shard.count)
+      throw InvalidArgument("the shard index must be less than the count")
+          << errinfo_value(spec);
+    return shard;
+  }
+
+  std::string str() const {
+    return std::to_string(index) + "/" + std::to_string(count);
+  }
+
+ private:
+  static bool number(const std::string& digits, size_t& value) {
+    if (digits.empty() || digits.size() > 9)
+      return false;
+    value = 0;
+    for (char c : digits) {
+      if (c < '0' || c > '9')
+        return false;
+      value = value * 10 + static_cast<size_t>(c - '0');
+    }
+    return true;
+  }
+};
+
+/**
+ * How far an enumeration got.  An enumeration which was cancelled or ran
+ * out of time returns the shares of the deals it visited, and reports
+ * itself incomplete here.
+ */
+struct EnumerationStatus {
+  bool complete{true};
+  uint64_t position{0};  ///< the number of the next deal to enumerate
+  double fraction{0.0};  ///< an estimate of the fraction of deals done
+};
+
+/**
+ * Options which control how an enumeration is run, rather than what is
+ * being enumerated.  The defaults run the whole enumeration.
+ *
+ * The progress callback, the cancellation flag and the deadline are only
+ * looked at once per block of a few thousand deals, so they cost nothing
+ * in the inner loop, and the enumeration stops within a block of being
+ * asked to.
+ */
+struct EnumerationOptions {
+  Shard shard;  ///< the slice of the deals to enumerate
+
+  /**
+   * where to save the progress of an exact enumeration, see Checkpoint.
+   * If the file holds a checkpoint of the same enumeration, the
+   * enumeration resumes from it.  The file is removed once the
+   * enumeration is done.  No checkpoints are written if empty.
+   */
+  std::string checkpointFile;
+  double checkpointInterval{60.0};  ///< seconds between checkpoints
+
+  /// called once per block with an estimate of the fraction done
+  std::function<void(double)> progress;
+
+  /// the enumeration stops once this is set, it may be set from any thread
+  const std::atomic<bool>* cancel{nullptr};
+
+  /// the enumeration stops once the deadline has passed
+  std::chrono::steady_clock::time_point deadline{
+      std::chrono::steady_clock::time_point::max()};
+
+  /// if set, receives how far the enumeration got
+  EnumerationStatus* status{nullptr};
+
+  /**
+   * credit the tuples of hands whose showdown no runout can change in
+   * bulk, rather than evaluating every runout.  The results are the same
+   * either way.
+   */
+  bool pruneDecided{true};
+
+  /**
+   * the number of evaluations to keep in a cache for the query, see
+   * CachingHandEvaluator, none if 0.  It pays off with the dearer
+   * evaluators, omaha and the universal ones, when each hand meets many
+   * tuples of the other hands.  The results are the same either way.
+   */
+  size_t evaluationCache{0};
+
+  /**
+   * if set, calculateEquity also takes the distribution of each player's
+   * equity once some of the board is out, see EquityDistribution, and
+   * fills the equity and equity2 of the results with its mean and second
+   * moment.  The distribution needs the whole enumeration, not a shard.
+   * The other enumerations, visit among them, throw InvalidArgument if
+   * it is set, rather than leave it empty.
+   */
+  EquityDistribution* distribution{nullptr};
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_ENUMERATION_OPTIONS_H_
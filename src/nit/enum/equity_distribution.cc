@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "equity_distribution.h"
+
+#include <nit/error.h>
+#include <nit/util/lastbit.h>
+
+namespace nit {
+
+const size_t EquityDistributionVisitor::kNoGroup;
+
+EquityDistributionVisitor::EquityDistributionVisitor(
+    size_t players, const CardSet& board, const PokerHandEvaluator& peval,
+    size_t cards, size_t bins)
+    : m_players(players),
+      m_board(board),
+      m_runout(peval.boardSize() > board.size()
+                   ? peval.boardSize() - board.size()
+                   : 0),
+      m_results(players),
+      m_histograms(players),
+      m_shares(players),
+      m_weight(0.0),
+      m_used(0),
+      m_byCard(STANDARD_DECK_SIZE, kNoGroup) {
+  if (bins == 0)
+    throw InvalidArgument("an equity distribution needs at least one bin");
+  for (EquityHistogram& histogram : m_histograms)
+    histogram.bins.assign(bins, 0.0);
+  const size_t k = cards < m_runout ? cards : m_runout;
+  for (uint32_t subset = 0; subset < (1u << m_runout); subset++) {
+    size_t bits = 0;
+    for (uint32_t rest = subset; rest != 0; rest &= rest - 1)
+      bits++;
+    if (bits == k)
+      m_subsets.push_back(subset);
+  }
+}
+
+void EquityDistributionVisitor::visit(const ShowdownBlock& block) {
+  for (size_t d = 0; d < block.size(); d++) {
+    for (size_t i = 0; i < m_players; i++) {
+      if (m_hands.empty() || block.hand(d, i) != m_hands[i]) {
+        flush();
+        m_hands.assign(&block.hand(d, 0), &block.hand(d, 0) + m_players);
+        m_weight = block.weight(d);
+        break;
+      }
+    }
+
+    for (EquityResult& share : m_shares)
+      share = EquityResult();
+    PokerHandEvaluator::awardShowdown(block.evaluations(d), m_players,
+                                      m_shares, 1.0);
+    const double weight = block.weight(d);
+    for (size_t i = 0; i < m_players; i++) {
+      m_results[i].winShares += weight * m_shares[i].winShares;
+      m_results[i].tieShares += weight * m_shares[i].tieShares;
+    }
+
+    // the runout cards, lowest first
+    m_cards.clear();
+    for (uint64_t rest = (block.board(d) ^ m_board).mask(); rest != 0;
+         rest &= rest - 1)
+      m_cards.push_back(rest & ~(rest - 1));
+    for (uint32_t subset : m_subsets) {
+      uint64_t key = 0;
+      for (size_t c = 0; c < m_cards.size(); c++)
+        if (subset >> c & 1)
+          key |= m_cards[c];
+      Group& group = m_groups[slot(key)];
+      for (size_t i = 0; i < m_players; i++)
+        group.shares[i] += m_shares[i].winShares + m_shares[i].tieShares;
+      group.deals++;
+    }
+  }
+}
+
+size_t EquityDistributionVisitor::slot(uint64_t key) {
+  // single cards are looked up directly, the common case of one card
+  size_t* found = nullptr;
+  if ((key & (key - 1)) == 0 && key != 0) {
+    found = &m_byCard[lastbit(key)];
+  } else {
+    auto it = m_index.emplace(key, kNoGroup).first;
+    found = &it->second;
+  }
+  if (*found == kNoGroup) {
+    // the groups are kept from tuple to tuple to save allocations
+    if (m_used == m_groups.size())
+      m_groups.emplace_back();
+    Group& group = m_groups[m_used];
+    group.key = key;
+    group.shares.assign(m_players, 0.0);
+    group.deals = 0;
+    *found = m_used++;
+  }
+  return *found;
+}
+
+bool EquityDistributionVisitor::decided(size_t winner, uint64_t ndeals,
+                                        double weight) {
+  flush();
+  m_hands.clear();
+  m_results[winner].winShares += weight * static_cast<double>(ndeals);
+  const double w =
+      weight * static_cast<double>(ndeals) * static_cast<double>(
+                                                 m_subsets.size());
+  for (size_t i = 0; i < m_players; i++)
+    m_histograms[i].add(i == winner ? 1.0 : 0.0, w);
+  return true;
+}
+
+void EquityDistributionVisitor::flush() {
+  for (size_t g = 0; g < m_used; g++) {
+    const Group& group = m_groups[g];
+    const double deals = static_cast<double>(group.deals);
+    for (size_t i = 0; i < m_players; i++)
+      m_histograms[i].add(group.shares[i] / deals, m_weight * deals);
+    if ((group.key & (group.key - 1)) == 0 && group.key != 0)
+      m_byCard[lastbit(group.key)] = kNoGroup;
+  }
+  m_used = 0;
+  m_index.clear();
+}
+
+std::vector<EquityResult> EquityDistributionVisitor::results() {
+  flush();
+  m_hands.clear();
+  std::vector<EquityResult> results = m_results;
+  for (size_t i = 0; i < m_players; i++) {
+    const EquityHistogram& histogram = m_histograms[i];
+    results[i].equity = histogram.mean();
+    results[i].equity2 =
+        histogram.weight > 0.0 ? histogram.moment2 / histogram.weight : 0.0;
+  }
+  return results;
+}
+
+const std::vector<EquityHistogram>& EquityDistributionVisitor::histograms() {
+  flush();
+  m_hands.clear();
+  return m_histograms;
+}
+
+}  // namespace nit
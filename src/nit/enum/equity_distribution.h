@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_EQUITY_DISTRIBUTION_H_
+#define NIT_ENUM_EQUITY_DISTRIBUTION_H_
+
+#include <cstdint>
+
+#include <unordered_map>
+#include <vector>
+
+#include "showdown_visitor.h"
+
+namespace nit {
+
+/**
+ * The distribution of a player's equity.  bins[b] is the weight of the
+ * equities in [b/n, (b+1)/n) of n bins, the last bin taking 1 as well.
+ * The moments are summed from the equities themselves, not the bins, so
+ * mean() is the equity of the plain enumeration.
+ */
+struct EquityHistogram {
+  std::vector<double> bins;
+  double weight{0.0};   ///< the total weight of the distribution
+  double moment1{0.0};  ///< the weighted sum of the equities
+  double moment2{0.0};  ///< the weighted sum of their squares
+
+  double mean() const { return weight > 0.0 ? moment1 / weight : 0.0; }
+  double variance() const {
+    return weight > 0.0 ? moment2 / weight - mean() * mean() : 0.0;
+  }
+
+  /// add an equity with a weight
+  void add(double equity, double w) {
+    size_t b = static_cast<size_t>(equity * bins.size());
+    bins[b < bins.size() ? b : bins.size() - 1] += w;
+    weight += w;
+    moment1 += w * equity;
+    moment2 += w * equity * equity;
+  }
+};
+
+/**
+ * Asks for the distribution of each player's equity from an enumeration,
+ * see EnumerationOptions::distribution, and receives it.  The equity is
+ * taken once cards more board cards are out, over the rest of the
+ * runouts: with cards 1 on the flop it is the equity of the hands after
+ * each turn card, with 0 the equity of each tuple of hands, and with all
+ * the cards to come the share of each showdown.
+ */
+struct EquityDistribution {
+  size_t cards{1};  ///< the board cards dealt before the equity is taken
+  size_t bins{20};
+  std::vector<EquityHistogram> players;  ///< filled by the enumeration
+};
+
+/**
+ * Sums the shares of every deal, as EquityVisitor does, and the equity
+ * of the hands of every deal for each set of the next cards of its
+ * runout.  A runout adds its shares to each of its subsets of that many
+ * cards, so a deal costs one update per subset, two on the flop with one
+ * card.  The deals of a tuple of hands arrive together, and each tuple's
+ * equities go to the histograms once its deals are done.
+ *
+ * The weight of an equity is the weight of the tuple of hands times the
+ * runouts it was taken over, so the histograms are the distribution over
+ * the deals of the enumeration.
+ */
+class EquityDistributionVisitor : public ShowdownVisitor {
+ public:
+  EquityDistributionVisitor(size_t players, const CardSet& board,
+                            const PokerHandEvaluator& peval, size_t cards,
+                            size_t bins);
+
+  void visit(const ShowdownBlock& block) override;
+  bool decided(size_t winner, uint64_t ndeals, double weight) override;
+
+  /// @returns the shares, with the mean and second moment of the equity
+  std::vector<EquityResult> results();
+
+  /// @returns the distribution of the equity of each player
+  const std::vector<EquityHistogram>& histograms();
+
+ private:
+  static const size_t kNoGroup = static_cast<size_t>(-1);
+
+  struct Group {
+    uint64_t key{0};             // the cards of the group
+    std::vector<double> shares;  // [player]
+    uint64_t deals{0};
+  };
+
+  /// @returns the group of the current tuple with key, added if new
+  size_t slot(uint64_t key);
+  void flush();
+
+  size_t m_players;
+  CardSet m_board;
+  size_t m_runout;                  // the board cards to come
+  std::vector<uint32_t> m_subsets;  // of the runout, as bits of its cards
+  std::vector<EquityResult> m_results;
+  std::vector<EquityHistogram> m_histograms;
+  std::vector<EquityResult> m_shares;  // of one deal
+  std::vector<uint64_t> m_cards;       // of the runout of one deal
+
+  // the groups of the current tuple, by the next cards of the runout
+  std::vector<CardSet> m_hands;
+  double m_weight;
+  std::vector<Group> m_groups;
+  size_t m_used;  // the groups of the tuple, the rest are spare
+  std::vector<size_t> m_byCard;                  // the groups of one card
+  std::unordered_map<uint64_t, size_t> m_index;  // the groups of the rest
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_EQUITY_DISTRIBUTION_H_
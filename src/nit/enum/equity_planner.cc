@@ -0,0 +1,329 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "equity_planner.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include <nit/error.h>
+#include <nit/util/combinations.h>
+
+#include "board_major_enumerator.h"
+#include "dense_distribution.h"
+#include "distribution_walker.h"
+#include "monte_carlo_enumerator.h"
+#include "showdown_enumerator.h"
+
+namespace nit {
+
+namespace {
+
+/// walk the tuples to count them when there are at most this many
+const double kCountLimit = 1e6;
+
+/// the largest number of hand pairs scanned for the conflicts of two ranges
+const size_t kPairLimit = 1 << 22;
+
+/**
+ * The costs of the enumerators in units of the evaluations timed by
+ * measureRate, which are faster than those of a real enumeration, as the
+ * timed hands stay in the cache.  These were fitted to heads up and three
+ * way hold'em queries from the flop to the river: per evaluation and per
+ * tuple of the exact enumeration, and per live hand and board, and per
+ * tuple of the multiway sweep, for board major.
+ */
+const double kEvaluationCost = 2.5;
+const double kTupleCost = 32.0;
+const double kBoardMajorHandCost = 10.0;
+const double kBoardMajorTupleCost = 8.0;
+
+/// the cost of a Monte Carlo sample per player, for the draw and the deal
+const double kSampleCost = 6.0;
+
+/// the fewest samples Monte Carlo is run with, whatever the budget
+const uint64_t kMinSamples = 10000;
+
+const double kInfinity = std::numeric_limits<double>::infinity();
+
+/// @returns the number of ways to deal the missing cards as a double
+double countDeals(size_t live, const std::vector<size_t>& parts) {
+  double count = 1.0;
+  for (size_t part : parts) {
+    count *= static_cast<double>(choose(live, part));
+    live -= std::min(part, live);
+  }
+  return count;
+}
+
+/// @returns the fraction of the hand pairs of two ranges without conflicts
+double disjointFraction(const DenseDistribution& a,
+                        const DenseDistribution& b) {
+  size_t step = std::max<size_t>(1, a.size() * b.size() / kPairLimit);
+  double pairs = 0.0;
+  double disjoint = 0.0;
+  for (size_t i = 0; i < a.size(); i += step) {
+    for (size_t j = 0; j < b.size(); j++)
+      disjoint += (a.mask(i) & b.mask(j)) == 0 ? 1.0 : 0.0;
+    pairs += static_cast<double>(b.size());
+  }
+  return pairs > 0.0 ? disjoint / pairs : 0.0;
+}
+
+/// @returns the mean number of cards of the hands of a range
+size_t meanHandSize(const DenseDistribution& dist) {
+  double cards = 0.0;
+  for (uint64_t mask : dist.masks())
+    cards += static_cast<double>(CardSet(mask).size());
+  return dist.size() ? static_cast<size_t>(cards / dist.size() + 0.5) : 0;
+}
+
+/**
+ * Estimate the tuples of disjoint hands, by assuming that the conflicts
+ * between each pair of ranges are independent of each other.
+ */
+double estimateTuples(const std::vector<DenseDistribution>& dists,
+                      size_t count) {
+  double tuples = 1.0;
+  for (size_t i = 0; i < count; i++) {
+    tuples *= static_cast<double>(dists[i].size());
+    for (size_t j = 0; j < i; j++)
+      tuples *= disjointFraction(dists[i], dists[j]);
+  }
+  return tuples;
+}
+
+/**
+ * Estimate the tuples the board major sweep visits on a board: for each
+ * player, those of the player and of all opponents but the largest one.
+ * Only half of each opponent range is visited on average, as the sweep
+ * stops at the hands which beat the player's hand.
+ */
+double estimateSweepTuples(const std::vector<DenseDistribution>& dists) {
+  const size_t n = dists.size();
+  std::vector<std::vector<double>> fractions(n, std::vector<double>(n, 1.0));
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < i; j++)
+      fractions[i][j] = fractions[j][i] = disjointFraction(dists[i], dists[j]);
+
+  double tuples = 0.0;
+  for (size_t hero = 0; hero < n; hero++) {
+    size_t last = hero == 0 ? 1 : 0;
+    for (size_t p = 0; p < n; p++)
+      if (p != hero && dists[p].size() > dists[last].size())
+        last = p;
+    double count = 1.0;
+    for (size_t i = 0; i < n; i++) {
+      if (i == last)
+        continue;
+      count *= static_cast<double>(dists[i].size()) * (i == hero ? 1.0 : 0.5);
+      for (size_t j = 0; j < i; j++)
+        if (j != last)
+          count *= fractions[i][j];
+    }
+    tuples += count;
+  }
+  return tuples;
+}
+
+/// @returns true if the board major enumerator can answer the query
+bool boardMajorFits(const std::vector<DenseDistribution>& dists,
+                    const PokerHandEvaluator& peval) {
+  if (peval.evaluationSize() != 1 || peval.boardSize() == 0 ||
+      dists.size() < 2)
+    return false;
+  for (const DenseDistribution& dist : dists)
+    for (uint64_t mask : dist.masks())
+      if (CardSet(mask).size() != peval.handSize())
+        return false;
+  return true;
+}
+
+}  // namespace
+
+std::string str(EquityMethod method) {
+  switch (method) {
+    case EquityMethod::Exact:
+      return "exact";
+    case EquityMethod::BoardMajor:
+      return "board major";
+    case EquityMethod::MonteCarlo:
+      return "monte carlo";
+  }
+  return "unknown";
+}
+
+std::string EquityPlan::str() const {
+  std::ostringstream out;
+  out << "tuples: " << tuples << (counted ? " (counted)" : " (estimated)")
+      << "\n";
+  out << "exact evaluations: " << evaluations << "\n";
+  out << "exact cost: " << exactCost << "\n";
+  out << "board major cost: " << boardMajorCost << "\n";
+  out << "evaluations per second: " << rate << "\n";
+  out << "method: " << nit::str(method);
+  if (method == EquityMethod::MonteCarlo)
+    out << ", " << samples << " samples";
+  out << "\n";
+  out << "estimated seconds: " << seconds << "\n";
+  out << "error bound: " << errorBound << "\n";
+  return out.str();
+}
+
+EquityPlanner::EquityPlanner(double rate) : m_rate(rate) {}
+
+double EquityPlanner::measureRate(const PokerHandEvaluator& peval) {
+  // deal a batch of random hands up front, so only the evaluations are
+  // timed, and evaluate the batch over and over for a few milliseconds
+  const size_t batch = 256;
+  const size_t ncards = peval.handSize() + peval.boardSize();
+  std::vector<size_t> deck(STANDARD_DECK_SIZE);
+  for (size_t c = 0; c < deck.size(); c++)
+    deck[c] = c;
+  std::mt19937_64 rng(0);
+  std::vector<CardSet> hands(batch), boards(batch);
+  for (size_t i = 0; i < batch; i++) {
+    for (size_t c = 0; c < ncards; c++) {
+      std::swap(deck[c], deck[c + rng() % (deck.size() - c)]);
+      (c < peval.handSize() ? hands[i] : boards[i]) |=
+          CardSet(UINT64_C(1) << deck[c]);
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  uint64_t evaluations = 0;
+  int sink = 0;
+  double elapsed = 0.0;
+  while (elapsed < 0.005) {
+    for (size_t i = 0; i < batch; i++)
+      sink ^= peval.evaluateHand(hands[i], boards[i]).high().code();
+    evaluations += batch;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            start).count();
+  }
+  // a store the optimiser must keep, so the evaluations are not dropped
+  volatile int kept = sink;
+  static_cast<void>(kept);
+  return static_cast<double>(evaluations) / elapsed;
+}
+
+EquityPlan EquityPlanner::plan(const std::vector<CardDistribution>& dists,
+                               const CardSet& board,
+                               const PokerHandEvaluator& peval,
+                               double budget) const {
+  if (dists.size() < 2)
+    throw InvalidArgument("equity needs at least two players");
+  std::vector<DenseDistribution> dense;
+  for (const CardDistribution& dist : dists)
+    dense.emplace_back(dist);
+  const size_t ndists = dense.size();
+  const size_t boardsize = peval.boardSize() > 0 ? board.size() : 0;
+
+  EquityPlan plan;
+  plan.rate = m_rate > 0.0 ? m_rate : measureRate(peval);
+
+  // the deals of an exact enumeration, counted tuple by tuple if there
+  // are few enough tuples, and estimated otherwise
+  std::vector<size_t> parts(ndists);
+  if (peval.boardSize() > 0)
+    parts.push_back(peval.boardSize() - boardsize);
+  double product = 1.0;
+  for (const DenseDistribution& dist : dense)
+    product *= static_cast<double>(dist.size());
+  double deals = 0.0;
+  if (product <= kCountLimit) {
+    DistributionWalker walker(dense, board);
+    while (walker.next()) {
+      for (size_t i = 0; i < ndists; i++)
+        parts[i] = peval.handSize() - walker.hand(i).size();
+      deals += countDeals(STANDARD_DECK_SIZE - walker.dead().size(), parts);
+      plan.tuples += 1.0;
+    }
+    plan.counted = true;
+  } else {
+    size_t dead = boardsize;
+    for (size_t i = 0; i < ndists; i++) {
+      size_t cards = meanHandSize(dense[i]);
+      parts[i] = peval.handSize() - std::min(cards, peval.handSize());
+      dead += cards;
+    }
+    plan.tuples = estimateTuples(dense, ndists);
+    deals = plan.tuples * countDeals(STANDARD_DECK_SIZE - dead, parts);
+  }
+  plan.evaluations = deals * static_cast<double>(ndists);
+  plan.exactCost =
+      kEvaluationCost * plan.evaluations + kTupleCost * plan.tuples;
+
+  // board major visits each board once, the multiway sweep also pays for
+  // the tuples of the opponents it enumerates on every board
+  plan.boardMajorCost = kInfinity;
+  if (boardMajorFits(dense, peval)) {
+    double boards = static_cast<double>(
+        choose(STANDARD_DECK_SIZE - boardsize, peval.boardSize() - boardsize));
+    double hands = 0.0;
+    for (const DenseDistribution& dist : dense)
+      hands += static_cast<double>(dist.size());
+    double perBoard = hands * kBoardMajorHandCost;
+    if (ndists > 2)
+      perBoard += kBoardMajorTupleCost * estimateSweepTuples(dense);
+    plan.boardMajorCost = boards * perBoard;
+  }
+
+  // the cheapest exact method which fits, or sampling
+  double exactSeconds = plan.exactCost / plan.rate;
+  double boardMajorSeconds = plan.boardMajorCost / plan.rate;
+  if (std::min(exactSeconds, boardMajorSeconds) <= budget) {
+    plan.method = boardMajorSeconds < exactSeconds ? EquityMethod::BoardMajor
+                                                   : EquityMethod::Exact;
+    plan.seconds = std::min(exactSeconds, boardMajorSeconds);
+    plan.errorBound = 0.0;
+  } else {
+    plan.method = EquityMethod::MonteCarlo;
+    double perSample = kSampleCost * (static_cast<double>(ndists) + 1.0);
+    plan.samples = std::max(
+        kMinSamples, static_cast<uint64_t>(budget * plan.rate / perSample));
+    plan.seconds = static_cast<double>(plan.samples) * perSample / plan.rate;
+    // the variance of an equity share is at most 1/4
+    plan.errorBound = 1.96 * 0.5 / std::sqrt(static_cast<double>(plan.samples));
+  }
+  return plan;
+}
+
+PlannedEquity EquityPlanner::calculateEquity(
+    const std::vector<CardDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, double budget,
+    size_t evaluationCache) const {
+  PlannedEquity planned;
+  planned.plan = plan(dists, board, peval, budget);
+  switch (planned.plan.method) {
+    case EquityMethod::Exact: {
+      EnumerationOptions options;
+      options.evaluationCache = evaluationCache;
+      planned.results =
+          ShowdownEnumerator().calculateEquity(dists, board, peval, options);
+      break;
+    }
+    case EquityMethod::BoardMajor:
+      planned.results =
+          BoardMajorEnumerator().calculateEquity(dists, board, peval).players;
+      break;
+    case EquityMethod::MonteCarlo: {
+      std::vector<DenseDistribution> dense;
+      for (const CardDistribution& dist : dists)
+        dense.emplace_back(dist);
+      SampledEquity sampled = MonteCarloEnumerator().calculateEquity(
+          dense, board, peval, planned.plan.samples);
+      planned.results = sampled.results;
+      planned.errorBound = sampled.errorBound;
+      break;
+    }
+  }
+  return planned;
+}
+
+}  // namespace nit
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_EQUITY_PLANNER_H_
+#define NIT_ENUM_EQUITY_PLANNER_H_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "card_distribution.h"
+
+namespace nit {
+
+/// The ways an equity query can be answered.
+enum class EquityMethod {
+  Exact,       ///< ShowdownEnumerator, every deal is visited
+  BoardMajor,  ///< BoardMajorEnumerator, exact, each board is visited once
+  MonteCarlo   ///< MonteCarloEnumerator, sampled deals
+};
+
+/// @returns the name of a method
+std::string str(EquityMethod method);
+
+/**
+ * The work needed to answer a query each way, and the way chosen.  The
+ * costs are in hand evaluations of EquityPlanner::measureRate, and the
+ * times follow from the measured speed of the evaluator.  A method which
+ * can not answer the query has an infinite cost.
+ */
+struct EquityPlan {
+  EquityMethod method{EquityMethod::Exact};
+  double tuples{0.0};       ///< tuples of hands without card conflicts
+  double evaluations{0.0};  ///< hand evaluations of the exact enumeration
+  bool counted{false};      ///< the tuples were counted, not estimated
+  double exactCost{0.0};    ///< the cost of the exact enumeration
+  double boardMajorCost{0.0};
+  double rate{0.0};         ///< hand evaluations per second
+  uint64_t samples{0};      ///< the samples to draw for Monte Carlo
+  double seconds{0.0};      ///< the estimated time of the chosen method
+  double errorBound{0.0};   ///< the expected error bound of the method
+
+  std::string str() const;
+};
+
+/// The answer to a query, and how it was found.
+struct PlannedEquity {
+  EquityPlan plan;
+  std::vector<EquityResult> results;
+  double errorBound{0.0};  ///< the largest 95% half width of an equity
+};
+
+/**
+ * Chooses how to answer an equity query within a time budget.  The work
+ * of an exact enumeration is counted by walking the tuples of hands when
+ * there are few enough of them, and estimated otherwise from the range
+ * sizes, the pairwise card conflicts between the ranges, and the number
+ * of deals per tuple.  The exact methods are preferred whenever one fits
+ * the budget, the cheaper of the two, and Monte Carlo sampling with as
+ * many samples as fit the budget is used otherwise.
+ */
+class EquityPlanner {
+ public:
+  /// @param rate  hand evaluations per second, measured if zero
+  explicit EquityPlanner(double rate = 0.0);
+
+  EquityPlan plan(const std::vector<CardDistribution>& dists,
+                  const CardSet& board, const PokerHandEvaluator& peval,
+                  double budget) const;
+
+  /**
+   * plan the query, and run the plan.  The evaluation cache, see
+   * EnumerationOptions::evaluationCache, goes to the exact enumeration,
+   * the other methods evaluate each hand on each board about once.
+   */
+  PlannedEquity calculateEquity(const std::vector<CardDistribution>& dists,
+                                const CardSet& board,
+                                const PokerHandEvaluator& peval,
+                                double budget,
+                                size_t evaluationCache = 0) const;
+
+  /// @returns the hand evaluations per second of an evaluator
+  static double measureRate(const PokerHandEvaluator& peval);
+
+ private:
+  double m_rate;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_EQUITY_PLANNER_H_
@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "flop_equity_table.h"
+
+#include <cstring>
+
+#include <algorithm>
+
+#include <nit/error.h>
+
+#include "board_major_enumerator.h"
+#include "card_distribution.h"
+
+namespace nit {
+
+namespace {
+
+const char kMagic[8] = {'n', 'i', 't', '-', 'f', 'l', '0', '1'};
+
+struct Header {
+  char magic[8];
+  uint32_t flops;
+  uint32_t holdings;
+};
+
+const uint64_t kDeck = (UINT64_C(1) << STANDARD_DECK_SIZE) - 1;
+
+void checkFlop(const CardSet& flop) {
+  if (flop.size() != 3 || (flop.mask() & ~kDeck) != 0)
+    throw InvalidArgument("a flop has three cards")
+        << errinfo_value(flop.str());
+}
+
+void checkHolding(const CardSet& holding) {
+  if (holding.size() != 2 || (holding.mask() & ~kDeck) != 0)
+    throw InvalidArgument("a holding has two cards")
+        << errinfo_value(holding.str());
+}
+
+/// @returns true if five ranks in a row are set, the ace plays low too
+bool hasStraight(int ranks) {
+  int bits = ranks << 1 | (ranks >> (Rank::NUM_RANK - 1) & 1);
+  return (bits & bits >> 1 & bits >> 2 & bits >> 3 & bits >> 4) != 0;
+}
+
+}  // namespace
+
+const size_t FlopEquityTable::kFlops;
+const size_t FlopEquityTable::kHoldings;
+
+FlopEquityTable::FlopEquityTable(const std::string& path)
+    : m_table(path, kMagic, "a flop table"), m_entries(nullptr) {
+  const Header header = m_table.header<Header>();
+  if (header.flops != kFlops || header.holdings != kHoldings)
+    m_table.reject();
+  m_entries = m_table.entries<Header, FlopHoldingEntry>(kFlops * kHoldings);
+}
+
+const FlopHoldingEntry& FlopEquityTable::get(const CardSet& flop,
+                                             const CardSet& holding) const {
+  checkHolding(holding);
+  if (flop.intersects(holding))
+    throw InvalidArgument("the holding shares a card with the flop")
+        << errinfo_value(flop.str() + " " + holding.str());
+  return m_entries[flopIndex(flop) * kHoldings +
+                   holdingIndex(canonizeToBoard(flop, holding))];
+}
+
+const std::vector<uint64_t>& FlopEquityTable::flops() {
+  static const std::vector<uint64_t> canonical = [] {
+    std::vector<uint64_t> flops;
+    const size_t n = STANDARD_DECK_SIZE;
+    for (size_t a = 0; a < n; a++)
+      for (size_t b = a + 1; b < n; b++)
+        for (size_t c = b + 1; c < n; c++)
+          flops.push_back(CardSet(UINT64_C(1) << a | UINT64_C(1) << b |
+                                  UINT64_C(1) << c)
+                              .canonize()
+                              .mask());
+    std::sort(flops.begin(), flops.end());
+    flops.erase(std::unique(flops.begin(), flops.end()), flops.end());
+    return flops;
+  }();
+  return canonical;
+}
+
+size_t FlopEquityTable::flopIndex(const CardSet& flop) {
+  checkFlop(flop);
+  const std::vector<uint64_t>& all = flops();
+  return std::lower_bound(all.begin(), all.end(), flop.canonize().mask()) -
+         all.begin();
+}
+
+size_t FlopEquityTable::holdingIndex(const CardSet& holding) {
+  checkHolding(holding);
+  return holding.colex();
+}
+
+FlopEquityTable::Draw FlopEquityTable::drawClass(const CardSet& flop,
+                                                 const CardSet& holding) {
+  checkFlop(flop);
+  checkHolding(holding);
+  const CardSet cards(flop.mask() | holding.mask());
+
+  // a flop has at most three of a suit, so a draw always needs a hole card
+  bool flush = false, flushDraw = false, backdoor = false;
+  for (Suit s = Suit::begin(); s < Suit::end(); ++s) {
+    if (holding.suitMask(s) == 0)
+      continue;
+    size_t n = CardSet(static_cast<uint64_t>(cards.suitMask(s))).size();
+    flush |= n >= 5;
+    flushDraw |= n == 4;
+    backdoor |= n == 3;
+  }
+
+  // the ranks which make a straight with one more card
+  const int ranks = cards.rankMask();
+  size_t outs = 0;
+  if (!hasStraight(ranks))
+    for (unsigned r = 0; r < Rank::NUM_RANK; r++)
+      if (!(ranks >> r & 1) && hasStraight(ranks | 1 << r))
+        outs++;
+
+  if (flush)
+    flushDraw = backdoor = false;
+  if (flushDraw)
+    return outs > 0 ? COMBO_DRAW : FLUSH_DRAW;
+  if (outs > 1)
+    return OPEN_ENDED;
+  if (outs == 1)
+    return GUTSHOT;
+  return backdoor ? BACKDOOR_FLUSH : NO_DRAW;
+}
+
+std::string FlopEquityTable::drawName(int draw) {
+  static const char* const names[NUM_DRAWS] = {
+      "no draw",  "backdoor flush", "gutshot",
+      "open end", "flush draw",     "combo draw"};
+  if (draw < 0 || draw >= NUM_DRAWS)
+    throw InvalidArgument("no such draw class")
+        << errinfo_value(std::to_string(draw));
+  return names[draw];
+}
+
+std::vector<FlopHoldingEntry> FlopEquityTable::build(
+    const CardSet& flop, const PokerHandEvaluator& peval) {
+  checkFlop(flop);
+  std::vector<CardSet> holdings;
+  for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++) {
+    for (size_t lo = 0; lo < hi; lo++) {
+      CardSet holding(UINT64_C(1) << hi | UINT64_C(1) << lo);
+      if (!holding.intersects(flop))
+        holdings.push_back(holding);
+    }
+  }
+  CardDistribution random(holdings[0]);
+  for (size_t i = 1; i < holdings.size(); i++)
+    random.insert(holdings[i]);
+
+  // every holding of the range against all of them at once, the shares of
+  // a holding are over the same number of deals for all of them
+  RangeEquityResult result =
+      BoardMajorEnumerator().calculateEquity(random, random, flop, peval);
+  const size_t live = STANDARD_DECK_SIZE - flop.size() - 2;
+  const double deals = live * (live - 1) / 2.0 * (live - 2) * (live - 3) / 2.0;
+
+  std::vector<FlopHoldingEntry> entries(kHoldings);
+  for (size_t i = 0; i < random.size(); i++) {
+    const CardSet& holding = random[i];
+    FlopHoldingEntry& entry = entries[holdingIndex(holding)];
+    const EquityResult& shares = result.hands[0][i];
+    entry.equity =
+        static_cast<float>((shares.winShares + shares.tieShares) / deals);
+    entry.handClass = static_cast<uint8_t>(
+        peval.evaluateHand(holding, flop).high().type());
+    entry.drawClass = static_cast<uint8_t>(drawClass(flop, holding));
+  }
+  return entries;
+}
+
+void FlopEquityTable::write(const std::string& path,
+                            const std::vector<FlopHoldingEntry>& entries) {
+  if (entries.size() != kFlops * kHoldings)
+    throw InvalidArgument("a flop table has an entry for every holding");
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.flops = static_cast<uint32_t>(kFlops);
+  header.holdings = static_cast<uint32_t>(kHoldings);
+  writeTable(path, header, entries, "a flop table");
+}
+
+}  // namespace nit
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_FLOP_EQUITY_TABLE_H_
+#define NIT_ENUM_FLOP_EQUITY_TABLE_H_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "mapped_table.h"
+
+namespace nit {
+
+/**
+ * What a hold'em holding has on a flop.  The equity is against a random
+ * hand with the turn and river to come, the hand class is the type of
+ * the five card evaluation, NO_PAIR to STRAIGHT_FLUSH, and the draw class
+ * is one of FlopEquityTable::Draw.
+ */
+struct FlopHoldingEntry {
+  float equity{0.0f};
+  uint8_t handClass{0};
+  uint8_t drawClass{0};
+  uint16_t reserved{0};
+};
+
+/**
+ * The equity and strength of every holding on every flop, read from a
+ * table of the 1755 suit isomorphic flops.  A flop is mapped to its class
+ * by CardSet::canonize, and the holding along with it by canonizeToBoard,
+ * so any concrete flop and holding find the entry of their class.  Each
+ * flop has an entry for each of the 1326 holdings, by colex index, the
+ * ones which share a card with the flop are left empty.
+ *
+ * The equities of a flop are found in one board major enumeration of all
+ * the holdings against themselves, see BoardMajorEnumerator, and the
+ * whole table is built once by nit-flop, and mapped into memory.
+ *
+ * The file is a header, "nit-fl01" and the number of flops and holdings
+ * per flop as 32 bits, followed by the entries flop by flop in the order
+ * of the flops, in the byte order of the machine.
+ */
+class FlopEquityTable {
+ public:
+  static const size_t kFlops = 1755;
+  static const size_t kHoldings = 1326;
+
+  /// the draws of a holding, to a flush or a straight it does not have yet
+  enum Draw {
+    NO_DRAW = 0,
+    BACKDOOR_FLUSH,  ///< three to a flush with a hole card
+    GUTSHOT,         ///< one rank makes a straight
+    OPEN_ENDED,      ///< two ranks make a straight
+    FLUSH_DRAW,      ///< four to a flush
+    COMBO_DRAW,      ///< a flush draw and a straight draw
+    NUM_DRAWS
+  };
+
+  /// map the table at path, throws InvalidArgument if it is not one
+  explicit FlopEquityTable(const std::string& path);
+
+  /**
+   * @returns the entry of a holding on a flop, throws InvalidArgument if
+   * they are not three and two distinct cards
+   */
+  const FlopHoldingEntry& get(const CardSet& flop,
+                              const CardSet& holding) const;
+
+  /// @returns the canonical flops of all the classes, in index order
+  static const std::vector<uint64_t>& flops();
+
+  /// @returns the index of the class of a three card flop
+  static size_t flopIndex(const CardSet& flop);
+
+  /// @returns the index of a two card holding, its colex index
+  static size_t holdingIndex(const CardSet& holding);
+
+  /// @returns the draw class of a holding on a flop
+  static Draw drawClass(const CardSet& flop, const CardSet& holding);
+
+  /// @returns the name of a draw class, such as "flush draw"
+  static std::string drawName(int draw);
+
+  /**
+   * @returns the entries of all the holdings on a flop, kHoldings of them
+   * by holding index, with a hold'em evaluator
+   */
+  static std::vector<FlopHoldingEntry> build(const CardSet& flop,
+                                             const PokerHandEvaluator& peval);
+
+  /// write a table, with the entries of every flop in index order
+  static void write(const std::string& path,
+                    const std::vector<FlopHoldingEntry>& entries);
+
+ private:
+  MappedTable m_table;
+  const FlopHoldingEntry* m_entries;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_FLOP_EQUITY_TABLE_H_
@@ -0,0 +1,377 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "hand_potential_enumerator.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+#include <nit/util/combinations.h>
+#include <nit/util/lastbit.h>
+#include <nit/util/parallel_for.h>
+
+#include "simple_deck.h"
+
+namespace nit {
+
+namespace {
+
+const size_t kHoldings = 1326;
+
+// how the opponent compares with the holding, now or on the river
+const int kAhead = 0;  // the opponent is lower
+const int kTied = 1;
+const int kBehind = 2;
+
+int compare(int ours, int theirs) {
+  return theirs < ours ? kAhead : theirs == ours ? kTied : kBehind;
+}
+
+/// A Fenwick tree of counts, for the number of entries below a rank.
+class RankCounts {
+ public:
+  explicit RankCounts(size_t size) : m_tree(size + 1), m_total(0) {}
+
+  void clear() {
+    std::fill(m_tree.begin(), m_tree.end(), 0);
+    m_total = 0;
+  }
+
+  void add(size_t rank) {
+    for (size_t i = rank + 1; i < m_tree.size(); i += i & (~i + 1))
+      m_tree[i]++;
+    m_total++;
+  }
+
+  /// @returns the number of entries with a rank below rank
+  size_t below(size_t rank) const {
+    size_t sum = 0;
+    for (size_t i = rank; i > 0; i -= i & (~i + 1))
+      sum += m_tree[i];
+    return sum;
+  }
+
+  size_t total() const { return m_total; }
+
+ private:
+  std::vector<size_t> m_tree;
+  size_t m_total;
+};
+
+/// The holdings which can be dealt with a board, and how they rank on it.
+struct Holdings {
+  std::vector<uint64_t> masks;
+  std::vector<size_t> colex;
+  std::vector<int> codes;     // the evaluation on the board
+  std::vector<size_t> ranks;  // the dense rank of the evaluation
+  std::vector<size_t> cards[STANDARD_DECK_SIZE];  // the holdings by card
+
+  Holdings(const CardSet& board, const PokerHandEvaluator& peval) {
+    for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++) {
+      for (size_t lo = 0; lo < hi; lo++) {
+        uint64_t mask = UINT64_C(1) << hi | UINT64_C(1) << lo;
+        if (mask & board.mask())
+          continue;
+        cards[hi].push_back(masks.size());
+        cards[lo].push_back(masks.size());
+        masks.push_back(mask);
+        colex.push_back(CardSet(mask).colex());
+        codes.push_back(peval.evaluateHand(CardSet(mask), board).high().code());
+      }
+    }
+    std::vector<int> sorted(codes);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    for (int code : codes)
+      ranks.push_back(std::lower_bound(sorted.begin(), sorted.end(), code) -
+                      sorted.begin());
+  }
+
+  size_t size() const { return masks.size(); }
+
+  /// call f with each holding which shares a card with holding i and none
+  /// with dead, holding i included
+  template <typename F>
+  void forBlocked(size_t i, uint64_t dead, F f) const {
+    // the holding itself is in both lists, and visited once
+    uint64_t mask = masks[i];
+    size_t first = lastbit(mask);
+    size_t second = lastbit(mask & (mask - 1));
+    for (size_t j : cards[first])
+      if (!(masks[j] & dead))
+        f(j);
+    for (size_t j : cards[second])
+      if (j != i && !(masks[j] & dead))
+        f(j);
+  }
+};
+
+/// The sums of one holding over the runouts.
+struct Tally {
+  double counts[3][3] = {{0.0}};  // [now][river]
+  double ehs{0.0};
+  double ehs2{0.0};
+  double runouts{0.0};
+  double next[STANDARD_DECK_SIZE] = {0.0};  // the shares by runout card
+
+  void add(const Tally& other) {
+    for (int a = 0; a < 3; a++)
+      for (int b = 0; b < 3; b++)
+        counts[a][b] += other.counts[a][b];
+    ehs += other.ehs;
+    ehs2 += other.ehs2;
+    runouts += other.runouts;
+    for (size_t c = 0; c < STANDARD_DECK_SIZE; c++)
+      next[c] += other.next[c];
+  }
+};
+
+/**
+ * Count, for every holding live with the runout, the opponents by how
+ * they compare now and on the river.
+ */
+class RunoutCounter {
+ public:
+  explicit RunoutCounter(const Holdings& holdings)
+      : m_holdings(holdings),
+        m_river(holdings.size()),
+        m_ranks(holdings.size()),
+        m_tallies(holdings.size()) {}
+
+  std::vector<Tally>& tallies() { return m_tallies; }
+
+  void count(const CardSet& board, uint64_t runout,
+             const PokerHandEvaluator& peval) {
+    const Holdings& h = m_holdings;
+    const CardSet full(board.mask() | runout);
+    m_live.clear();
+    std::vector<size_t> perRank(h.size() + 1, 0);
+    for (size_t i = 0; i < h.size(); i++) {
+      if (h.masks[i] & runout)
+        continue;
+      m_live.push_back(i);
+      m_river[i] = runout ? peval.evaluateHand(CardSet(h.masks[i]), full)
+                                .high()
+                                .code()
+                          : h.codes[i];
+      perRank[h.ranks[i] + 1]++;
+    }
+    // perRank[r] becomes the number of live holdings ranked below r
+    for (size_t r = 1; r < perRank.size(); r++)
+      perRank[r] += perRank[r - 1];
+    std::sort(m_live.begin(), m_live.end(),
+              [this](size_t a, size_t b) { return m_river[a] < m_river[b]; });
+
+    m_ranks.clear();
+    for (size_t begin = 0; begin < m_live.size();) {
+      size_t end = begin;
+      while (end < m_live.size() &&
+             m_river[m_live[end]] == m_river[m_live[begin]])
+        end++;
+      m_group.clear();
+      for (size_t k = begin; k < end; k++)
+        m_group.push_back(h.ranks[m_live[k]]);
+      std::sort(m_group.begin(), m_group.end());
+
+      for (size_t k = begin; k < end; k++) {
+        size_t i = m_live[k];
+        size_t rank = h.ranks[i];
+        double n[3][3];
+        // the opponents below on the river
+        size_t lower = m_ranks.below(rank);
+        size_t level = m_ranks.below(rank + 1) - lower;
+        n[kAhead][kAhead] = lower;
+        n[kTied][kAhead] = level;
+        n[kBehind][kAhead] = m_ranks.total() - lower - level;
+        // the opponents tied on the river
+        size_t glower = std::lower_bound(m_group.begin(), m_group.end(), rank) -
+                        m_group.begin();
+        size_t gupper = std::upper_bound(m_group.begin(), m_group.end(), rank) -
+                        m_group.begin();
+        n[kAhead][kTied] = glower;
+        n[kTied][kTied] = gupper - glower;
+        n[kBehind][kTied] = m_group.size() - gupper;
+        // and the rest are above
+        size_t below = perRank[rank];
+        size_t at = perRank[rank + 1] - below;
+        n[kAhead][kBehind] = below - n[kAhead][kAhead] - n[kAhead][kTied];
+        n[kTied][kBehind] = at - n[kTied][kAhead] - n[kTied][kTied];
+        n[kBehind][kBehind] = m_live.size() - below - at -
+                              n[kBehind][kAhead] - n[kBehind][kTied];
+
+        h.forBlocked(i, runout, [&](size_t j) {
+          n[compare(h.codes[i], h.codes[j])]
+           [compare(m_river[i], m_river[j])] -= 1.0;
+        });
+
+        Tally& tally = m_tallies[i];
+        double ahead = 0.0, tied = 0.0, total = 0.0;
+        for (int a = 0; a < 3; a++) {
+          for (int b = 0; b < 3; b++)
+            tally.counts[a][b] += n[a][b];
+          ahead += n[a][kAhead];
+          tied += n[a][kTied];
+          total += n[a][kAhead] + n[a][kTied] + n[a][kBehind];
+        }
+        double share = total > 0.0 ? (ahead + tied / 2.0) / total : 0.0;
+        tally.ehs += share;
+        tally.ehs2 += share * share;
+        tally.runouts += 1.0;
+        for (uint64_t cards = runout; cards; cards &= cards - 1)
+          tally.next[lastbit(cards)] += share;
+      }
+
+      for (size_t k = begin; k < end; k++)
+        m_ranks.add(h.ranks[m_live[k]]);
+      begin = end;
+    }
+  }
+
+ private:
+  const Holdings& m_holdings;
+  std::vector<int> m_river;
+  RankCounts m_ranks;
+  std::vector<size_t> m_live;
+  std::vector<size_t> m_group;
+  std::vector<Tally> m_tallies;
+};
+
+void checkBoard(const CardSet& board) {
+  if (board.size() < 3 || board.size() > 5 ||
+      (board.mask() >> STANDARD_DECK_SIZE) != 0)
+    throw InvalidArgument("hand potential needs a flop, turn or river")
+        << errinfo_value(board.str());
+}
+
+/// @returns the cards which complete the board, an empty one on the river
+std::vector<uint64_t> runouts(const CardSet& board) {
+  SimpleDeck deck;
+  deck.remove(board);
+  std::vector<uint64_t> masks;
+  combinations cards(deck.size(), 5 - board.size());
+  do {
+    masks.push_back(deck.peek(cards.getMask()).mask());
+  } while (cards.next());
+  return masks;
+}
+
+/// the strength of every holding on the board as it is
+std::vector<HandPotential> finish(const Holdings& h,
+                                  const std::vector<Tally>& tallies) {
+  std::vector<size_t> perRank(h.size() + 1, 0);
+  for (size_t i = 0; i < h.size(); i++)
+    perRank[h.ranks[i] + 1]++;
+  for (size_t r = 1; r < perRank.size(); r++)
+    perRank[r] += perRank[r - 1];
+
+  std::vector<HandPotential> result(kHoldings);
+  for (size_t i = 0; i < h.size(); i++) {
+    double n[3] = {static_cast<double>(perRank[h.ranks[i]]),
+                   static_cast<double>(perRank[h.ranks[i] + 1] -
+                                       perRank[h.ranks[i]]),
+                   0.0};
+    n[kBehind] = h.size() - n[kAhead] - n[kTied];
+    h.forBlocked(i, 0, [&](size_t j) { n[compare(h.codes[i], h.codes[j])]--; });
+
+    HandPotential& potential = result[h.colex[i]];
+    potential.strength =
+        (n[kAhead] + n[kTied] / 2.0) / (n[kAhead] + n[kTied] + n[kBehind]);
+
+    const Tally& t = tallies[i];
+    potential.ehs = t.ehs / t.runouts;
+    potential.ehs2 = t.ehs2 / t.runouts;
+    // the opponents are ahead, tied or behind now, and then on the river
+    double row[3];
+    for (int a = 0; a < 3; a++)
+      row[a] = t.counts[a][kAhead] + t.counts[a][kTied] + t.counts[a][kBehind];
+    double behind = row[kBehind] + row[kTied] / 2.0;
+    double ahead = row[kAhead] + row[kTied] / 2.0;
+    if (behind > 0.0)
+      potential.ppot =
+          (t.counts[kBehind][kAhead] + t.counts[kBehind][kTied] / 2.0 +
+           t.counts[kTied][kAhead] / 2.0) /
+          behind;
+    if (ahead > 0.0)
+      potential.npot =
+          (t.counts[kAhead][kBehind] + t.counts[kTied][kBehind] / 2.0 +
+           t.counts[kAhead][kTied] / 2.0) /
+          ahead;
+  }
+  return result;
+}
+
+/// the sums of every holding over all the runouts, on a few threads
+std::vector<Tally> tallyRunouts(const CardSet& board,
+                                const Holdings& holdings, size_t nthreads) {
+  const std::vector<uint64_t> masks = runouts(board);
+  std::vector<std::unique_ptr<RunoutCounter>> counters;
+  std::vector<std::unique_ptr<PokerHandEvaluator>> pevals;
+  for (size_t t = 0; t < nthreads; t++) {
+    counters.emplace_back(new RunoutCounter(holdings));
+    pevals.push_back(makeEvaluator("h"));
+  }
+  parallelFor(masks.size(), nthreads, [&](size_t t, size_t r) {
+    counters[t]->count(board, masks[r], *pevals[t]);
+  });
+
+  std::vector<Tally>& tallies = counters[0]->tallies();
+  for (size_t t = 1; t < nthreads; t++)
+    for (size_t i = 0; i < tallies.size(); i++)
+      tallies[i].add(counters[t]->tallies()[i]);
+  return tallies;
+}
+
+}  // namespace
+
+HandPotentialEnumerator::HandPotentialEnumerator(size_t threads)
+    : m_threads(std::max<size_t>(1, threads)) {}
+
+std::vector<HandPotential> HandPotentialEnumerator::calculate(
+    const CardSet& board) const {
+  checkBoard(board);
+  std::unique_ptr<PokerHandEvaluator> peval = makeEvaluator("h");
+  const Holdings holdings(board, *peval);
+  return finish(holdings, tallyRunouts(board, holdings, m_threads));
+}
+
+std::vector<std::vector<double>> HandPotentialEnumerator::nextStrengths(
+    const CardSet& board) const {
+  checkBoard(board);
+  if (board.size() == 5)
+    throw InvalidArgument("there is no card to come on the river")
+        << errinfo_value(board.str());
+  std::unique_ptr<PokerHandEvaluator> peval = makeEvaluator("h");
+  const Holdings holdings(board, *peval);
+  const std::vector<Tally> tallies =
+      tallyRunouts(board, holdings, m_threads);
+
+  // each card comes with the same number of runouts for every holding
+  const size_t live = STANDARD_DECK_SIZE - board.size() - 2;
+  const double runouts =
+      static_cast<double>(choose(live - 1, 5 - board.size() - 1));
+  std::vector<std::vector<double>> result(kHoldings);
+  for (size_t i = 0; i < holdings.size(); i++) {
+    std::vector<double>& strengths = result[holdings.colex[i]];
+    for (size_t c = 0; c < STANDARD_DECK_SIZE; c++)
+      if (!((board.mask() | holdings.masks[i]) >> c & 1))
+        strengths.push_back(tallies[i].next[c] / runouts);
+    std::sort(strengths.begin(), strengths.end());
+  }
+  return result;
+}
+
+std::vector<std::vector<HandPotential>> HandPotentialEnumerator::calculate(
+    const std::vector<CardSet>& boards) const {
+  for (const CardSet& board : boards)
+    checkBoard(board);
+  std::vector<std::vector<HandPotential>> results(boards.size());
+  const HandPotentialEnumerator single(1);
+  parallelFor(boards.size(), m_threads, [&](size_t, size_t b) {
+    results[b] = single.calculate(boards[b]);
+  });
+  return results;
+}
+
+}  // namespace nit
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_HAND_POTENTIAL_ENUMERATOR_H_
+#define NIT_ENUM_HAND_POTENTIAL_ENUMERATOR_H_
+
+#include <vector>
+
+#include <nit/eval/card_set.h>
+
+namespace nit {
+
+/**
+ * The strength of a hold'em holding on a board against a random hand.
+ *
+ * strength is the share of the opponent holdings the hand beats on the
+ * board as it is, a tie counting half, and ehs and ehs2 the mean of that
+ * share and of its square on the river, over every runout.  ppot is the
+ * chance that a hand which is behind now ends up ahead on the river, and
+ * npot the chance that a hand which is ahead falls behind, ties counting
+ * half both ways.  The potentials look all the way to the river.  On the
+ * river ehs is the strength, and the potentials are 0.
+ */
+struct HandPotential {
+  double strength{0.0};
+  double ehs{0.0};
+  double ehs2{0.0};
+  double ppot{0.0};
+  double npot{0.0};
+};
+
+/**
+ * Hand strength and potential of every holding on a flop, turn or river
+ * in one board major pass.  For each runout all the live holdings are
+ * evaluated once and sorted, and for every holding the opponents are
+ * counted by how they compare now and on the river, with a Fenwick tree
+ * over the current ranks, so a runout costs n log n instead of n squared.
+ * The opponents which share a card with the holding are taken back out
+ * one by one.
+ *
+ * A single board splits its runouts over the threads, a batch of boards
+ * hands out whole boards.
+ */
+class HandPotentialEnumerator {
+ public:
+  explicit HandPotentialEnumerator(size_t threads = 1);
+
+  /**
+   * @returns the potential of every holding on a board of three to five
+   * cards, by the colex index of the holding.  The holdings which share a
+   * card with the board are left at 0.
+   */
+  std::vector<HandPotential> calculate(const CardSet& board) const;
+
+  /**
+   * @returns for every holding on a flop or turn, its expected strength
+   * on the next street after each card which can come, sorted, by the
+   * colex index of the holding.  The mean of these is the ehs, and they
+   * are the equity histogram used to bucket hands, see CardAbstraction.
+   */
+  std::vector<std::vector<double>> nextStrengths(const CardSet& board) const;
+
+  /// @returns the potentials of the holdings on each of the boards
+  std::vector<std::vector<HandPotential>> calculate(
+      const std::vector<CardSet>& boards) const;
+
+ private:
+  size_t m_threads;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_HAND_POTENTIAL_ENUMERATOR_H_
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "hand_potential_table.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+
+#include <nit/error.h>
+#include <nit/util/combinations.h>
+
+namespace nit {
+
+namespace {
+
+const char kMagic[8] = {'n', 'i', 't', '-', 'h', 'p', '0', '1'};
+
+struct Header {
+  char magic[8];
+  uint32_t boardSize;
+  uint32_t boards;
+  uint32_t holdings;
+  uint32_t fields;
+};
+
+const size_t kFields = 5;
+const size_t kBatch = 256;  // boards enumerated at a time when building
+const double kScale = 65535.0;
+
+void checkBoardSize(size_t boardSize) {
+  if (boardSize < 3 || boardSize > 5)
+    throw InvalidArgument("a street has three to five board cards")
+        << errinfo_value(std::to_string(boardSize));
+}
+
+/// the numbers stored per entry, all of them before the river
+size_t fields(size_t boardSize) { return boardSize == 5 ? 1 : kFields; }
+
+uint16_t quantize(double x) {
+  return static_cast<uint16_t>(
+      std::lround(std::min(1.0, std::max(0.0, x)) * kScale));
+}
+
+}  // namespace
+
+const size_t HandPotentialTable::kHoldings;
+
+HandPotentialTable::HandPotentialTable(const std::string& path)
+    : m_table(path, kMagic, "a hand potential table"),
+      m_entries(nullptr),
+      m_boardSize(0),
+      m_fields(0) {
+  const Header header = m_table.header<Header>();
+  if (header.boardSize < 3 || header.boardSize > 5 ||
+      header.boards != boards(header.boardSize).size() ||
+      header.holdings != kHoldings ||
+      header.fields != fields(header.boardSize))
+    m_table.reject();
+  m_entries = m_table.entries<Header, uint16_t>(
+      static_cast<size_t>(header.boards) * kHoldings * header.fields);
+  m_boardSize = header.boardSize;
+  m_fields = header.fields;
+}
+
+HandPotential HandPotentialTable::get(const CardSet& board,
+                                      const CardSet& holding) const {
+  if (board.size() != m_boardSize)
+    throw InvalidArgument("the board is not of the table's street")
+        << errinfo_value(board.str());
+  if (holding.size() != 2 || (holding.mask() >> STANDARD_DECK_SIZE) != 0 ||
+      holding.intersects(board))
+    throw InvalidArgument("a holding has two cards off the board")
+        << errinfo_value(holding.str());
+  const uint16_t* entry =
+      m_entries + (boardIndex(board) * kHoldings +
+                   canonizeToBoard(board, holding).colex()) *
+                      m_fields;
+  HandPotential potential;
+  potential.strength = entry[0] / kScale;
+  if (m_fields == 1) {
+    potential.ehs = potential.strength;
+    potential.ehs2 = potential.strength * potential.strength;
+  } else {
+    potential.ehs = entry[1] / kScale;
+    potential.ehs2 = entry[2] / kScale;
+    potential.ppot = entry[3] / kScale;
+    potential.npot = entry[4] / kScale;
+  }
+  return potential;
+}
+
+const std::vector<uint64_t>& HandPotentialTable::boards(size_t boardSize) {
+  checkBoardSize(boardSize);
+  auto classes = [](size_t n) {
+    std::vector<uint64_t> canonical;
+    combinations cards(STANDARD_DECK_SIZE, n);
+    do {
+      canonical.push_back(CardSet(cards.getMask()).canonize().mask());
+    } while (cards.next());
+    std::sort(canonical.begin(), canonical.end());
+    canonical.erase(std::unique(canonical.begin(), canonical.end()),
+                    canonical.end());
+    return canonical;
+  };
+  // each street is built the first time it is asked for
+  switch (boardSize) {
+    case 3: {
+      static const std::vector<uint64_t> flops = classes(3);
+      return flops;
+    }
+    case 4: {
+      static const std::vector<uint64_t> turns = classes(4);
+      return turns;
+    }
+    default: {
+      static const std::vector<uint64_t> rivers = classes(5);
+      return rivers;
+    }
+  }
+}
+
+size_t HandPotentialTable::boardIndex(const CardSet& board) {
+  if ((board.mask() >> STANDARD_DECK_SIZE) != 0)
+    throw InvalidArgument("not a board") << errinfo_value(board.str());
+  const std::vector<uint64_t>& all = boards(board.size());
+  return std::lower_bound(all.begin(), all.end(), board.canonize().mask()) -
+         all.begin();
+}
+
+void HandPotentialTable::build(const std::string& path, size_t boardSize,
+                               const HandPotentialEnumerator& enumerator) {
+  const std::vector<uint64_t>& all = boards(boardSize);
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.boardSize = static_cast<uint32_t>(boardSize);
+  header.boards = static_cast<uint32_t>(all.size());
+  header.holdings = static_cast<uint32_t>(kHoldings);
+  header.fields = static_cast<uint32_t>(fields(boardSize));
+  TableWriter writer(path, header, "a hand potential table");
+
+  std::vector<uint16_t> entries;
+  for (size_t first = 0; first < all.size() && writer.good();
+       first += kBatch) {
+    std::vector<CardSet> batch;
+    for (size_t b = first; b < std::min(all.size(), first + kBatch); b++)
+      batch.push_back(CardSet(all[b]));
+    entries.clear();
+    for (const std::vector<HandPotential>& board :
+         enumerator.calculate(batch)) {
+      for (const HandPotential& potential : board) {
+        entries.push_back(quantize(potential.strength));
+        if (header.fields == 1)
+          continue;
+        entries.push_back(quantize(potential.ehs));
+        entries.push_back(quantize(potential.ehs2));
+        entries.push_back(quantize(potential.ppot));
+        entries.push_back(quantize(potential.npot));
+      }
+    }
+    writer.write(entries);
+  }
+  writer.finish();
+}
+
+}  // namespace nit
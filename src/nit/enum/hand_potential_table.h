@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_HAND_POTENTIAL_TABLE_H_
+#define NIT_ENUM_HAND_POTENTIAL_TABLE_H_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "hand_potential_enumerator.h"
+#include "mapped_table.h"
+
+namespace nit {
+
+/**
+ * The strength and potential of every holding on every suit isomorphic
+ * board of one street, read from a table built by nit-ehs.  There are
+ * 1755 flops, 16432 turns and 134459 rivers, and a board is mapped to
+ * its class by CardSet::canonize and the holding along with it by
+ * canonizeToBoard.  Each board has an entry for each of the 1326
+ * holdings, by colex index.
+ *
+ * The numbers are stored as 16 bit fractions, and on the river only the
+ * strength is stored, as the rest follow from it.  The file is a header,
+ * "nit-hp01", the board size, the number of boards, the holdings per
+ * board and the numbers per entry as 32 bits, followed by the entries
+ * board by board in the order of the boards, in the byte order of the
+ * machine.  The rivers take some 360MB, the turns 220MB.
+ */
+class HandPotentialTable {
+ public:
+  static const size_t kHoldings = 1326;
+
+  /// map the table at path, throws InvalidArgument if it is not one
+  explicit HandPotentialTable(const std::string& path);
+
+  size_t boardSize() const { return m_boardSize; }
+
+  /**
+   * @returns the potential of a holding on a board of the table's size,
+   * throws InvalidArgument if they are not distinct cards
+   */
+  HandPotential get(const CardSet& board, const CardSet& holding) const;
+
+  /// @returns the canonical boards of a street, in index order
+  static const std::vector<uint64_t>& boards(size_t boardSize);
+
+  /// @returns the index of the class of a board of three to five cards
+  static size_t boardIndex(const CardSet& board);
+
+  /**
+   * enumerate every board class of a street, a batch of boards at a
+   * time, and write the table to path
+   */
+  static void build(const std::string& path, size_t boardSize,
+                    const HandPotentialEnumerator& enumerator);
+
+ private:
+  MappedTable m_table;
+  const uint16_t* m_entries;
+  size_t m_boardSize;
+  size_t m_fields;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_HAND_POTENTIAL_TABLE_H_
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "histogram_clustering.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+
+#include <nit/error.h>
+#include <nit/util/parallel_for.h>
+
+namespace nit {
+
+namespace {
+
+const double kScale = 65535.0;
+const size_t kSampleFactor = 20;  // points sampled per cluster to seed
+const size_t kMinSample = 10000;
+const size_t kChunk = 4096;  // points assigned per item of work
+
+/// @returns the scaled L1 distance of a point to a center
+double toCenter(const uint16_t* point, const double* center,
+                size_t dimension) {
+  double sum = 0.0;
+  for (size_t d = 0; d < dimension; d++)
+    sum += std::fabs(point[d] - center[d]);
+  return sum;
+}
+
+/// The cost and the changed assignments of one chunk of the points.
+struct Partial {
+  double cost{0.0};
+  size_t changed{0};
+};
+
+/**
+ * @returns the weighted median of some values, the least value with at
+ * least half of the weight at or below it
+ */
+double weightedMedian(std::vector<std::pair<uint16_t, float>>& values) {
+  std::sort(values.begin(), values.end());
+  double total = 0.0;
+  for (const std::pair<uint16_t, float>& value : values)
+    total += value.second;
+  double below = 0.0;
+  for (const std::pair<uint16_t, float>& value : values) {
+    below += value.second;
+    if (2.0 * below >= total)
+      return value.first;
+  }
+  return values.back().first;
+}
+
+}  // namespace
+
+HistogramClustering::HistogramClustering(size_t dimension, size_t clusters,
+                                         size_t threads)
+    : m_dimension(dimension),
+      m_clusters(clusters),
+      m_threads(std::max<size_t>(1, threads)),
+      m_cost(0.0) {
+  if (dimension == 0)
+    throw InvalidArgument("a point needs at least one quantile");
+  if (clusters == 0 || clusters > std::numeric_limits<uint16_t>::max())
+    throw InvalidArgument("there must be 1 to 65535 clusters")
+        << errinfo_value(std::to_string(clusters));
+}
+
+double HistogramClustering::distance(const uint16_t* a, const uint16_t* b,
+                                     size_t dimension) {
+  double sum = 0.0;
+  for (size_t d = 0; d < dimension; d++)
+    sum += std::abs(static_cast<int>(a[d]) - static_cast<int>(b[d]));
+  return sum / (kScale * dimension);
+}
+
+std::vector<uint16_t> HistogramClustering::cluster(
+    const std::vector<uint16_t>& points, const std::vector<float>& weights,
+    size_t iterations, uint64_t seed) {
+  const size_t dim = m_dimension;
+  const size_t n = weights.size();
+  if (points.size() != n * dim)
+    throw InvalidArgument("there must be a weight for every point");
+  if (n == 0)
+    throw InvalidArgument("there are no points to cluster");
+  const size_t k = std::min(m_clusters, n);
+
+  // seed the centers with k-means++ on a sample of the points
+  std::mt19937_64 rng(seed);
+  std::vector<size_t> sample(n);
+  std::iota(sample.begin(), sample.end(), 0);
+  const size_t nsample = std::min(n, std::max(kMinSample, kSampleFactor * k));
+  for (size_t i = 0; i < nsample; i++) {
+    std::uniform_int_distribution<size_t> pick(i, n - 1);
+    std::swap(sample[i], sample[pick(rng)]);
+  }
+  sample.resize(nsample);
+
+  std::vector<double> centers(k * dim);
+  std::vector<double> nearest(nsample, std::numeric_limits<double>::max());
+  std::vector<double> odds(nsample);
+  for (size_t c = 0; c < k; c++) {
+    for (size_t s = 0; s < nsample; s++)
+      odds[s] = weights[sample[s]] * (c == 0 ? 1.0 : nearest[s] * nearest[s]);
+    size_t chosen = 0;
+    if (std::accumulate(odds.begin(), odds.end(), 0.0) > 0.0)
+      chosen =
+          std::discrete_distribution<size_t>(odds.begin(), odds.end())(rng);
+    else
+      chosen = std::uniform_int_distribution<size_t>(0, nsample - 1)(rng);
+    const uint16_t* point = &points[sample[chosen] * dim];
+    std::copy(point, point + dim, centers.begin() + c * dim);
+    for (size_t s = 0; s < nsample; s++)
+      nearest[s] =
+          std::min(nearest[s], toCenter(&points[sample[s] * dim],
+                                        &centers[c * dim], dim));
+  }
+
+  // then alternate between assigning the points and moving the centers,
+  // and end on an assignment, so each point is at its nearest center.
+  // The points are assigned in fixed chunks and their costs summed in
+  // order, so the result does not depend on the threads.
+  std::vector<uint16_t> assignment(n, 0);
+  std::vector<Partial> partials((n + kChunk - 1) / kChunk);
+  std::vector<size_t> starts(k + 1);
+  std::vector<size_t> members(n);  // the points by cluster
+  std::vector<std::vector<std::pair<uint16_t, float>>> values(m_threads);
+  double total = 0.0;
+  for (size_t i = 0; i < n; i++)
+    total += weights[i];
+  for (size_t it = 0;; it++) {
+    parallelFor(partials.size(), m_threads, [&](size_t, size_t chunk) {
+      Partial& partial = partials[chunk];
+      partial.cost = 0.0;
+      partial.changed = 0;
+      for (size_t i = chunk * kChunk; i < std::min(n, (chunk + 1) * kChunk);
+           i++) {
+        const uint16_t* point = &points[i * dim];
+        size_t best = 0;
+        double bestDistance = std::numeric_limits<double>::max();
+        for (size_t c = 0; c < k; c++) {
+          double d = toCenter(point, &centers[c * dim], dim);
+          if (d < bestDistance) {
+            bestDistance = d;
+            best = c;
+          }
+        }
+        if (it == 0 || assignment[i] != best)
+          partial.changed++;
+        assignment[i] = static_cast<uint16_t>(best);
+        partial.cost += weights[i] * bestDistance;
+      }
+    });
+
+    size_t changed = 0;
+    m_cost = 0.0;
+    for (const Partial& partial : partials) {
+      changed += partial.changed;
+      m_cost += partial.cost;
+    }
+    m_cost = total > 0.0 ? m_cost / (total * kScale * dim) : 0.0;
+    if (changed == 0 || it == iterations)
+      break;
+
+    // the center nearest to the points of a cluster in L1 is the weighted
+    // median of their quantiles in each dimension.  A cluster which lost
+    // all its points, or their weight, keeps its center.
+    std::fill(starts.begin(), starts.end(), 0);
+    for (uint16_t a : assignment)
+      starts[a + 1]++;
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+    std::vector<size_t> next(starts.begin(), starts.end() - 1);
+    for (size_t i = 0; i < n; i++)
+      members[next[assignment[i]]++] = i;
+    parallelFor(k, m_threads, [&](size_t thread, size_t c) {
+      double weight = 0.0;
+      for (size_t m = starts[c]; m < starts[c + 1]; m++)
+        weight += weights[members[m]];
+      if (weight <= 0.0)
+        return;
+      for (size_t d = 0; d < dim; d++) {
+        values[thread].clear();
+        for (size_t m = starts[c]; m < starts[c + 1]; m++)
+          values[thread].emplace_back(points[members[m] * dim + d],
+                                      weights[members[m]]);
+        centers[c * dim + d] = weightedMedian(values[thread]);
+      }
+    });
+  }
+
+  // number the clusters by the mean of their centers
+  std::vector<size_t> order(k);
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<double> means(k);
+  for (size_t c = 0; c < k; c++)
+    means[c] = std::accumulate(centers.begin() + c * dim,
+                               centers.begin() + (c + 1) * dim, 0.0);
+  std::stable_sort(
+      order.begin(), order.end(),
+      [&means](size_t a, size_t b) { return means[a] < means[b]; });
+  std::vector<uint16_t> renumber(k);
+  m_centers.assign(k * dim, 0.0);
+  for (size_t c = 0; c < k; c++) {
+    renumber[order[c]] = static_cast<uint16_t>(c);
+    for (size_t d = 0; d < dim; d++)
+      m_centers[c * dim + d] = centers[order[c] * dim + d] / kScale;
+  }
+  for (uint16_t& a : assignment)
+    a = renumber[a];
+  return assignment;
+}
+
+}  // namespace nit
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_HISTOGRAM_CLUSTERING_H_
+#define NIT_ENUM_HISTOGRAM_CLUSTERING_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace nit {
+
+/**
+ * Weighted k-medians of one dimensional distributions under the earth
+ * mover's distance.  A point is a distribution given by its quantiles at
+ * evenly spaced probabilities, values in [0, 1] stored as 16 bit
+ * fractions.  In one dimension the earth mover's distance between two
+ * distributions is the mean distance between their quantiles, so it is
+ * the L1 distance of the points over the dimension.  The center with the
+ * least total L1 distance to the points of a cluster is the weighted
+ * median of their quantiles in each dimension, so the points and the
+ * centers are moved under the same distance, and the cost never grows.
+ *
+ * The centers are seeded with k-means++ on a sample of the points, and
+ * each iteration splits the points, then the clusters, over the threads.
+ */
+class HistogramClustering {
+ public:
+  HistogramClustering(size_t dimension, size_t clusters, size_t threads = 1);
+
+  /**
+   * cluster dimension quantiles per point, with a weight per point,
+   * moving the centers at most iterations times.  The points are
+   * assigned once more after the last move.
+   * @returns the cluster of each point, its nearest center, the clusters
+   *          are numbered by the mean of their centers, weakest first
+   */
+  std::vector<uint16_t> cluster(const std::vector<uint16_t>& points,
+                                const std::vector<float>& weights,
+                                size_t iterations, uint64_t seed = 0);
+
+  /// the centers by cluster, dimension values in [0, 1] each
+  const std::vector<double>& centers() const { return m_centers; }
+
+  /// the weighted mean distance of the points to their centers
+  double cost() const { return m_cost; }
+
+  /// @returns the earth mover's distance between two points
+  static double distance(const uint16_t* a, const uint16_t* b,
+                         size_t dimension);
+
+ private:
+  size_t m_dimension;
+  size_t m_clusters;
+  size_t m_threads;
+  std::vector<double> m_centers;
+  double m_cost;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_HISTOGRAM_CLUSTERING_H_
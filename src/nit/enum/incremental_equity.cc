@@ -0,0 +1,275 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "incremental_equity.h"
+
+#include <atomic>
+
+#include <nit/error.h>
+
+#include "dense_distribution.h"
+#include "distribution_walker.h"
+#include "showdown_enumerator.h"
+#include "showdown_visitor.h"
+
+namespace nit {
+
+namespace {
+
+// the bytes of each player of a tuple: the index of its hand, its shares,
+// and the tuple's place in the index by hand
+const size_t kBytesPerEntry = 2 * sizeof(uint32_t) + 2 * sizeof(double);
+
+}  // namespace
+
+const size_t IncrementalEquity::kDefaultMemoryLimit;
+
+/**
+ * Keeps the unit shares of every tuple of hands, in the storage reserved
+ * for them.  The deals of a tuple arrive together, and the enumeration is
+ * cancelled if there are more tuples than the storage holds.
+ */
+class IncrementalEquity::Recorder : public ShowdownVisitor {
+ public:
+  Recorder(IncrementalEquity& owner, std::atomic<bool>& cancel)
+      : m_owner(owner),
+        m_players(owner.m_dists.size()),
+        m_cancel(cancel),
+        m_overflow(false),
+        m_shares(m_players),
+        m_last(m_players) {}
+
+  void visit(const ShowdownBlock& block) override {
+    for (size_t d = 0; d < block.size() && !m_overflow; d++) {
+      bool same = m_owner.m_winShares.size() > 0;
+      for (size_t i = 0; same && i < m_players; i++)
+        same = block.hand(d, i) == m_last[i];
+      if (!same)
+        startTuple(block, d);
+      if (m_overflow)
+        return;
+
+      for (EquityResult& share : m_shares)
+        share = EquityResult();
+      PokerHandEvaluator::awardShowdown(block.evaluations(d), m_players,
+                                        m_shares, 1.0);
+      const size_t base = m_owner.m_winShares.size() - m_players;
+      for (size_t i = 0; i < m_players; i++) {
+        m_owner.m_winShares[base + i] += m_shares[i].winShares;
+        m_owner.m_tieShares[base + i] += m_shares[i].tieShares;
+      }
+    }
+  }
+
+  bool overflow() const { return m_overflow; }
+
+ private:
+  void startTuple(const ShowdownBlock& block, size_t d) {
+    if (m_owner.m_tuples.size() + m_players > m_owner.m_tuples.capacity()) {
+      m_overflow = true;
+      m_cancel = true;
+      return;
+    }
+    for (size_t i = 0; i < m_players; i++) {
+      m_last[i] = block.hand(d, i);
+      m_owner.m_tuples.push_back(m_owner.m_index[i].at(m_last[i].mask()));
+      m_owner.m_winShares.push_back(0.0);
+      m_owner.m_tieShares.push_back(0.0);
+    }
+  }
+
+  IncrementalEquity& m_owner;
+  size_t m_players;
+  std::atomic<bool>& m_cancel;
+  bool m_overflow;
+  std::vector<EquityResult> m_shares;  // of one deal
+  std::vector<CardSet> m_last;         // the hands of the current tuple
+};
+
+IncrementalEquity::IncrementalEquity(const std::vector<CardDistribution>& dists,
+                                     const CardSet& board,
+                                     const PokerHandEvaluator& peval,
+                                     size_t memoryLimit)
+    : m_dists(dists),
+      m_board(board),
+      m_peval(peval),
+      m_retained(true),
+      m_stale(false),
+      m_results(dists.size()),
+      m_hands(dists.size()),
+      m_weights(dists.size()),
+      m_index(dists.size()) {
+  if (dists.size() < 2)
+    throw InvalidArgument("an equity needs at least two players");
+
+  // every hand at weight one, so the shares of a tuple are its own
+  std::vector<CardDistribution> unit;
+  for (size_t p = 0; p < dists.size(); p++) {
+    const CardDistribution& dist = dists[p];
+    if (dist.size() == 0)
+      throw InvalidArgument("a player has no hands");
+    for (size_t h = 0; h < dist.size(); h++) {
+      const CardSet& hand = dist[h];
+      if (hand.size() != peval.handSize())
+        m_retained = false;
+      m_index[p][hand.mask()] = static_cast<uint32_t>(h);
+      m_hands[p].push_back(hand);
+      m_weights[p].push_back(dist[hand]);
+      if (unit.size() == p)
+        unit.emplace_back(hand);
+      else
+        unit[p].insert(hand);
+    }
+  }
+
+  // count the tuples first, and reserve the storage for them and their
+  // index by hand at once, if it fits in the limit
+  const size_t players = dists.size();
+  size_t ntuples = 0;
+  if (m_retained) {
+    std::vector<DenseDistribution> dense(unit.begin(), unit.end());
+    DistributionWalker walker(dense, board);
+    const size_t most = memoryLimit / (players * kBytesPerEntry);
+    while (m_retained && walker.next())
+      m_retained = ++ntuples <= most;
+  }
+
+  if (m_retained) {
+    m_tuples.reserve(ntuples * players);
+    m_winShares.reserve(ntuples * players);
+    m_tieShares.reserve(ntuples * players);
+    m_byHand.reserve(ntuples * players);
+    std::atomic<bool> cancel(false);
+    Recorder recorder(*this, cancel);
+    EnumerationOptions options;
+    options.pruneDecided = false;  // the shares are kept tuple by tuple
+    options.cancel = &cancel;
+    ShowdownEnumerator().visit(unit, board, peval, recorder, options);
+    if (recorder.overflow()) {
+      m_retained = false;
+      std::vector<uint32_t>().swap(m_tuples);
+      std::vector<double>().swap(m_winShares);
+      std::vector<double>().swap(m_tieShares);
+      std::vector<uint32_t>().swap(m_byHand);
+    }
+  }
+
+  if (m_retained) {
+    // index the tuples by each of their hands
+    ntuples = m_winShares.size() / players;
+    m_byHandStart.resize(players);
+    size_t start = 0;
+    for (size_t p = 0; p < players; p++) {
+      std::vector<size_t>& starts = m_byHandStart[p];
+      starts.assign(m_hands[p].size() + 1, 0);
+      for (size_t t = 0; t < ntuples; t++)
+        starts[m_tuples[t * players + p] + 1]++;
+      starts[0] = start;
+      for (size_t h = 0; h < m_hands[p].size(); h++)
+        starts[h + 1] += starts[h];
+      start = starts.back();
+    }
+    m_byHand.resize(start);
+    for (size_t p = 0; p < players; p++) {
+      std::vector<size_t> next(m_byHandStart[p].begin(),
+                               m_byHandStart[p].end() - 1);
+      for (size_t t = 0; t < ntuples; t++)
+        m_byHand[next[m_tuples[t * players + p]]++] =
+            static_cast<uint32_t>(t);
+    }
+  }
+  recompute();
+}
+
+void IncrementalEquity::recompute() {
+  const size_t players = m_dists.size();
+  for (EquityResult& result : m_results)
+    result = EquityResult();
+  m_stale = false;
+  if (m_retained) {
+    const size_t ntuples = m_winShares.size() / players;
+    for (size_t t = 0; t < ntuples; t++) {
+      double weight = 1.0;
+      for (size_t p = 0; p < players; p++)
+        weight *= m_weights[p][m_tuples[t * players + p]];
+      if (weight == 0.0)
+        continue;
+      for (size_t p = 0; p < players; p++) {
+        m_results[p].winShares += weight * m_winShares[t * players + p];
+        m_results[p].tieShares += weight * m_tieShares[t * players + p];
+      }
+    }
+    return;
+  }
+
+  // a range with no weight left has no deals
+  for (const CardDistribution& dist : m_dists)
+    if (dist.weight() <= 0.0)
+      return;
+  m_results = ShowdownEnumerator().calculateEquity(m_dists, m_board, m_peval);
+}
+
+const std::vector<EquityResult>& IncrementalEquity::results() {
+  if (m_stale)
+    recompute();
+  return m_results;
+}
+
+void IncrementalEquity::setWeight(size_t player, const CardSet& hand,
+                                  double weight) {
+  if (player >= m_dists.size())
+    throw InvalidArgument("there is no such player")
+        << errinfo_value(std::to_string(player));
+  auto found = m_index[player].find(hand.mask());
+  if (found == m_index[player].end())
+    throw InvalidArgument("the hand is not in the player's range")
+        << errinfo_value(hand.str());
+  const size_t h = found->second;
+  const double delta = weight - m_weights[player][h];
+  m_weights[player][h] = weight;
+  m_dists[player][hand] = weight;
+  if (delta == 0.0)
+    return;
+  if (!m_retained) {
+    m_stale = true;
+    return;
+  }
+
+  // only the tuples with the hand change
+  const size_t players = m_dists.size();
+  const std::vector<size_t>& starts = m_byHandStart[player];
+  for (size_t k = starts[h]; k < starts[h + 1]; k++) {
+    const size_t base = m_byHand[k] * players;
+    double others = delta;
+    for (size_t p = 0; p < players; p++)
+      if (p != player)
+        others *= m_weights[p][m_tuples[base + p]];
+    if (others == 0.0)
+      continue;
+    for (size_t p = 0; p < players; p++) {
+      m_results[p].winShares += others * m_winShares[base + p];
+      m_results[p].tieShares += others * m_tieShares[base + p];
+    }
+  }
+}
+
+void IncrementalEquity::setWeights(size_t player,
+                                   const CardDistribution& dist) {
+  if (player >= m_dists.size())
+    throw InvalidArgument("there is no such player")
+        << errinfo_value(std::to_string(player));
+  for (size_t h = 0; h < dist.size(); h++)
+    if (m_index[player].count(dist[h].mask()) == 0)
+      throw InvalidArgument("the hand is not in the player's range")
+          << errinfo_value(dist[h].str());
+  for (const CardSet& hand : m_hands[player])
+    setWeight(player, hand, dist[hand]);
+}
+
+size_t IncrementalEquity::memoryUsage() const {
+  return m_tuples.capacity() * sizeof(uint32_t) +
+         (m_winShares.capacity() + m_tieShares.capacity()) * sizeof(double) +
+         m_byHand.capacity() * sizeof(uint32_t);
+}
+
+}  // namespace nit
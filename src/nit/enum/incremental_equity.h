@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_INCREMENTAL_EQUITY_H_
+#define NIT_ENUM_INCREMENTAL_EQUITY_H_
+
+#include <cstdint>
+
+#include <unordered_map>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "card_distribution.h"
+
+namespace nit {
+
+/**
+ * The equity of a query kept up to date as the weights of its ranges
+ * change, as in a range editor.
+ *
+ * The shares are linear in the weight of each player's hands, so the
+ * query is enumerated once with every hand at weight one, and the shares
+ * of each tuple of hands are kept.  The results are the sum over the
+ * tuples of the shares times the product of the weights, and a new
+ * weight for a hand adds the difference times the shares of just the
+ * tuples with that hand: the time is proportional to those tuples, not
+ * to the whole enumeration.  Hands can be given weight zero and back.
+ *
+ * The tuples are counted before the enumeration, and kept along with
+ * their index by hand if they fit in memoryLimit bytes, which are then
+ * reserved in one go.  A query with more of them, or with ranges which
+ * are not complete hands, is not retained, and the results are
+ * enumerated again with the new weights when they are next asked for.
+ * The results are the same either way, up to rounding.
+ */
+class IncrementalEquity {
+ public:
+  static const size_t kDefaultMemoryLimit = size_t(256) << 20;
+
+  /**
+   * enumerate the query with every hand at weight one.  The evaluator is
+   * kept by reference, to enumerate again a query which is not retained,
+   * so it must outlive the IncrementalEquity.
+   */
+  IncrementalEquity(const std::vector<CardDistribution>& dists,
+                    const CardSet& board, const PokerHandEvaluator& peval,
+                    size_t memoryLimit = kDefaultMemoryLimit);
+
+  /// @returns the shares of each player with the current weights
+  const std::vector<EquityResult>& results();
+
+  /**
+   * set the weight of one of a player's hands, throws InvalidArgument if
+   * it was not in the player's range
+   */
+  void setWeight(size_t player, const CardSet& hand, double weight);
+
+  /**
+   * take the weights of a player's range from dist, the hands it leaves
+   * out get weight zero.  Throws InvalidArgument if it has a hand which
+   * was not in the range.
+   */
+  void setWeights(size_t player, const CardDistribution& dist);
+
+  /// @returns the current range of a player
+  const CardDistribution& range(size_t player) const {
+    return m_dists[player];
+  }
+
+  /// whether the shares of the tuples are kept
+  bool retained() const { return m_retained; }
+
+  /// @returns the bytes held by the shares of the tuples
+  size_t memoryUsage() const;
+
+ private:
+  class Recorder;
+
+  void enumerate();
+  void recompute();
+
+  std::vector<CardDistribution> m_dists;
+  CardSet m_board;
+  const PokerHandEvaluator& m_peval;
+  bool m_retained;
+  bool m_stale;  // the results need enumerating again
+  std::vector<EquityResult> m_results;
+
+  // the hands of each player by index, and their weights
+  std::vector<std::vector<CardSet>> m_hands;
+  std::vector<std::vector<double>> m_weights;
+  std::vector<std::unordered_map<uint64_t, uint32_t>> m_index;
+
+  // the tuples: the index of each player's hand, and the unit shares
+  std::vector<uint32_t> m_tuples;    // [tuple * players + player]
+  std::vector<double> m_winShares;   // [tuple * players + player]
+  std::vector<double> m_tieShares;   // [tuple * players + player]
+  std::vector<uint32_t> m_byHand;    // the tuples of each hand, by player
+  std::vector<std::vector<size_t>> m_byHandStart;  // [player][hand]
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_INCREMENTAL_EQUITY_H_
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "mapped_table.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <nit/error.h>
+
+namespace nit {
+
+struct MappedTable::Mapping {
+  boost::interprocess::file_mapping file;
+  boost::interprocess::mapped_region region;
+};
+
+MappedTable::MappedTable(const std::string& path, const char (&magic)[8],
+                         const std::string& what)
+    : m_mapping(new Mapping),
+      m_path(path),
+      m_what(what),
+      m_data(nullptr),
+      m_size(0) {
+  namespace bip = boost::interprocess;
+  try {
+    m_mapping->file = bip::file_mapping(path.c_str(), bip::read_only);
+    m_mapping->region = bip::mapped_region(m_mapping->file, bip::read_only);
+  } catch (const bip::interprocess_exception&) {
+    throw InvalidArgument("could not map " + what) << errinfo_value(path);
+  }
+  m_data = static_cast<const char*>(m_mapping->region.get_address());
+  m_size = m_mapping->region.get_size();
+  if (m_size < sizeof(magic) || std::memcmp(m_data, magic, sizeof(magic)) != 0)
+    reject();
+}
+
+MappedTable::~MappedTable() = default;
+
+void MappedTable::reject() const {
+  throw InvalidArgument("not " + m_what) << errinfo_value(m_path);
+}
+
+void TableWriter::finish() {
+  m_out.flush();
+  if (!m_out)
+    throw InvalidArgument("could not write " + m_what)
+        << errinfo_value(m_path);
+}
+
+}  // namespace nit
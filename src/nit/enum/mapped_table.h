@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_MAPPED_TABLE_H_
+#define NIT_ENUM_MAPPED_TABLE_H_
+
+#include <cstring>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nit {
+
+/**
+ * A table file mapped into memory, read only.  A table file is a header
+ * which starts with an eight byte magic, followed by the entries, all in
+ * the byte order of the machine.  The mapping checks the magic, and the
+ * table checks the rest of its header and the size of its entries.
+ *
+ * The errors name the kind of table, what, as in "an omaha table".
+ */
+class MappedTable {
+ public:
+  /**
+   * map the table at path, throws InvalidArgument if it can not be
+   * mapped or does not start with magic
+   */
+  MappedTable(const std::string& path, const char (&magic)[8],
+              const std::string& what);
+  ~MappedTable();
+
+  /// @returns a copy of the header, throws InvalidArgument if it is short
+  template <class Header>
+  Header header() const {
+    Header header;
+    if (m_size < sizeof(header))
+      reject();
+    std::memcpy(&header, m_data, sizeof(header));
+    return header;
+  }
+
+  /**
+   * @returns the entries after the header, throws InvalidArgument unless
+   * there are exactly count of them
+   */
+  template <class Header, class Entry>
+  const Entry* entries(size_t count) const {
+    if (m_size != sizeof(Header) + count * sizeof(Entry))
+      reject();
+    return reinterpret_cast<const Entry*>(m_data + sizeof(Header));
+  }
+
+  /// throws InvalidArgument, the file is not the table expected
+  [[noreturn]] void reject() const;
+
+ private:
+  struct Mapping;
+
+  std::unique_ptr<Mapping> m_mapping;
+  std::string m_path;
+  std::string m_what;
+  const char* m_data;
+  size_t m_size;
+};
+
+/**
+ * Writes a table file, the header and then the entries, in as many parts
+ * as it takes.  finish throws InvalidArgument if any of it could not be
+ * written.
+ */
+class TableWriter {
+ public:
+  template <class Header>
+  TableWriter(const std::string& path, const Header& header,
+              const std::string& what)
+      : m_out(path, std::ios::binary | std::ios::trunc),
+        m_path(path),
+        m_what(what) {
+    m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+
+  template <class Entry>
+  void write(const std::vector<Entry>& entries) {
+    m_out.write(reinterpret_cast<const char*>(entries.data()),
+                static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+  }
+
+  /// @returns false once a write has failed
+  bool good() const { return static_cast<bool>(m_out); }
+
+  void finish();
+
+ private:
+  std::ofstream m_out;
+  std::string m_path;
+  std::string m_what;
+};
+
+/// write a table with all of its entries at once
+template <class Header, class Entry>
+void writeTable(const std::string& path, const Header& header,
+                const std::vector<Entry>& entries, const std::string& what) {
+  TableWriter writer(path, header, what);
+  writer.write(entries);
+  writer.finish();
+}
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_MAPPED_TABLE_H_
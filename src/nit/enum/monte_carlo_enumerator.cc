@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "monte_carlo_enumerator.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <random>
+
+#include <nit/error.h>
+
+namespace nit {
+
+namespace {
+
+/// give up on a query after this many conflicting draws in a row
+const uint64_t kMaxRejections = 1000000;
+
+}  // namespace
+
+MonteCarloEnumerator::MonteCarloEnumerator(uint64_t seed) : m_seed(seed) {}
+
+SampledEquity MonteCarloEnumerator::calculateEquity(
+    const std::vector<DenseDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, uint64_t samples) const {
+  const size_t ndists = dists.size();
+  if (ndists < 2)
+    throw InvalidArgument("equity needs at least two players");
+
+  // the cumulative weights of each distribution, for drawing by weight
+  std::vector<std::vector<double>> cumulative(ndists);
+  for (size_t i = 0; i < ndists; i++) {
+    double sum = 0.0;
+    for (double weight : dists[i].weights())
+      cumulative[i].push_back(sum += weight);
+    if (cumulative[i].empty())
+      throw InvalidArgument("a distribution has no hands");
+  }
+
+  std::mt19937_64 rng(m_seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const size_t boardsize = peval.boardSize();
+
+  // the hands, followed by the board
+  std::vector<CardSet> hands(ndists + 1);
+  std::vector<PokerHandEvaluation> evals(ndists);
+  std::vector<EquityResult> shares(ndists);
+  std::vector<double> sum(ndists, 0.0);
+  std::vector<double> sumsq(ndists, 0.0);
+  std::vector<size_t> live;
+
+  SampledEquity sampled;
+  sampled.results.resize(ndists);
+  for (uint64_t s = 0; s < samples; s++) {
+    // draw a tuple of hands which share no cards
+    uint64_t dead = 0;
+    for (uint64_t rejections = 0;; rejections++) {
+      if (rejections == kMaxRejections)
+        throw InvalidArgument("the distributions have no deal without "
+                              "card conflicts");
+      dead = board.mask();
+      size_t i = 0;
+      for (; i < ndists; i++) {
+        const std::vector<double>& cum = cumulative[i];
+        double x = uniform(rng) * cum.back();
+        size_t j = std::upper_bound(cum.begin(), cum.end(), x) - cum.begin();
+        j = std::min(j, cum.size() - 1);
+        uint64_t mask = dists[i].mask(j);
+        if (mask & dead)
+          break;
+        dead |= mask;
+        hands[i] = CardSet(mask);
+      }
+      if (i == ndists)
+        break;
+    }
+
+    // deal the rest of the cards with a partial shuffle of the live cards
+    live.clear();
+    for (size_t c = 0; c < STANDARD_DECK_SIZE; c++)
+      if (!(dead & UINT64_C(1) << c))
+        live.push_back(c);
+    size_t next = 0;
+    auto deal = [&](CardSet& cards, size_t ncards) {
+      while (cards.size() < ncards) {
+        std::uniform_int_distribution<size_t> pick(next, live.size() - 1);
+        std::swap(live[next], live[pick(rng)]);
+        cards |= CardSet(UINT64_C(1) << live[next++]);
+      }
+    };
+    for (size_t i = 0; i < ndists; i++)
+      deal(hands[i], peval.handSize());
+    hands[ndists] = board;
+    deal(hands[ndists], boardsize);
+
+    std::fill(shares.begin(), shares.end(), EquityResult());
+    peval.evaluateShowdown(hands, hands[ndists], evals, shares);
+    for (size_t i = 0; i < ndists; i++) {
+      double x = shares[i].winShares + shares[i].tieShares;
+      sum[i] += x;
+      sumsq[i] += x * x;
+      sampled.results[i] += shares[i];
+    }
+  }
+
+  sampled.samples = samples;
+  if (samples > 1) {
+    const double n = static_cast<double>(samples);
+    for (size_t i = 0; i < ndists; i++) {
+      double mean = sum[i] / n;
+      double variance = std::max(0.0, sumsq[i] / n - mean * mean);
+      sampled.errorBound =
+          std::max(sampled.errorBound, 1.96 * std::sqrt(variance / (n - 1)));
+    }
+  }
+  return sampled;
+}
+
+}  // namespace nit
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_MONTE_CARLO_ENUMERATOR_H_
+#define NIT_ENUM_MONTE_CARLO_ENUMERATOR_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "dense_distribution.h"
+
+namespace nit {
+
+/**
+ * Equity estimated from random deals.  The shares are summed over the
+ * samples, so the shares of all players add up to the number of samples,
+ * and the equity of a player is its shares over the samples.
+ */
+struct SampledEquity {
+  std::vector<EquityResult> results;
+  uint64_t samples{0};
+  double errorBound{0.0};  ///< the largest 95% half width of an equity
+};
+
+/**
+ * An estimator which samples deals instead of enumerating them.  A tuple
+ * of hands is drawn with a probability proportional to the product of
+ * the weights, redrawing on card conflicts, and the rest of the hands and
+ * the board are dealt from the remaining cards.  When all entries of a
+ * distribution hold the same number of cards, the estimate converges to
+ * the equity of ShowdownEnumerator::calculateEquity.
+ *
+ * The generator is seeded explicitly, so runs are reproducible.
+ */
+class MonteCarloEnumerator {
+ public:
+  explicit MonteCarloEnumerator(uint64_t seed = 0);
+
+  SampledEquity calculateEquity(const std::vector<DenseDistribution>& dists,
+                                const CardSet& board,
+                                const PokerHandEvaluator& peval,
+                                uint64_t samples) const;
+
+ private:
+  uint64_t m_seed;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_MONTE_CARLO_ENUMERATOR_H_
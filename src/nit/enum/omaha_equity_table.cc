@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "omaha_equity_table.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <random>
+
+#include <nit/error.h>
+
+namespace nit {
+
+namespace {
+
+const char kMagic[8] = {'n', 'i', 't', '-', 'o', 'm', '0', '1'};
+
+struct Header {
+  char magic[8];
+  uint32_t game;
+  uint32_t count;
+  uint64_t samples;
+  double errorBound;
+};
+
+/// @returns the share of a pot of the first of two evaluations
+double share(const PokerEvaluation& a, const PokerEvaluation& b) {
+  return a > b ? 1.0 : a == b ? 0.5 : 0.0;
+}
+
+}  // namespace
+
+const size_t OmahaEquityTable::kClasses;
+
+OmahaEquityTable::OmahaEquityTable(const std::string& path)
+    : m_table(path, kMagic, "an omaha table"),
+      m_entries(nullptr),
+      m_game(0),
+      m_samples(0),
+      m_errorBound(0.0) {
+  const Header header = m_table.header<Header>();
+  if (header.count != kClasses)
+    m_table.reject();
+  m_entries = m_table.entries<Header, OmahaClassEquity>(kClasses);
+  // the entries are looked up by a binary search on their hands
+  for (size_t i = 1; i < kClasses; i++)
+    if (m_entries[i - 1].hand >= m_entries[i].hand)
+      m_table.reject();
+  m_game = static_cast<char>(header.game);
+  m_samples = header.samples;
+  m_errorBound = header.errorBound;
+}
+
+const OmahaClassEquity& OmahaEquityTable::get(const CardSet& hand) const {
+  if (hand.size() != 4 || (hand.mask() >> STANDARD_DECK_SIZE) != 0)
+    throw InvalidArgument("an omaha hand has four cards")
+        << errinfo_value(hand.str());
+  const uint64_t canonical = hand.canonize().mask();
+  const OmahaClassEquity* entry = std::lower_bound(
+      m_entries, m_entries + kClasses, canonical,
+      [](const OmahaClassEquity& e, uint64_t h) { return e.hand < h; });
+  if (entry == m_entries + kClasses || entry->hand != canonical)
+    throw InvalidArgument("the omaha table has no entry for the hand")
+        << errinfo_value(hand.str());
+  return *entry;
+}
+
+const std::vector<uint64_t>& OmahaEquityTable::classes() {
+  static const std::vector<uint64_t> hands = [] {
+    std::vector<uint64_t> canonical;
+    const size_t n = STANDARD_DECK_SIZE;
+    for (size_t a = 0; a < n; a++)
+      for (size_t b = a + 1; b < n; b++)
+        for (size_t c = b + 1; c < n; c++)
+          for (size_t d = c + 1; d < n; d++)
+            canonical.push_back(
+                CardSet(UINT64_C(1) << a | UINT64_C(1) << b |
+                        UINT64_C(1) << c | UINT64_C(1) << d)
+                    .canonize()
+                    .mask());
+    std::sort(canonical.begin(), canonical.end());
+    canonical.erase(std::unique(canonical.begin(), canonical.end()),
+                    canonical.end());
+    return canonical;
+  }();
+  return hands;
+}
+
+size_t OmahaEquityTable::classIndex(const CardSet& hand) {
+  if (hand.size() != 4 || (hand.mask() >> STANDARD_DECK_SIZE) != 0)
+    throw InvalidArgument("an omaha hand has four cards")
+        << errinfo_value(hand.str());
+  const std::vector<uint64_t>& hands = classes();
+  return std::lower_bound(hands.begin(), hands.end(), hand.canonize().mask()) -
+         hands.begin();
+}
+
+OmahaClassEquity OmahaEquityTable::sample(const PokerHandEvaluator& peval,
+                                          const CardSet& hand,
+                                          uint64_t samples, uint64_t seed,
+                                          double& bound) {
+  OmahaClassEquity entry;
+  entry.hand = hand.canonize().mask();
+  std::vector<size_t> live;
+  for (size_t c = 0; c < STANDARD_DECK_SIZE; c++)
+    if (!(hand.mask() & UINT64_C(1) << c))
+      live.push_back(c);
+
+  std::mt19937_64 rng(seed);
+  double equity = 0.0, equitysq = 0.0, scoop = 0.0, high = 0.0, low = 0.0;
+  for (uint64_t s = 0; s < samples; s++) {
+    // the villain's hand and the board from a partial shuffle
+    CardSet villain, board;
+    for (size_t c = 0; c < 9; c++) {
+      std::uniform_int_distribution<size_t> pick(c, live.size() - 1);
+      std::swap(live[c], live[pick(rng)]);
+      (c < 4 ? villain : board) |= CardSet(UINT64_C(1) << live[c]);
+    }
+    PokerHandEvaluation hero = peval.evaluateHand(hand, board);
+    PokerHandEvaluation other = peval.evaluateHand(villain, board);
+    double hi = share(hero.high(), other.high());
+    double x = hi;
+    if (hero.low() > PokerEvaluation(0) || other.low() > PokerEvaluation(0)) {
+      double lo = share(hero.low(), other.low());
+      low += lo;
+      x = (hi + lo) / 2.0;
+    }
+    high += hi;
+    equity += x;
+    equitysq += x * x;
+    scoop += x == 1.0 ? 1.0 : 0.0;
+  }
+
+  const double n = static_cast<double>(samples);
+  entry.equity = static_cast<float>(equity / n);
+  entry.scoop = static_cast<float>(scoop / n);
+  entry.high = static_cast<float>(high / n);
+  entry.low = static_cast<float>(low / n);
+  double mean = equity / n;
+  double variance = std::max(0.0, equitysq / n - mean * mean);
+  bound = samples > 1 ? 1.96 * std::sqrt(variance / (n - 1)) : 1.0;
+  return entry;
+}
+
+void OmahaEquityTable::write(const std::string& path, char game,
+                             uint64_t samples, double errorBound,
+                             const std::vector<OmahaClassEquity>& entries) {
+  if (entries.size() != kClasses)
+    throw InvalidArgument("an omaha table has an entry for every class");
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.game = static_cast<uint32_t>(game);
+  header.count = static_cast<uint32_t>(entries.size());
+  header.samples = samples;
+  header.errorBound = errorBound;
+  writeTable(path, header, entries, "an omaha table");
+}
+
+}  // namespace nit
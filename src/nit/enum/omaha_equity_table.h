@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_OMAHA_EQUITY_TABLE_H_
+#define NIT_ENUM_OMAHA_EQUITY_TABLE_H_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "mapped_table.h"
+
+namespace nit {
+
+/**
+ * The equity of an omaha starting hand against a random hand, and for
+ * omaha/8 how it comes about.  Each number is the mean over the deals:
+ * equity is the share of the pot, scoop the chance of taking all of it,
+ * high and low the shares of the high and the low half, a low share is
+ * 0 on the boards without a low.  In omaha high, high is the equity and
+ * low is 0.
+ */
+struct OmahaClassEquity {
+  uint64_t hand{0};  ///< the canonical hand of the class
+  float equity{0.0f};
+  float scoop{0.0f};
+  float high{0.0f};
+  float low{0.0f};
+};
+
+/**
+ * The equity of every omaha starting hand against a random hand, read
+ * from a table of the suit isomorphic classes.  The 270725 hands come
+ * down to 16432 classes by CardSet::canonize, the index of a class is
+ * the rank of its canonical hand among them.  Computing these with the
+ * omaha evaluators at query time is slow, so the table is sampled once
+ * by nit-omaha, and mapped into memory.  A hand is looked up by a binary
+ * search of its canonical hand among those of the entries.
+ *
+ * The file is a header, "nit-om01", the game and the number of entries
+ * as 32 bits, the samples per class as 64 bits and the largest 95% half
+ * width of an equity as a double, followed by the entries in the order
+ * of the classes, in the byte order of the machine.
+ */
+class OmahaEquityTable {
+ public:
+  static const size_t kClasses = 16432;
+
+  /// map the table at path, throws InvalidArgument if it is not one
+  explicit OmahaEquityTable(const std::string& path);
+
+  char game() const { return m_game; }  //!< 'O' for high, 'o' for high low
+  uint64_t samples() const { return m_samples; }  //!< per class
+  double errorBound() const { return m_errorBound; }
+
+  /**
+   * @returns the entry of the class of a four card hand, throws
+   * InvalidArgument if it is not one
+   */
+  const OmahaClassEquity& get(const CardSet& hand) const;
+
+  /// @returns the canonical hands of all the classes, in index order
+  static const std::vector<uint64_t>& classes();
+
+  /// @returns the index of the class of a four card hand
+  static size_t classIndex(const CardSet& hand);
+
+  /**
+   * sample the deals of a hand against a random hand, with the omaha
+   * ('O') or omaha/8 ('o') evaluator.  Sets bound to the 95% half width
+   * of the equity.
+   */
+  static OmahaClassEquity sample(const PokerHandEvaluator& peval,
+                                 const CardSet& hand, uint64_t samples,
+                                 uint64_t seed, double& bound);
+
+  /// write a table, with one entry per class in index order
+  static void write(const std::string& path, char game, uint64_t samples,
+                    double errorBound,
+                    const std::vector<OmahaClassEquity>& entries);
+
+ private:
+  MappedTable m_table;
+  const OmahaClassEquity* m_entries;
+  char m_game;
+  uint64_t m_samples;
+  double m_errorBound;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_OMAHA_EQUITY_TABLE_H_
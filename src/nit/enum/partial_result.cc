@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "partial_result.h"
+
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace nit {
+
+namespace {
+
+const char* const kMagic = "nit-partial";
+const int kVersion = 1;
+
+UInt128 readCount(std::istream& in, const std::string& line) {
+  std::string word;
+  UInt128 value;
+  if (!(in >> word) || !UInt128::parse(word, value))
+    throw ParseError("bad count in partial result") << errinfo_value(line);
+  return value;
+}
+
+}  // namespace
+
+void PartialResult::write(std::ostream& out) const {
+  out << kMagic << " " << kVersion << "\n";
+  out << "game " << game << "\n";
+  out << "board " << board << "\n";
+  out << "shard " << shard.index << " " << shard.count << "\n";
+  for (const std::string& hand : hands)
+    out << "hand " << hand << "\n";
+  for (const ExactEquityResult& result : results)
+    out << "result " << result.str() << "\n";
+}
+
+PartialResult PartialResult::read(std::istream& in) {
+  PartialResult partial;
+  std::string line;
+  if (!std::getline(in, line) ||
+      line != kMagic + std::string(" ") + std::to_string(kVersion))
+    throw ParseError("not a partial result") << errinfo_value(line);
+
+  while (std::getline(in, line)) {
+    if (line.empty())
+      continue;
+    size_t space = line.find(' ');
+    std::string key = line.substr(0, space);
+    std::string value = space == std::string::npos ? "" : line.substr(space + 1);
+    std::istringstream fields(value);
+    if (key == "game") {
+      partial.game = value;
+    } else if (key == "board") {
+      partial.board = value;
+    } else if (key == "hand") {
+      partial.hands.push_back(value);
+    } else if (key == "shard") {
+      if (!(fields >> partial.shard.index >> partial.shard.count) ||
+          partial.shard.index >= partial.shard.count)
+        throw ParseError("bad shard in partial result") << errinfo_value(line);
+    } else if (key == "result") {
+      ExactEquityResult result;
+      result.winShares = readCount(fields, line);
+      result.tieShares = readCount(fields, line);
+      if (!(fields >> result.scale) || result.scale == 0)
+        throw ParseError("bad scale in partial result") << errinfo_value(line);
+      partial.results.push_back(result);
+    } else {
+      throw ParseError("unknown line in partial result") << errinfo_value(line);
+    }
+  }
+  return partial;
+}
+
+PartialResult mergePartialResults(const std::vector<PartialResult>& partials) {
+  if (partials.empty())
+    throw InvalidArgument("no partial results to merge");
+  const PartialResult& head = partials.front();
+  PartialResult merged = head;
+  merged.shard = Shard();
+  for (ExactEquityResult& result : merged.results) {
+    result.winShares = UInt128();
+    result.tieShares = UInt128();
+  }
+
+  std::vector<bool> seen(head.shard.count, false);
+  for (const PartialResult& partial : partials) {
+    if (partial.game != head.game || partial.board != head.board ||
+        partial.hands != head.hands || partial.shard.count != head.shard.count ||
+        partial.results.size() != head.results.size())
+      throw InvalidArgument("partial results are for different queries");
+    if (seen[partial.shard.index])
+      throw InvalidArgument("shard is given twice")
+          << errinfo_value(partial.shard.str());
+    seen[partial.shard.index] = true;
+    for (size_t i = 0; i < partial.results.size(); i++) {
+      if (partial.results[i].scale != merged.results[i].scale)
+        throw InvalidArgument("partial results have different scales");
+      merged.results[i] += partial.results[i];
+    }
+  }
+  for (size_t i = 0; i < seen.size(); i++)
+    if (!seen[i])
+      throw InvalidArgument("shard is missing")
+          << errinfo_value(Shard(i, seen.size()).str());
+  return merged;
+}
+
+}  // namespace nit
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_PARTIAL_RESULT_H_
+#define NIT_ENUM_PARTIAL_RESULT_H_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "enumeration_options.h"
+
+namespace nit {
+
+/**
+ * The exact result of one shard of an enumeration, along with the query
+ * it answers, so that the partial results written by separate processes
+ * can be checked against each other and merged.
+ *
+ * The text format is one "key value" pair per line:
+ *
+ *   nit-partial 1
+ *   game h
+ *   board 2c7cTd
+ *   shard 0 4
+ *   hand AcKc
+ *   hand QdQh
+ *   result <win> <tie> <scale>
+ *   result <win> <tie> <scale>
+ *
+ * with one result line per player, including any random players which
+ * have no hand line.
+ */
+struct PartialResult {
+  std::string game;
+  std::string board;
+  std::vector<std::string> hands;
+  Shard shard;
+  std::vector<ExactEquityResult> results;
+
+  void write(std::ostream& out) const;
+
+  /// read a partial result, throws ParseError on malformed input
+  static PartialResult read(std::istream& in);
+};
+
+/**
+ * merge the partial results of every shard of one query.  Throws
+ * InvalidArgument if the partials are for different queries, or if some
+ * shard is missing or given twice.
+ */
+PartialResult mergePartialResults(const std::vector<PartialResult>& partials);
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_PARTIAL_RESULT_H_
@@ -11,7 +11,9 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <nit/error.h>
 #include <nit/util/combinations.h>
+#include <nit/util/uint128.h>
 
 namespace nit {
 
@@ -126,6 +128,54 @@ class PartitionEnumerator2 {
 
   bool next() { return incr(); }
 
+  /**
+   * the number of partitions of a set of setSize elements into parts of
+   * the given sizes, which is the number of steps of a full enumeration.
+   * Throws DomainError if the count does not fit in 64 bits.
+   */
+  static uint64_t count(size_t setSize, const std::vector<size_t>& partitions) {
+    uint64_t ret = 1;
+    size_t left = setSize;
+    for (size_t part : partitions) {
+      if (part > left)
+        return 0;
+      UInt128 product = UInt128::multiply(ret, choose(left, part));
+      if (product.hi != 0)
+        throw DomainError("too many partitions to count");
+      ret = product.lo;
+      left -= part;
+    }
+    return ret;
+  }
+
+  /**
+   * jump to the partition which next() reaches after rank steps from the
+   * first partition.  The parts are the digits of a mixed radix number,
+   * with the last part the least significant.
+   */
+  void seek(uint64_t rank) {
+    std::vector<uint64_t> digits(numParts());
+    for (size_t p = numParts(); p-- > 0;) {
+      uint64_t radix = choose(m_subsets[p].size(), m_parts[p]);
+      digits[p] = rank % radix;
+      rank /= radix;
+    }
+    for (size_t p = 0; p < numParts(); p++) {
+      setup(static_cast<int>(p));
+      m_pcombos[p].seek(digits[p]);
+      makeMask(p);
+    }
+  }
+
+  /// @returns the number of steps from the first partition to this one
+  uint64_t rank() const {
+    uint64_t ret = 0;
+    for (size_t p = 0; p < numParts(); p++)
+      ret = ret * choose(m_subsets[p].size(), m_parts[p]) +
+            m_pcombos[p].rank();
+    return ret;
+  }
+
  private:
   size_t m_setSize;
   std::vector<size_t> m_parts;
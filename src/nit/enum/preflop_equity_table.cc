@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "preflop_equity_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <nit/error.h>
+#include <nit/util/lastbit.h>
+
+#include "dense_distribution.h"
+
+namespace nit {
+
+namespace {
+
+const char kMagic[8] = {'n', 'i', 't', '-', 'p', 'f', '0', '1'};
+
+const size_t kHands = 1326;   // two card hands
+const size_t kPerms = 24;     // ways to rename the suits
+const uint32_t kBoards = 1712304;  // choose(48, 5)
+
+struct Header {
+  char magic[8];
+  uint32_t count;
+  uint32_t boards;
+};
+
+/// @returns the colex index of a two card hand
+size_t handIndex(uint64_t mask) {
+  size_t lo = static_cast<size_t>(lastbit(mask));
+  size_t hi = static_cast<size_t>(lastbit(mask & (mask - 1)));
+  return hi * (hi - 1) / 2 + lo;
+}
+
+/**
+ * The hands by index, and the index of each hand under every renaming
+ * of the suits, so a key is a few dozen lookups.
+ */
+struct HandTables {
+  uint64_t masks[kHands];
+  uint16_t renamed[kHands][kPerms];
+
+  HandTables() {
+    for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++)
+      for (size_t lo = 0; lo < hi; lo++)
+        masks[hi * (hi - 1) / 2 + lo] =
+            (UINT64_C(1) << hi) | (UINT64_C(1) << lo);
+    int perm[Suit::NUM_SUIT] = {0, 1, 2, 3};
+    for (size_t p = 0; p < kPerms; p++) {
+      for (size_t h = 0; h < kHands; h++) {
+        CardSet hand = CardSet(masks[h]).rotateSuits(perm[0], perm[1],
+                                                     perm[2], perm[3]);
+        renamed[h][p] = static_cast<uint16_t>(handIndex(hand.mask()));
+      }
+      std::next_permutation(perm, perm + Suit::NUM_SUIT);
+    }
+  }
+};
+
+const HandTables& handTables() {
+  static const HandTables tables;
+  return tables;
+}
+
+/// @returns the key of two hands given by index
+uint32_t matchupKey(size_t a, size_t b, bool& swapped) {
+  const HandTables& tables = handTables();
+  uint32_t best = UINT32_MAX;
+  for (size_t p = 0; p < kPerms; p++) {
+    uint32_t ra = tables.renamed[a][p];
+    uint32_t rb = tables.renamed[b][p];
+    uint32_t forward = ra * kHands + rb;
+    uint32_t backward = rb * kHands + ra;
+    if (forward < best) {
+      best = forward;
+      swapped = false;
+    }
+    if (backward < best) {
+      best = backward;
+      swapped = true;
+    }
+  }
+  return best;
+}
+
+void checkHand(const CardSet& hand) {
+  if (hand.size() != 2 || (hand.mask() >> STANDARD_DECK_SIZE) != 0)
+    throw InvalidArgument("the preflop table needs two card hands")
+        << errinfo_value(hand.str());
+}
+
+}  // namespace
+
+PreflopEquityTable::PreflopEquityTable(const std::string& path)
+    : m_table(path, kMagic, "a preflop table"), m_entries(nullptr), m_size(0) {
+  const Header header = m_table.header<Header>();
+  if (header.boards != kBoards)
+    m_table.reject();
+  m_entries = m_table.entries<Header, PreflopMatchup>(header.count);
+  m_size = header.count;
+}
+
+const PreflopMatchup* PreflopEquityTable::find(uint32_t key) const {
+  const PreflopMatchup* end = m_entries + m_size;
+  const PreflopMatchup* it = std::lower_bound(
+      m_entries, end, key,
+      [](const PreflopMatchup& entry, uint32_t k) { return entry.key < k; });
+  return it != end && it->key == key ? it : nullptr;
+}
+
+std::vector<EquityResult> PreflopEquityTable::calculateEquity(
+    const CardSet& a, const CardSet& b) const {
+  checkHand(a);
+  checkHand(b);
+  if (a.mask() & b.mask())
+    throw InvalidArgument("the hands share a card")
+        << errinfo_value(a.str() + " " + b.str());
+  bool swapped = false;
+  const PreflopMatchup* entry =
+      find(matchupKey(handIndex(a.mask()), handIndex(b.mask()), swapped));
+  if (!entry)
+    throw DomainError("the preflop table has no entry for the matchup")
+        << errinfo_value(a.str() + " " + b.str());
+  std::vector<EquityResult> results(2);
+  results[0].winShares = swapped ? entry->losses : entry->wins;
+  results[1].winShares = swapped ? entry->wins : entry->losses;
+  results[0].tieShares = results[1].tieShares = entry->ties / 2.0;
+  return results;
+}
+
+std::vector<EquityResult> PreflopEquityTable::calculateEquity(
+    const CardDistribution& a, const CardDistribution& b) const {
+  DenseDistribution da(a);
+  DenseDistribution db(b);
+  for (uint64_t mask : da.masks())
+    checkHand(CardSet(mask));
+  for (uint64_t mask : db.masks())
+    checkHand(CardSet(mask));
+
+  std::vector<EquityResult> results(2);
+  for (size_t i = 0; i < da.size(); i++) {
+    const size_t ia = handIndex(da.mask(i));
+    for (size_t j = 0; j < db.size(); j++) {
+      if (da.mask(i) & db.mask(j))
+        continue;
+      bool swapped = false;
+      const PreflopMatchup* entry =
+          find(matchupKey(ia, handIndex(db.mask(j)), swapped));
+      if (!entry)
+        throw DomainError("the preflop table has no entry for the matchup")
+            << errinfo_value(CardSet(da.mask(i)).str() + " " +
+                             CardSet(db.mask(j)).str());
+      const double weight = da.weight(i) * db.weight(j);
+      results[0].winShares += weight * (swapped ? entry->losses : entry->wins);
+      results[1].winShares += weight * (swapped ? entry->wins : entry->losses);
+      results[0].tieShares += weight * entry->ties / 2.0;
+      results[1].tieShares += weight * entry->ties / 2.0;
+    }
+  }
+  return results;
+}
+
+uint32_t PreflopEquityTable::key(const CardSet& a, const CardSet& b,
+                                 bool& swapped) {
+  checkHand(a);
+  checkHand(b);
+  return matchupKey(handIndex(a.mask()), handIndex(b.mask()), swapped);
+}
+
+void PreflopEquityTable::hands(uint32_t key, CardSet& a, CardSet& b) {
+  const HandTables& tables = handTables();
+  a = CardSet(tables.masks[key / kHands]);
+  b = CardSet(tables.masks[key % kHands]);
+}
+
+std::vector<uint32_t> PreflopEquityTable::keys() {
+  const HandTables& tables = handTables();
+  std::vector<uint32_t> keys;
+  for (size_t a = 0; a < kHands; a++) {
+    for (size_t b = a + 1; b < kHands; b++) {
+      if (tables.masks[a] & tables.masks[b])
+        continue;
+      bool swapped = false;
+      uint32_t k = matchupKey(a, b, swapped);
+      // a matchup is first met in the hand order of its key
+      if (k == a * kHands + b)
+        keys.push_back(k);
+    }
+  }
+  return keys;
+}
+
+std::string PreflopEquityTable::handClass(const CardSet& hand) {
+  checkHand(hand);
+  const char* const ranks = "23456789TJQKA";
+  uint64_t mask = hand.mask();
+  size_t lo = static_cast<size_t>(lastbit(mask));
+  size_t hi = static_cast<size_t>(lastbit(mask & (mask - 1)));
+  size_t rlo = lo % Rank::NUM_RANK;
+  size_t rhi = hi % Rank::NUM_RANK;
+  if (rlo > rhi)
+    std::swap(rlo, rhi);
+  std::string name = {ranks[rhi], ranks[rlo]};
+  if (rlo != rhi)
+    name += lo / Rank::NUM_RANK == hi / Rank::NUM_RANK ? 's' : 'o';
+  return name;
+}
+
+void PreflopEquityTable::write(const std::string& path,
+                               std::vector<PreflopMatchup> entries) {
+  std::sort(entries.begin(), entries.end(),
+            [](const PreflopMatchup& x, const PreflopMatchup& y) {
+              return x.key < y.key;
+            });
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.count = static_cast<uint32_t>(entries.size());
+  header.boards = kBoards;
+  writeTable(path, header, entries, "a preflop table");
+}
+
+}  // namespace nit
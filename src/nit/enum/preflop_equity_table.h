@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_PREFLOP_EQUITY_TABLE_H_
+#define NIT_ENUM_PREFLOP_EQUITY_TABLE_H_
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "card_distribution.h"
+#include "mapped_table.h"
+
+namespace nit {
+
+/**
+ * The exact outcome of a heads up hold'em all in before the flop, over
+ * all the boards, as seen by the first hand of the matchup.
+ */
+struct PreflopMatchup {
+  uint32_t key{0};  ///< the canonical matchup, see PreflopEquityTable::key
+  uint32_t wins{0};
+  uint32_t losses{0};
+  uint32_t ties{0};  ///< boards, each worth half a pot to either hand
+};
+
+/**
+ * Heads up hold'em equity before the flop, read from a table of every
+ * distinct hand against hand matchup.  Two matchups which only differ by
+ * a renaming of the suits, or by the order of the hands, have the same
+ * outcome, so the 1326 by 1326 matchups come down to a few tens of
+ * thousands of entries.  The table is built once by nit-preflop, and
+ * mapped into memory, so opening it is cheap and the pages are shared
+ * between processes.
+ *
+ * A matchup is keyed by the colex indices of its hands, a * 1326 + b,
+ * under the suit renaming and hand order with the smallest key.  The
+ * file is a header, "nit-pf01", the number of entries and the number of
+ * boards of a matchup, each as 32 bits, followed by the entries sorted
+ * by key.  Numbers are stored in the byte order of the machine.
+ *
+ * A table may hold only some of the matchups, queries about the others
+ * throw DomainError.
+ */
+class PreflopEquityTable {
+ public:
+  /// map the table at path, throws InvalidArgument if it is not one
+  explicit PreflopEquityTable(const std::string& path);
+
+  size_t size() const { return m_size; }  //!< matchups in the table
+
+  /// @returns the entry of a matchup, or nullptr if it is not there
+  const PreflopMatchup* find(uint32_t key) const;
+
+  /**
+   * the shares of two hands, the same as the ShowdownEnumerator finds
+   * by dealing all the boards
+   */
+  std::vector<EquityResult> calculateEquity(const CardSet& a,
+                                            const CardSet& b) const;
+
+  /**
+   * the shares of two ranges, summed over the pairs of hands which do
+   * not share a card, each weighted by the product of the weights of its
+   * hands, as in ShowdownEnumerator::calculateEquity
+   */
+  std::vector<EquityResult> calculateEquity(const CardDistribution& a,
+                                            const CardDistribution& b) const;
+
+  /**
+   * @returns the canonical key of a matchup, and sets swapped if the
+   * hands trade places in it
+   */
+  static uint32_t key(const CardSet& a, const CardSet& b, bool& swapped);
+
+  /// set a and b to the hands of a canonical key
+  static void hands(uint32_t key, CardSet& a, CardSet& b);
+
+  /// @returns the keys of every distinct matchup, in order
+  static std::vector<uint32_t> keys();
+
+  /// @returns the class of a hand before the flop, such as AKs or 77
+  static std::string handClass(const CardSet& hand);
+
+  /// write a table, the entries need not be sorted
+  static void write(const std::string& path,
+                    std::vector<PreflopMatchup> entries);
+
+ private:
+  MappedTable m_table;
+  const PreflopMatchup* m_entries;
+  size_t m_size;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_PREFLOP_EQUITY_TABLE_H_
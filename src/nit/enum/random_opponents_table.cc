@@ -0,0 +1,229 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "random_opponents_table.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+#include <nit/util/lastbit.h>
+
+#include "card_distribution.h"
+#include "dense_distribution.h"
+#include "monte_carlo_enumerator.h"
+#include "preflop_equity_table.h"
+
+namespace nit {
+
+namespace {
+
+const char* const kMagic = "nit-random-opponents 1";
+const char* const kRanks = "23456789TJQKA";
+const size_t kTop = Rank::NUM_RANK - 1;
+
+void checkOpponents(size_t opponents) {
+  if (opponents < 1 || opponents > RandomOpponentsTable::kMaxOpponents)
+    throw InvalidArgument("there must be 1 to 9 opponents")
+        << errinfo_value(std::to_string(opponents));
+}
+
+void checkClass(size_t cls) {
+  if (cls >= RandomOpponentsTable::kClasses)
+    throw InvalidArgument("no such starting hand class")
+        << errinfo_value(std::to_string(cls));
+}
+
+size_t entryIndex(size_t cls, size_t opponents) {
+  checkClass(cls);
+  checkOpponents(opponents);
+  return cls * RandomOpponentsTable::kMaxOpponents + opponents - 1;
+}
+
+}  // namespace
+
+const size_t RandomOpponentsTable::kClasses;
+const size_t RandomOpponentsTable::kMaxOpponents;
+
+RandomOpponentsTable::RandomOpponentsTable()
+    : m_entries(kClasses * kMaxOpponents), m_set(kClasses * kMaxOpponents) {}
+
+const RandomOpponentsEquity& RandomOpponentsTable::get(size_t cls,
+                                                       size_t opponents) const {
+  size_t index = entryIndex(cls, opponents);
+  if (!m_set[index])
+    throw DomainError("the table has no entry for the class")
+        << errinfo_value(className(cls) + " " + std::to_string(opponents));
+  return m_entries[index];
+}
+
+void RandomOpponentsTable::set(size_t cls, size_t opponents,
+                               const RandomOpponentsEquity& entry) {
+  size_t index = entryIndex(cls, opponents);
+  m_entries[index] = entry;
+  m_set[index] = true;
+}
+
+bool RandomOpponentsTable::complete() const {
+  for (bool set : m_set)
+    if (!set)
+      return false;
+  return true;
+}
+
+void RandomOpponentsTable::write(std::ostream& out) const {
+  out << kMagic << "\n";
+  out.precision(17);
+  for (size_t cls = 0; cls < kClasses; cls++) {
+    for (size_t k = 1; k <= kMaxOpponents; k++) {
+      size_t index = entryIndex(cls, k);
+      if (!m_set[index])
+        continue;
+      const RandomOpponentsEquity& entry = m_entries[index];
+      out << className(cls) << " " << k << " " << entry.equity << " "
+          << entry.errorBound << " " << entry.samples << "\n";
+    }
+  }
+}
+
+RandomOpponentsTable RandomOpponentsTable::read(std::istream& in) {
+  RandomOpponentsTable table;
+  std::string line;
+  if (!std::getline(in, line) || line != kMagic)
+    throw ParseError("not a random opponents table") << errinfo_value(line);
+  while (std::getline(in, line)) {
+    if (line.empty())
+      continue;
+    std::istringstream fields(line);
+    std::string name;
+    size_t opponents = 0;
+    RandomOpponentsEquity entry;
+    if (!(fields >> name >> opponents >> entry.equity >> entry.errorBound >>
+          entry.samples))
+      throw ParseError("bad entry in random opponents table")
+          << errinfo_value(line);
+    try {
+      table.set(classIndex(name), opponents, entry);
+    } catch (const InvalidArgument&) {
+      throw ParseError("bad entry in random opponents table")
+          << errinfo_value(line);
+    }
+  }
+  return table;
+}
+
+void RandomOpponentsTable::save(const std::string& path) const {
+  std::ofstream out(path, std::ios::trunc);
+  write(out);
+  out.flush();
+  if (!out)
+    throw InvalidArgument("could not write the random opponents table")
+        << errinfo_value(path);
+}
+
+RandomOpponentsTable RandomOpponentsTable::load(const std::string& path) {
+  std::ifstream in(path);
+  if (!in)
+    throw InvalidArgument("could not read the random opponents table")
+        << errinfo_value(path);
+  return read(in);
+}
+
+size_t RandomOpponentsTable::classIndex(const CardSet& hand) {
+  uint64_t mask = hand.mask();
+  if (hand.size() != 2 || (mask >> STANDARD_DECK_SIZE) != 0)
+    throw InvalidArgument("a starting hand has two cards")
+        << errinfo_value(hand.str());
+  size_t lo = static_cast<size_t>(lastbit(mask));
+  size_t hi = static_cast<size_t>(lastbit(mask & (mask - 1)));
+  size_t rlo = lo % Rank::NUM_RANK;
+  size_t rhi = hi % Rank::NUM_RANK;
+  if (rlo > rhi)
+    std::swap(rlo, rhi);
+  // suited hands above the diagonal, off suit hands below
+  bool suited = lo / Rank::NUM_RANK == hi / Rank::NUM_RANK;
+  size_t row = kTop - (suited ? rhi : rlo);
+  size_t col = kTop - (suited ? rlo : rhi);
+  return row * Rank::NUM_RANK + col;
+}
+
+std::string RandomOpponentsTable::className(size_t cls) {
+  checkClass(cls);
+  size_t row = cls / Rank::NUM_RANK;
+  size_t col = cls % Rank::NUM_RANK;
+  if (row == col)
+    return {kRanks[kTop - row], kRanks[kTop - row]};
+  if (row < col)
+    return {kRanks[kTop - row], kRanks[kTop - col], 's'};
+  return {kRanks[kTop - col], kRanks[kTop - row], 'o'};
+}
+
+size_t RandomOpponentsTable::classIndex(const std::string& name) {
+  for (size_t cls = 0; cls < kClasses; cls++)
+    if (className(cls) == name)
+      return cls;
+  throw InvalidArgument("no such starting hand class") << errinfo_value(name);
+}
+
+CardSet RandomOpponentsTable::classHand(size_t cls) {
+  checkClass(cls);
+  size_t row = cls / Rank::NUM_RANK;
+  size_t col = cls % Rank::NUM_RANK;
+  // the first card is a club, the second a club if suited, else a diamond
+  size_t first = kTop - std::min(row, col);
+  size_t second = kTop - std::max(row, col);
+  size_t suit = row < col ? 0 : 1;
+  return CardSet(UINT64_C(1) << first |
+                 UINT64_C(1) << (suit * Rank::NUM_RANK + second));
+}
+
+RandomOpponentsEquity RandomOpponentsTable::exact(
+    const PreflopEquityTable& table, size_t cls) {
+  CardSet hand = classHand(cls);
+  std::vector<CardSet> others;
+  for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++) {
+    for (size_t lo = 0; lo < hi; lo++) {
+      CardSet other(UINT64_C(1) << hi | UINT64_C(1) << lo);
+      if (!hand.intersects(other))
+        others.push_back(other);
+    }
+  }
+  CardDistribution random(others[0]);
+  for (size_t i = 1; i < others.size(); i++)
+    random.insert(others[i]);
+  std::vector<EquityResult> results =
+      table.calculateEquity(CardDistribution(hand), random);
+  RandomOpponentsEquity entry;
+  double total = 0.0;
+  for (const EquityResult& result : results)
+    total += result.winShares + result.tieShares;
+  entry.equity = (results[0].winShares + results[0].tieShares) / total;
+  return entry;
+}
+
+RandomOpponentsEquity RandomOpponentsTable::sample(size_t cls,
+                                                   size_t opponents,
+                                                   uint64_t samples,
+                                                   uint64_t seed) {
+  checkOpponents(opponents);
+  std::unique_ptr<PokerHandEvaluator> peval = makeEvaluator("h");
+  // a random hand is one with no cards, which is dealt in full
+  std::vector<DenseDistribution> dists(opponents + 1,
+                                       DenseDistribution(CardDistribution()));
+  dists[0] = DenseDistribution(CardDistribution(classHand(cls)));
+  SampledEquity sampled =
+      MonteCarloEnumerator(seed).calculateEquity(dists, CardSet(), *peval,
+                                                 samples);
+  RandomOpponentsEquity entry;
+  entry.equity = (sampled.results[0].winShares +
+                  sampled.results[0].tieShares) /
+                 static_cast<double>(sampled.samples);
+  entry.errorBound = sampled.errorBound;
+  entry.samples = sampled.samples;
+  return entry;
+}
+
+}  // namespace nit
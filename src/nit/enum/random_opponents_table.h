@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_RANDOM_OPPONENTS_TABLE_H_
+#define NIT_ENUM_RANDOM_OPPONENTS_TABLE_H_
+
+#include <cstdint>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <nit/eval/card_set.h>
+
+namespace nit {
+
+class PreflopEquityTable;
+
+/**
+ * The equity of a hold'em starting hand, against one or more opponents
+ * holding random hands.
+ */
+struct RandomOpponentsEquity {
+  double equity{0.0};
+  double errorBound{0.0};  ///< the 95% half width, 0 if exact
+  uint64_t samples{0};     ///< 0 if exact
+};
+
+/**
+ * Hold'em equity before the flop of each of the 169 starting classes
+ * against 1 to 9 random hands, precomputed once so a lookup replaces an
+ * enumeration.  Against one hand the equity is exact, summed from the
+ * matchups of a PreflopEquityTable, and against more it is sampled.
+ *
+ * The classes are numbered as the cells of the usual 13 by 13 chart,
+ * with the aces first, the suited hands above the diagonal and the off
+ * suit hands below it.
+ *
+ * The text format is one entry per line:
+ *
+ *   nit-random-opponents 1
+ *   <class> <opponents> <equity> <error bound> <samples>
+ */
+class RandomOpponentsTable {
+ public:
+  static const size_t kClasses = 169;
+  static const size_t kMaxOpponents = 9;
+
+  RandomOpponentsTable();
+
+  /// the entry of a class against opponents random hands
+  const RandomOpponentsEquity& get(size_t cls, size_t opponents) const;
+  void set(size_t cls, size_t opponents, const RandomOpponentsEquity& entry);
+
+  /// @returns the equity of a hand against opponents random hands
+  double equity(const CardSet& hand, size_t opponents) const {
+    return get(classIndex(hand), opponents).equity;
+  }
+
+  /// @returns true if every class has an entry for every field size
+  bool complete() const;
+
+  void write(std::ostream& out) const;
+
+  /// read a table, throws ParseError on malformed input
+  static RandomOpponentsTable read(std::istream& in);
+
+  void save(const std::string& path) const;
+  static RandomOpponentsTable load(const std::string& path);
+
+  /// @returns the class of a two card hand, in [0, kClasses)
+  static size_t classIndex(const CardSet& hand);
+
+  /// @returns the name of a class, such as AKs
+  static std::string className(size_t cls);
+
+  /// @returns the class of a name, throws InvalidArgument if there is none
+  static size_t classIndex(const std::string& name);
+
+  /// @returns a hand of a class, all of them have the same equity
+  static CardSet classHand(size_t cls);
+
+  /// @returns the exact equity of a class against one random hand
+  static RandomOpponentsEquity exact(const PreflopEquityTable& table,
+                                     size_t cls);
+
+  /// @returns the sampled equity of a class against opponents random hands
+  static RandomOpponentsEquity sample(size_t cls, size_t opponents,
+                                      uint64_t samples, uint64_t seed = 0);
+
+ private:
+  std::vector<RandomOpponentsEquity> m_entries;  // [class * 9 + opponents-1]
+  std::vector<bool> m_set;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_RANDOM_OPPONENTS_TABLE_H_
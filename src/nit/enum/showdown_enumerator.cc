@@ -3,9 +3,22 @@
  */
 #include "showdown_enumerator.h"
 
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
 #include <nit/error.h>
+#include <nit/eval/caching_hand_evaluator.h>
 
-#include "odometer.h"
+#include "checkpoint.h"
+#include "distribution_walker.h"
+#include "equity_distribution.h"
 #include "partition_enumerator.h"
 #include "simple_deck.h"
 
@@ -15,85 +28,685 @@ ShowdownEnumerator::ShowdownEnumerator() = default;
 
 std::vector<EquityResult> ShowdownEnumerator::calculateEquity(
     const std::vector<CardDistribution>& dists, const CardSet& board,
-    const PokerHandEvaluator& peval) const {
-  assert(dists.size() > 1);
-  const size_t ndists = dists.size();
-  std::vector<EquityResult> results(ndists, EquityResult());
-  size_t handsize = peval.handSize();
+    const PokerHandEvaluator& peval, const EnumerationOptions& options) const {
+  std::vector<DenseDistribution> dense;
+  dense.reserve(dists.size());
+  for (const CardDistribution& dist : dists) {
+    assert(dist.size() > 0);
+    dense.emplace_back(dist);
+  }
+  return calculateEquity(dense, board, peval, options);
+}
+
+namespace {
+
+/// the deals between calls to the block hook of the shares, less one
+const uint64_t kBlockMask = 4095;
+
+/**
+ * Accumulates the shares of each showdown exactly.  The award of every
+ * way a pot can be split is computed once per tuple of hands, so the
+ * showdowns only add integers.  The shares can be saved to a checkpoint
+ * file as the enumeration goes.
+ */
+class ExactShares {
+ public:
+  ExactShares(const PokerHandEvaluator& peval, size_t ndists)
+      : m_peval(peval),
+        m_evals(ndists),
+        m_results(ndists),
+        m_scale(exactScale(ndists, peval.evaluationSize())),
+        m_split(ndists * peval.evaluationSize() + 1),
+        m_query(0),
+        m_interval(0.0) {
+    for (ExactEquityResult& result : m_results)
+      result.scale = m_scale;
+  }
+
+  /// save a checkpoint of the query to path every interval seconds
+  void checkpoint(const std::string& path, double interval, uint64_t query) {
+    m_path = path;
+    m_interval = interval;
+    m_query = query;
+    m_saved = std::chrono::steady_clock::now();
+  }
+
+  void tuple(double weight) {
+    // the tuple weight is a product of whole numbers, and it is exact as
+    // long as it fits in the mantissa of a double
+    if (weight > 9007199254740992.0)
+      throw InvalidArgument("exact equity weights are too large")
+          << errinfo_value(std::to_string(weight));
+    UInt128 unit =
+        UInt128::multiply(static_cast<uint64_t>(weight), m_scale);
+    if (unit.hi != 0)
+      throw InvalidArgument("exact equity weights are too large")
+          << errinfo_value(std::to_string(weight));
+    for (size_t k = 1; k < m_split.size(); k++)
+      m_split[k] = unit.lo / k;
+  }
+
+  void showdown(const std::vector<CardSet>& hands, const CardSet& board) {
+    m_peval.evaluateShowdown(hands, board, m_evals, m_results, m_split.data());
+  }
+
+  bool decided(size_t winner, uint64_t ndeals) {
+    m_results[winner].winShares += UInt128::multiply(m_split[1], ndeals);
+    return true;
+  }
+
+  /// the deals before deal are done, save them if a checkpoint is due
+  void block(uint64_t deal, bool force) {
+    if (m_path.empty())
+      return;
+    auto now = std::chrono::steady_clock::now();
+    if (!force &&
+        std::chrono::duration<double>(now - m_saved).count() < m_interval)
+      return;
+    Checkpoint checkpoint;
+    checkpoint.query = m_query;
+    checkpoint.position = deal;
+    checkpoint.results = m_results;
+    checkpoint.save(m_path);
+    m_saved = now;
+  }
+
+  std::vector<ExactEquityResult>& results() { return m_results; }
+
+ private:
+  const PokerHandEvaluator& m_peval;
+  std::vector<PokerHandEvaluation> m_evals;
+  std::vector<ExactEquityResult> m_results;
+  uint64_t m_scale;
+  std::vector<uint64_t> m_split;  // award by the number of ways split
+  std::string m_path;             // the checkpoint file, if any
+  uint64_t m_query;
+  double m_interval;
+  std::chrono::steady_clock::time_point m_saved;
+};
+
+/// the deals batched into each block handed to a visitor
+const size_t kVisitBlockSize = 256;
+
+/**
+ * Hands the deals to a visitor, a block at a time.  The block is also
+ * flushed at every block of the enumeration loop, so a visitor is never
+ * more than a block of deals behind the enumeration.
+ */
+class VisitorShares {
+ public:
+  VisitorShares(const PokerHandEvaluator& peval, size_t ndists,
+                ShowdownVisitor& visitor)
+      : m_peval(peval),
+        m_visitor(visitor),
+        m_block(ndists, kVisitBlockSize),
+        m_weight(0.0) {}
+
+  void tuple(double weight) { m_weight = weight; }
+
+  void showdown(const std::vector<CardSet>& hands, const CardSet& board) {
+    m_block.append(m_peval, hands.data(), board, m_weight);
+    if (m_block.full())
+      flush();
+  }
+
+  bool decided(size_t winner, uint64_t ndeals) {
+    flush();
+    return m_visitor.decided(winner, ndeals, m_weight);
+  }
 
-  // the dsizes vector is a list of the sizes of the player hand
-  // distributions
-  std::vector<size_t> dsizes;
+  void block(uint64_t /*deal*/, bool /*force*/) { flush(); }
+
+  void flush() {
+    if (m_block.size() > 0)
+      m_visitor.visit(m_block);
+    m_block.clear();
+  }
+
+ private:
+  const PokerHandEvaluator& m_peval;
+  ShowdownVisitor& m_visitor;
+  ShowdownBlock m_block;
+  double m_weight;
+};
+
+/**
+ * Accumulates the shares of each board of a multi board showdown apart.
+ * The hands of a showdown are followed by all of the completed boards.
+ */
+class MultiBoardShares {
+ public:
+  MultiBoardShares(const PokerHandEvaluator& peval, size_t ndists,
+                   size_t nboards)
+      : m_peval(peval),
+        m_ndists(ndists),
+        m_evals(ndists),
+        m_results(nboards, std::vector<EquityResult>(ndists)),
+        m_weight(0.0) {}
+
+  void tuple(double weight) { m_weight = weight; }
+
+  void showdown(const std::vector<CardSet>& hands, const CardSet& /*board*/) {
+    for (size_t b = 0; b < m_results.size(); b++)
+      m_peval.evaluateShowdown(hands, hands[m_ndists + b], m_evals,
+                               m_results[b], m_weight);
+  }
+
+  bool decided(size_t /*winner*/, uint64_t /*ndeals*/) { return false; }
+
+  void block(uint64_t /*deal*/, bool /*force*/) {}
+
+  std::vector<std::vector<EquityResult>>& results() { return m_results; }
+
+ private:
+  const PokerHandEvaluator& m_peval;
+  size_t m_ndists;
+  std::vector<PokerHandEvaluation> m_evals;
+  std::vector<std::vector<EquityResult>> m_results;  // [board][player]
+  double m_weight;
+};
+
+/**
+ * Set up the fixed cards and the number of cards to deal of every hand of
+ * the walker's current tuple, followed by the boards if there are any.
+ */
+void setupPartitions(const DistributionWalker& walker,
+                     const std::vector<CardSet>& boards,
+                     const PokerHandEvaluator& peval,
+                     std::vector<CardSet>& cardPartitions,
+                     std::vector<size_t>& parts) {
+  const size_t ndists = walker.size();
   for (size_t i = 0; i < ndists; i++) {
-    assert(dists[i].size() > 0);
-    dsizes.push_back(dists[i].size());
+    cardPartitions[i] = walker.hand(i);
+    parts[i] = peval.handSize() - cardPartitions[i].size();
+  }
+  // each board is dealt as its own partition
+  for (size_t i = ndists; i < parts.size(); i++) {
+    cardPartitions[i] = boards[i - ndists];
+    parts[i] = peval.boardSize() - cardPartitions[i].size();
   }
+}
+
+/// @returns the cards of all the boards
+CardSet knownBoardCards(const std::vector<CardSet>& boards) {
+  CardSet known;
+  for (const CardSet& board : boards)
+    known |= board;
+  return known;
+}
+
+/// @returns the number of deals of a whole enumeration
+uint64_t countDeals(const std::vector<DenseDistribution>& dists,
+                    const std::vector<CardSet>& boards,
+                    const PokerHandEvaluator& peval, size_t nboards) {
+  std::vector<CardSet> cardPartitions(dists.size() + nboards);
+  std::vector<size_t> parts(dists.size() + nboards);
+  uint64_t total = 0;
+  DistributionWalker walker(dists,
+                            nboards > 0 ? knownBoardCards(boards) : CardSet());
+  while (walker.next()) {
+    setupPartitions(walker, boards, peval, cardPartitions, parts);
+    uint64_t ndeals = PartitionEnumerator2::count(
+        STANDARD_DECK_SIZE - walker.dead().size(), parts);
+    if (total + ndeals < total)
+      throw DomainError("too many deals to shard");
+    total += ndeals;
+  }
+  return total;
+}
+
+/// @returns the first deal of shard index of count in total deals
+uint64_t shardStart(uint64_t total, size_t index, size_t count) {
+  UInt128 start = UInt128::multiply(total, index);
+  start.divide(static_cast<uint32_t>(count));
+  return start.lo;
+}
 
-  // need to figure out the board stuff, we'll be rolling the board into
-  // the partitions to make enumeration easier down the line.
-  size_t nboards = 0;
-  size_t boardsize = peval.boardSize();
-  if (boardsize > 0)
-    nboards++;
+/// fold the bytes of a value into an FNV-1a hash
+template <class T>
+void hashBytes(const T& value, uint64_t& hash) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  for (size_t i = 0; i < sizeof(T); i++) {
+    hash ^= bytes[i];
+    hash *= UINT64_C(0x100000001b3);
+  }
+}
+
+/**
+ * Watches an enumeration for the options: reports the progress, and
+ * tells the enumeration when to stop.  It is only consulted once per
+ * block of deals.
+ */
+class Monitor {
+ public:
+  explicit Monitor(const EnumerationOptions& options)
+      : m_options(options),
+        m_active(options.progress || options.cancel ||
+                 options.deadline !=
+                     std::chrono::steady_clock::time_point::max()) {}
+
+  /// @returns true if anything needs to be checked at all
+  bool active() const { return m_active; }
+
+  /// @returns false if the enumeration should stop
+  bool block(double fraction) const {
+    if (m_options.progress)
+      m_options.progress(fraction);
+    if (m_options.cancel && m_options.cancel->load(std::memory_order_relaxed))
+      return false;
+    return std::chrono::steady_clock::now() < m_options.deadline;
+  }
+
+ private:
+  const EnumerationOptions& m_options;
+  bool m_active;
+};
+
+/**
+ * @returns the player who wins every deal of a tuple, or the number of
+ * players if no one is sure to.  Only the board is left to deal, ncards
+ * of it, and a player wins every runout when the hand made so far beats
+ * the best hand type each of the others can still reach.
+ */
+size_t lockedWinner(const std::vector<CardSet>& hands, size_t ndists,
+                    const CardSet& board, size_t ncards, const CardSet& dead,
+                    const PokerHandEvaluator& peval) {
+  size_t leader = 0;
+  int made = -1;
+  for (size_t i = 0; i < ndists; i++) {
+    int type = peval.evaluateHand(hands[i], board).high().type();
+    if (type > made) {
+      made = type;
+      leader = i;
+    }
+  }
+  for (size_t i = 0; i < ndists; i++)
+    if (i != leader &&
+        peval.highTypeBound(hands[i], board, ncards, dead) >= made)
+      return ndists;
+  return leader;
+}
+
+/// @returns the number of deals of the partitions, as a double
+double countApprox(size_t setSize, const std::vector<size_t>& parts) {
+  double count = 1.0;
+  for (size_t part : parts) {
+    count *= static_cast<double>(choose(setSize, part));
+    setSize -= std::min(part, setSize);
+  }
+  return count;
+}
+
+/**
+ * The enumeration loop, shared by all accumulations.  Shares must have
+ * tuple(weight), called for each tuple of hands, and showdown(hands,
+ * board), called for each completed deal, where the hands are followed by
+ * the completed boards, and block(deal, force), called
+ * every few thousand deals with the number of the next deal, and with
+ * force set when the enumeration stops early.  decided(winner, ndeals)
+ * is offered the deals of a tuple which winner wins on every board, and
+ * returns false to have them dealt anyway.
+ *
+ * The deals are numbered in the order of the full enumeration.  Tuples
+ * which fall before the shard or the resume point are skipped whole, and
+ * the partition enumeration of the first tuple visited is moved straight
+ * to the first deal.
+ *
+ * @returns how far the enumeration got
+ */
+template <class Shares>
+EnumerationStatus enumerate(const std::vector<DenseDistribution>& dists,
+                            const std::vector<CardSet>& boards,
+                            const PokerHandEvaluator& peval,
+                            const EnumerationOptions& options,
+                            uint64_t resume, Shares& shares) {
+  assert(dists.size() > 1);
+  assert(!boards.empty());
+  const size_t ndists = dists.size();
+
+  // need to figure out the board stuff, we'll be rolling the boards into
+  // the partitions to make enumeration easier down the line.  Games
+  // without a board still pass the fixed cards of the first one to the
+  // showdown.
+  const size_t nboards = peval.boardSize() > 0 ? boards.size() : 0;
+  const CardSet& board = boards[0];
+
+  // the range of deals to enumerate, all of them unless sharded or resumed
+  const Shard& shard = options.shard;
+  const bool ranged = shard.count > 1 || resume > 0;
+  uint64_t begin = 0;
+  uint64_t end = std::numeric_limits<uint64_t>::max();
+  if (shard.count > 1) {
+    uint64_t total = countDeals(dists, boards, peval, nboards);
+    begin = shardStart(total, shard.index, shard.count);
+    end = shardStart(total, shard.index + 1, shard.count);
+  }
+  begin = std::max(begin, resume);
+  EnumerationStatus status;
+  status.fraction = 1.0;
+  if (begin >= end)
+    return status;
+  uint64_t position = 0;    // the number of the first deal after the tuple
+  uint64_t deal = 0;        // the number of the current deal
+  uint64_t tupleStart = 0;  // the number of the first deal of the tuple
+  double tupleDeals = 1.0;  // the number of deals of the tuple
+  const Monitor monitor(options);
+  bool stopped = false;
 
   // for the most part, these are allocated here to avoid contant stack
   // reallocation as we cycle through the inner loops
   SimpleDeck deck;
-  CardSet dead;
-  double weight;
   std::vector<CardSet> ehands(ndists + nboards);
   std::vector<size_t> parts(ndists + nboards);
   std::vector<CardSet> cardPartitions(ndists + nboards);
-  std::vector<PokerHandEvaluation> evals(ndists);  // NO BOARD
 
   // copy quickness
   CardSet* copydest = &ehands[0];
   CardSet* copysrc = &cardPartitions[0];
   size_t ncopy = (ndists + nboards) * sizeof(CardSet);
-  Odometer o(dsizes);
-  do {
-    // colect all the cards being used by the players, skip out in the
-    // case of card duplication
-    bool disjoint = true;
-    dead.clear();
-    weight = 1.0;
-    for (size_t i = 0; i < ndists + nboards; i++) {
-      if (i < ndists) {
-        cardPartitions[i] = dists[i][o[i]];
-        parts[i] = handsize - cardPartitions[i].size();
-        weight *= dists[i][cardPartitions[i]];
-      } else {
-        // this allows us to have board distributions in the future
-        cardPartitions[i] = board;
-        parts[i] = boardsize - cardPartitions[i].size();
+
+  // the walker only stops on tuples of hands which share no cards with
+  // each other or with the board, so card conflicts never reach the
+  // partition enumeration below
+  DistributionWalker walker(dists,
+                            nboards > 0 ? knownBoardCards(boards) : CardSet());
+
+  // tuples whose showdown no runout can change are credited whole, this
+  // needs complete hands and a flop, so only the board is left to deal
+  const bool prune = options.pruneDecided && nboards == 1 &&
+                     peval.evaluationSize() == 1 && board.size() >= 3 &&
+                     board.size() < peval.boardSize();
+
+  // the fraction of the deals done, exact for a shard, otherwise the
+  // odometer position of the walker plus the share of the current tuple
+  auto estimate = [&]() {
+    if (shard.count > 1)
+      return static_cast<double>(deal - begin) /
+             static_cast<double>(end - begin);
+    return walker.fraction() +
+           walker.tupleFraction() * static_cast<double>(deal - tupleStart) /
+               tupleDeals;
+  };
+
+  while (walker.next()) {
+    setupPartitions(walker, boards, peval, cardPartitions, parts);
+    deck.reset();
+    deck.remove(walker.dead());
+    PartitionEnumerator2 pe(deck.size(), parts);
+
+    // the deals of this tuple to visit
+    uint64_t first = 0;
+    uint64_t left = std::numeric_limits<uint64_t>::max();
+    if (ranged) {
+      uint64_t start = position;
+      position += PartitionEnumerator2::count(deck.size(), parts);
+      if (position <= begin)
+        continue;
+      if (start >= end)
+        break;
+      first = std::max(begin, start) - start;
+      left = std::min(end, position) - start - first;
+      if (first > 0)
+        pe.seek(first);
+      deal = start + first;
+    }
+    tupleStart = deal - first;
+    tupleDeals = monitor.active() ? countApprox(deck.size(), parts) : 1.0;
+
+    shares.tuple(walker.weight());
+    if (prune &&
+        std::all_of(parts.begin(), parts.begin() + ndists,
+                    [](size_t part) { return part == 0; })) {
+      size_t winner =
+          lockedWinner(cardPartitions, ndists, board, parts[ndists],
+                       walker.dead(), peval);
+      uint64_t ndeals =
+          winner < ndists
+              ? std::min(left,
+                         PartitionEnumerator2::count(deck.size(), parts) -
+                             first)
+              : 0;
+      if (winner < ndists && shares.decided(winner, ndeals)) {
+        // keep to the blocks, as if the deals had been visited one by one
+        bool crossed = ((deal ^ (deal + ndeals)) & ~kBlockMask) != 0;
+        deal += ndeals;
+        if (crossed) {
+          shares.block(deal, false);
+          if (monitor.active() && !monitor.block(estimate())) {
+            stopped = true;
+            break;
+          }
+        }
+        continue;
       }
-      disjoint = disjoint && dead.disjoint(cardPartitions[i]);
-      dead |= cardPartitions[i];
     }
+    do {
+      // we use memcpy here for a little speed bonus
+      memcpy(copydest, copysrc, ncopy);
+      for (size_t p = 0; p < ndists + nboards; p++)
+        ehands[p] |= deck.peek(pe.getMask(p));
+
+      // TODO: do we need this if/else, or can we just use the if
+      // clause? A: need to rework tracking of whether a board is
+      // needed
+      if (nboards > 0)
+        shares.showdown(ehands, ehands[ndists]);
+      else
+        shares.showdown(ehands, board);
+      if ((++deal & kBlockMask) == 0) {
+        shares.block(deal, false);
+        if (monitor.active())
+          stopped = !monitor.block(estimate());
+      }
+    } while (!stopped && --left > 0 && pe.next());
+    if (stopped)
+      break;
+  }
+
+  if (stopped) {
+    shares.block(deal, true);
+    status.complete = false;
+    status.fraction = estimate();
+  }
+  status.position = deal;
+  if (options.progress && !stopped)
+    options.progress(1.0);
+  return status;
+}
+
+}  // namespace
 
-    if (disjoint) {
-      deck.reset();
-      deck.remove(dead);
-      PartitionEnumerator2 pe(deck.size(), parts);
-      do {
-        // we use memcpy here for a little speed bonus
-        memcpy(copydest, copysrc, ncopy);
-        for (size_t p = 0; p < ndists + nboards; p++)
-          ehands[p] |= deck.peek(pe.getMask(p));
-
-        // TODO: do we need this if/else, or can we just use the if
-        // clause? A: need to rework tracking of whether a board is
-        // needed
-        if (nboards > 0)
-          peval.evaluateShowdown(ehands, ehands[ndists], evals, results,
-                                 weight);
-        else
-          peval.evaluateShowdown(ehands, board, evals, results, weight);
-      } while (pe.next());
+namespace {
+
+/**
+ * @returns the evaluator to enumerate a query with, behind a cache held
+ * by holder if the options ask for one
+ */
+const PokerHandEvaluator& queryEvaluator(
+    const PokerHandEvaluator& peval, const EnumerationOptions& options,
+    std::unique_ptr<CachingHandEvaluator>& holder) {
+  if (options.evaluationCache == 0)
+    return peval;
+  holder.reset(new CachingHandEvaluator(peval, options.evaluationCache));
+  return *holder;
+}
+
+}  // namespace
+
+uint64_t ShowdownEnumerator::fingerprint(
+    const std::vector<DenseDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, const Shard& shard) {
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+  for (char c : std::string(typeid(peval).name()))
+    hashBytes(c, hash);
+  hashBytes(peval.handSize(), hash);
+  hashBytes(peval.boardSize(), hash);
+  hashBytes(peval.evaluationSize(), hash);
+  hashBytes(board.mask(), hash);
+  hashBytes(shard.index, hash);
+  hashBytes(shard.count, hash);
+  hashBytes(dists.size(), hash);
+  for (const DenseDistribution& dist : dists) {
+    hashBytes(dist.size(), hash);
+    for (size_t i = 0; i < dist.size(); i++) {
+      hashBytes(dist.mask(i), hash);
+      hashBytes(dist.weight(i), hash);
+    }
+  }
+  return hash;
+}
+
+std::vector<EquityResult> ShowdownEnumerator::calculateEquity(
+    const std::vector<DenseDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, const EnumerationOptions& options) const {
+  if (options.distribution) {
+    if (options.shard.count > 1)
+      throw InvalidArgument("an equity distribution needs every deal");
+    EquityDistribution& distribution = *options.distribution;
+    EquityDistributionVisitor visitor(dists.size(), board, peval,
+                                      distribution.cards, distribution.bins);
+    EnumerationOptions run = options;
+    run.distribution = nullptr;  // the visitor takes it
+    visit(dists, board, peval, visitor, run);
+    distribution.players = visitor.histograms();
+    return visitor.results();
+  }
+  // summing the shares is just one visitor among others
+  EquityVisitor visitor(dists.size());
+  visit(dists, board, peval, visitor, options);
+  return visitor.results();
+}
+
+void ShowdownEnumerator::visit(const std::vector<CardDistribution>& dists,
+                               const CardSet& board,
+                               const PokerHandEvaluator& peval,
+                               ShowdownVisitor& visitor,
+                               const EnumerationOptions& options) const {
+  std::vector<DenseDistribution> dense;
+  dense.reserve(dists.size());
+  for (const CardDistribution& dist : dists) {
+    assert(dist.size() > 0);
+    dense.emplace_back(dist);
+  }
+  visit(dense, board, peval, visitor, options);
+}
+
+void ShowdownEnumerator::visit(const std::vector<DenseDistribution>& dists,
+                               const CardSet& board,
+                               const PokerHandEvaluator& peval,
+                               ShowdownVisitor& visitor,
+                               const EnumerationOptions& options) const {
+  if (!options.checkpointFile.empty())
+    throw InvalidArgument("checkpoints need an exact enumeration");
+  if (options.distribution)
+    throw InvalidArgument("only calculateEquity takes an equity distribution");
+  std::unique_ptr<CachingHandEvaluator> cache;
+  const PokerHandEvaluator& qeval = queryEvaluator(peval, options, cache);
+  VisitorShares shares(qeval, dists.size(), visitor);
+  EnumerationStatus status =
+      enumerate(dists, {board}, qeval, options, 0, shares);
+  shares.flush();
+  if (options.status)
+    *options.status = status;
+}
+
+std::vector<std::vector<EquityResult>> ShowdownEnumerator::calculatePotEquity(
+    const std::vector<CardDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, const std::vector<Pot>& pots,
+    const EnumerationOptions& options) const {
+  SidePotVisitor visitor(pots, dists.size());
+  visit(dists, board, peval, visitor, options);
+  return visitor.results();
+}
+
+MultiBoardResult ShowdownEnumerator::calculateMultiBoardEquity(
+    const std::vector<CardDistribution>& dists,
+    const std::vector<CardSet>& boards, const PokerHandEvaluator& peval,
+    const EnumerationOptions& options) const {
+  if (boards.empty())
+    throw InvalidArgument("there must be at least one board");
+  if (peval.boardSize() == 0)
+    throw InvalidArgument("the game has no board");
+  if (!options.checkpointFile.empty())
+    throw InvalidArgument("checkpoints need an exact enumeration");
+  if (options.distribution)
+    throw InvalidArgument("only calculateEquity takes an equity distribution");
+  std::vector<DenseDistribution> dense;
+  dense.reserve(dists.size());
+  for (const CardDistribution& dist : dists) {
+    assert(dist.size() > 0);
+    dense.emplace_back(dist);
+  }
+  std::unique_ptr<CachingHandEvaluator> cache;
+  const PokerHandEvaluator& qeval = queryEvaluator(peval, options, cache);
+  MultiBoardShares shares(qeval, dense.size(), boards.size());
+  EnumerationStatus status =
+      enumerate(dense, boards, qeval, options, 0, shares);
+  if (options.status)
+    *options.status = status;
+
+  // each board is worth an equal part of the pot
+  MultiBoardResult result;
+  result.boards = shares.results();
+  result.combined.resize(dense.size());
+  const double part = 1.0 / static_cast<double>(boards.size());
+  for (const std::vector<EquityResult>& board : result.boards) {
+    for (size_t i = 0; i < dense.size(); i++) {
+      result.combined[i].winShares += board[i].winShares * part;
+      result.combined[i].tieShares += board[i].tieShares * part;
     }
-  } while (o.next());
+  }
+  return result;
+}
+
+std::vector<ExactEquityResult> ShowdownEnumerator::calculateExactEquity(
+    const std::vector<CardDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, const EnumerationOptions& options) const {
+  std::vector<DenseDistribution> dense;
+  dense.reserve(dists.size());
+  for (const CardDistribution& dist : dists) {
+    assert(dist.size() > 0);
+    dense.emplace_back(dist);
+  }
+  return calculateExactEquity(dense, board, peval, options);
+}
 
-  return results;
+std::vector<ExactEquityResult> ShowdownEnumerator::calculateExactEquity(
+    const std::vector<DenseDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, const EnumerationOptions& options) const {
+  for (const DenseDistribution& dist : dists)
+    for (double weight : dist.weights())
+      if (weight < 0.0 || weight != std::floor(weight))
+        throw InvalidArgument("exact equity needs whole number weights")
+            << errinfo_value(std::to_string(weight));
+  if (options.distribution)
+    throw InvalidArgument("only calculateEquity takes an equity distribution");
+  std::unique_ptr<CachingHandEvaluator> cache;
+  const PokerHandEvaluator& qeval = queryEvaluator(peval, options, cache);
+  ExactShares shares(qeval, dists.size());
+  uint64_t resume = 0;
+  const std::string& path = options.checkpointFile;
+  if (!path.empty()) {
+    uint64_t query = fingerprint(dists, board, peval, options.shard);
+    Checkpoint checkpoint;
+    if (Checkpoint::load(path, checkpoint)) {
+      if (checkpoint.query != query ||
+          checkpoint.results.size() != dists.size())
+        throw InvalidArgument("the checkpoint is for another enumeration")
+            << errinfo_value(path);
+      shares.results() = checkpoint.results;
+      resume = checkpoint.position;
+    }
+    shares.checkpoint(path, options.checkpointInterval, query);
+  }
+  EnumerationStatus status =
+      enumerate(dists, {board}, qeval, options, resume, shares);
+  if (options.status)
+    *options.status = status;
+  // a stopped enumeration leaves its checkpoint to be resumed
+  if (!path.empty() && status.complete)
+    std::remove(path.c_str());
+  return shares.results();
 }
 
 }  // namespace nit
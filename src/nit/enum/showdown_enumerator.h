@@ -9,9 +9,23 @@
 #include <nit/eval/poker_hand_evaluator.h>
 
 #include "card_distribution.h"
+#include "dense_distribution.h"
+#include "enumeration_options.h"
+#include "showdown_visitor.h"
+#include "side_pot_visitor.h"
 
 namespace nit {
 
+/**
+ * The results of a showdown on several boards dealt from one deck, as
+ * when running it twice, or in double board games.  Each board is worth
+ * an equal part of the pot.
+ */
+struct MultiBoardResult {
+  std::vector<std::vector<EquityResult>> boards;  ///< [board][player]
+  std::vector<EquityResult> combined;  ///< the boards, weighted 1/N each
+};
+
 class ShowdownEnumerator {
  public:
   ShowdownEnumerator();
@@ -21,7 +35,78 @@ class ShowdownEnumerator {
    */
   std::vector<EquityResult> calculateEquity(
       const std::vector<CardDistribution>& dists, const CardSet& board,
-      const PokerHandEvaluator& peval) const;
+      const PokerHandEvaluator& peval,
+      const EnumerationOptions& options = EnumerationOptions()) const;
+
+  /**
+   * the same enumeration over dense distributions, the CardDistribution
+   * version converts its input and calls this one
+   */
+  std::vector<EquityResult> calculateEquity(
+      const std::vector<DenseDistribution>& dists, const CardSet& board,
+      const PokerHandEvaluator& peval,
+      const EnumerationOptions& options = EnumerationOptions()) const;
+
+  /**
+   * enumerate a poker scenario, counting the shares exactly.  All weights
+   * must be whole numbers, so the usual unweighted ranges qualify.  The
+   * results do not depend on the order of the enumeration, so they can be
+   * compared and combined bit for bit.  The results of all the shards
+   * of an enumeration add up to the result of the whole enumeration.
+   */
+  std::vector<ExactEquityResult> calculateExactEquity(
+      const std::vector<CardDistribution>& dists, const CardSet& board,
+      const PokerHandEvaluator& peval,
+      const EnumerationOptions& options = EnumerationOptions()) const;
+
+  std::vector<ExactEquityResult> calculateExactEquity(
+      const std::vector<DenseDistribution>& dists, const CardSet& board,
+      const PokerHandEvaluator& peval,
+      const EnumerationOptions& options = EnumerationOptions()) const;
+
+  /**
+   * enumerate a poker scenario, and hand every deal to a visitor, in
+   * blocks of deals with the hands already evaluated.  The visitor sees
+   * the deals of calculateEquity in the same order, so statistics which
+   * need more than the shares, by board or by hand type, take one pass.
+   */
+  void visit(const std::vector<CardDistribution>& dists, const CardSet& board,
+             const PokerHandEvaluator& peval, ShowdownVisitor& visitor,
+             const EnumerationOptions& options = EnumerationOptions()) const;
+
+  void visit(const std::vector<DenseDistribution>& dists, const CardSet& board,
+             const PokerHandEvaluator& peval, ShowdownVisitor& visitor,
+             const EnumerationOptions& options = EnumerationOptions()) const;
+
+  /**
+   * enumerate a showdown with side pots, awarding every pot from the same
+   * evaluations.  @returns the shares of each pot, [pot][player]
+   */
+  std::vector<std::vector<EquityResult>> calculatePotEquity(
+      const std::vector<CardDistribution>& dists, const CardSet& board,
+      const PokerHandEvaluator& peval, const std::vector<Pot>& pots,
+      const EnumerationOptions& options = EnumerationOptions()) const;
+
+  /**
+   * enumerate a showdown on several boards, dealt without replacement
+   * from the same deck.  The boards may share cards, the flop of a hand
+   * run twice from the turn, or be different from the start.  Each board
+   * is its own partition of the deal, so the deals are numbered as usual,
+   * and the enumeration can be sharded or watched like any other.
+   */
+  MultiBoardResult calculateMultiBoardEquity(
+      const std::vector<CardDistribution>& dists,
+      const std::vector<CardSet>& boards, const PokerHandEvaluator& peval,
+      const EnumerationOptions& options = EnumerationOptions()) const;
+
+  /**
+   * @returns a fingerprint of everything which determines the deals and
+   * shares of an enumeration, it identifies the query of a Checkpoint
+   */
+  static uint64_t fingerprint(const std::vector<DenseDistribution>& dists,
+                              const CardSet& board,
+                              const PokerHandEvaluator& peval,
+                              const Shard& shard = Shard());
 };
 
 }  // namespace nit
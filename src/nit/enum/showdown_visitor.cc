@@ -0,0 +1,19 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "showdown_visitor.h"
+
+namespace nit {
+
+void EquityVisitor::visit(const ShowdownBlock& block) {
+  for (size_t d = 0; d < block.size(); d++)
+    PokerHandEvaluator::awardShowdown(block.evaluations(d), block.players(),
+                                      m_results, block.weight(d));
+}
+
+bool EquityVisitor::decided(size_t winner, uint64_t ndeals, double weight) {
+  m_results[winner].winShares += weight * static_cast<double>(ndeals);
+  return true;
+}
+
+}  // namespace nit
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_SHOWDOWN_VISITOR_H_
+#define NIT_ENUM_SHOWDOWN_VISITOR_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+namespace nit {
+
+/**
+ * A batch of the deals of an enumeration, in the order they are dealt.
+ * Each deal has the completed hand of every player, the completed board,
+ * the evaluation of every hand against the board, and the weight of the
+ * tuple of hands it was dealt from.  The storage belongs to the
+ * enumerator and is reused from block to block, so a visitor copies what
+ * it wants to keep.
+ *
+ * The enumerator deals every hand into the same array, so the block keeps
+ * its own copy of each deal.  That is a few words next to the evaluation
+ * of every hand, and visiting with an EquityVisitor runs as fast as
+ * ShowdownEnumerator::calculateEquity.
+ */
+class ShowdownBlock {
+ public:
+  ShowdownBlock(size_t players, size_t capacity)
+      : m_players(players),
+        m_capacity(capacity),
+        m_size(0),
+        m_hands(players * capacity),
+        m_boards(capacity),
+        m_evals(players * capacity),
+        m_weights(capacity) {}
+
+  size_t players() const { return m_players; }  //!< hands per deal
+  size_t size() const { return m_size; }        //!< deals in the block
+  bool full() const { return m_size == m_capacity; }
+
+  const CardSet& hand(size_t deal, size_t player) const {
+    return m_hands[deal * m_players + player];
+  }
+  const CardSet& board(size_t deal) const { return m_boards[deal]; }
+
+  /// @returns the evaluations of all the players of a deal, in order
+  const PokerHandEvaluation* evaluations(size_t deal) const {
+    return &m_evals[deal * m_players];
+  }
+  const PokerHandEvaluation& evaluation(size_t deal, size_t player) const {
+    return m_evals[deal * m_players + player];
+  }
+  double weight(size_t deal) const { return m_weights[deal]; }
+
+  /// evaluate the hands of a deal against its board, and append it
+  void append(const PokerHandEvaluator& peval, const CardSet* hands,
+              const CardSet& board, double weight) {
+    size_t base = m_size * m_players;
+    for (size_t i = 0; i < m_players; i++) {
+      m_hands[base + i] = hands[i];
+      m_evals[base + i] = peval.evaluateHand(hands[i], board);
+    }
+    m_boards[m_size] = board;
+    m_weights[m_size] = weight;
+    m_size++;
+  }
+
+  void clear() { m_size = 0; }
+
+ private:
+  size_t m_players;
+  size_t m_capacity;
+  size_t m_size;
+  std::vector<CardSet> m_hands;  // [deal * players + player]
+  std::vector<CardSet> m_boards;
+  std::vector<PokerHandEvaluation> m_evals;  // [deal * players + player]
+  std::vector<double> m_weights;
+};
+
+/**
+ * Receives the deals of an enumeration, see ShowdownEnumerator::visit.
+ * The deals arrive a block at a time, so the cost of the virtual call is
+ * spread over a few hundred deals.
+ */
+class ShowdownVisitor {
+ public:
+  virtual ~ShowdownVisitor() = default;
+
+  virtual void visit(const ShowdownBlock& block) = 0;
+
+  /**
+   * called instead of dealing out a tuple of hands which one player wins
+   * on every board, see EnumerationOptions::pruneDecided.  A visitor which
+   * only needs the shares can credit them here in one go.
+   *
+   * @returns false to have the deals visited one by one after all
+   */
+  virtual bool decided(size_t /*winner*/, uint64_t /*ndeals*/,
+                       double /*weight*/) {
+    return false;
+  }
+};
+
+/**
+ * Sums the shares of every deal, the same results as
+ * ShowdownEnumerator::calculateEquity.
+ */
+class EquityVisitor : public ShowdownVisitor {
+ public:
+  explicit EquityVisitor(size_t players) : m_results(players) {}
+
+  void visit(const ShowdownBlock& block) override;
+  bool decided(size_t winner, uint64_t ndeals, double weight) override;
+
+  const std::vector<EquityResult>& results() const { return m_results; }
+
+ private:
+  std::vector<EquityResult> m_results;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_SHOWDOWN_VISITOR_H_
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "side_pot_visitor.h"
+
+#include <algorithm>
+#include <string>
+
+#include <nit/error.h>
+
+namespace nit {
+
+SidePotVisitor::SidePotVisitor(const std::vector<Pot>& pots, size_t players)
+    : m_pots(pots),
+      m_results(pots.size(), std::vector<EquityResult>(players)),
+      m_evals(players),
+      m_shares(players) {
+  if (pots.empty())
+    throw InvalidArgument("there must be at least one pot");
+  for (const Pot& pot : pots) {
+    if (pot.players.empty())
+      throw InvalidArgument("a pot has no players");
+    // the award buffers hold one entry per player
+    if (pot.players.size() > players)
+      throw InvalidArgument("a pot has more players than are dealt in")
+          << errinfo_value(std::to_string(pot.players.size()));
+    std::vector<bool> seen(players, false);
+    for (size_t player : pot.players) {
+      if (player >= players)
+        throw InvalidArgument("a pot has a player who is not dealt in")
+            << errinfo_value(std::to_string(player));
+      if (seen[player])
+        throw InvalidArgument("a pot has a player more than once")
+            << errinfo_value(std::to_string(player));
+      seen[player] = true;
+    }
+  }
+}
+
+void SidePotVisitor::visit(const ShowdownBlock& block) {
+  for (size_t d = 0; d < block.size(); d++) {
+    for (size_t p = 0; p < m_pots.size(); p++) {
+      const std::vector<size_t>& players = m_pots[p].players;
+      const size_t n = players.size();
+      for (size_t i = 0; i < n; i++) {
+        m_evals[i] = block.evaluation(d, players[i]);
+        m_shares[i] = EquityResult();
+      }
+      PokerHandEvaluator::awardShowdown(m_evals.data(), n, m_shares,
+                                        block.weight(d));
+      for (size_t i = 0; i < n; i++)
+        m_results[p][players[i]] += m_shares[i];
+    }
+  }
+}
+
+bool SidePotVisitor::decided(size_t winner, uint64_t ndeals, double weight) {
+  // the winner takes every pot only if eligible for all of them
+  for (const Pot& pot : m_pots)
+    if (std::find(pot.players.begin(), pot.players.end(), winner) ==
+        pot.players.end())
+      return false;
+  for (std::vector<EquityResult>& pot : m_results)
+    pot[winner].winShares += weight * static_cast<double>(ndeals);
+  return true;
+}
+
+std::vector<double> SidePotVisitor::winnings() const {
+  std::vector<double> won(m_evals.size(), 0.0);
+  for (size_t p = 0; p < m_pots.size(); p++) {
+    double total = 0.0;
+    for (const EquityResult& result : m_results[p])
+      total += result.winShares + result.tieShares;
+    if (total == 0.0)
+      continue;
+    for (size_t i = 0; i < won.size(); i++)
+      won[i] += m_pots[p].amount *
+                (m_results[p][i].winShares + m_results[p][i].tieShares) /
+                total;
+  }
+  return won;
+}
+
+}  // namespace nit
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_SIDE_POT_VISITOR_H_
+#define NIT_ENUM_SIDE_POT_VISITOR_H_
+
+#include <vector>
+
+#include "showdown_visitor.h"
+
+namespace nit {
+
+/**
+ * A pot, and the players who can win it.  With uneven all in stacks the
+ * main pot is contested by everyone, and each side pot only by the
+ * players who covered it.
+ */
+struct Pot {
+  double amount{1.0};
+  std::vector<size_t> players;  ///< indices of the eligible players
+};
+
+/**
+ * Awards every pot from the same evaluations, so a showdown with side
+ * pots takes one enumeration, rather than one per set of players.  The
+ * shares of each pot are kept apart, results()[pot][player], and a
+ * player who can not win a pot gets no shares of it.
+ */
+class SidePotVisitor : public ShowdownVisitor {
+ public:
+  SidePotVisitor(const std::vector<Pot>& pots, size_t players);
+
+  void visit(const ShowdownBlock& block) override;
+  bool decided(size_t winner, uint64_t ndeals, double weight) override;
+
+  const std::vector<std::vector<EquityResult>>& results() const {
+    return m_results;
+  }
+
+  /// @returns the expected amount each player wins, over all the pots
+  std::vector<double> winnings() const;
+
+ private:
+  std::vector<Pot> m_pots;
+  std::vector<std::vector<EquityResult>> m_results;  // [pot][player]
+  std::vector<PokerHandEvaluation> m_evals;          // of one pot
+  std::vector<EquityResult> m_shares;                // of one pot
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_SIDE_POT_VISITOR_H_
@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "street_cache.h"
+
+#include <nit/util/lastbit.h>
+
+#include "dense_distribution.h"
+#include "showdown_enumerator.h"
+#include "showdown_visitor.h"
+
+namespace nit {
+
+namespace {
+
+/**
+ * Sums the shares of every deal by turn card.  A deal with two cards to
+ * come counts for both of them, either one may be the turn, and so the
+ * deals by turn card are the deals of each turn query.
+ */
+class TurnVisitor : public ShowdownVisitor {
+ public:
+  TurnVisitor(size_t players, const CardSet& board)
+      : m_board(board),
+        m_totals(players),
+        m_turns(STANDARD_DECK_SIZE * players),
+        m_deals(STANDARD_DECK_SIZE),
+        m_shares(players) {}
+
+  void visit(const ShowdownBlock& block) override {
+    const size_t players = block.players();
+    for (size_t d = 0; d < block.size(); d++) {
+      for (EquityResult& share : m_shares)
+        share = EquityResult();
+      PokerHandEvaluator::awardShowdown(block.evaluations(d), players,
+                                        m_shares, block.weight(d));
+      for (uint64_t runout = (block.board(d) ^ m_board).mask(); runout;
+           runout &= runout - 1) {
+        size_t turn = static_cast<size_t>(lastbit(runout));
+        for (size_t i = 0; i < players; i++)
+          m_turns[turn * players + i] += m_shares[i];
+        m_deals[turn]++;
+      }
+      for (size_t i = 0; i < players; i++)
+        m_totals[i] += m_shares[i];
+    }
+  }
+
+  std::vector<EquityResult>& totals() { return m_totals; }
+  std::vector<EquityResult>& turns() { return m_turns; }
+  std::vector<uint64_t>& deals() { return m_deals; }
+
+ private:
+  CardSet m_board;
+  std::vector<EquityResult> m_totals;
+  std::vector<EquityResult> m_turns;
+  std::vector<uint64_t> m_deals;
+  std::vector<EquityResult> m_shares;
+};
+
+/// report a query answered from the cache, it had deals deals
+void complete(const EnumerationOptions& options, uint64_t deals) {
+  if (options.progress)
+    options.progress(1.0);
+  if (options.status) {
+    options.status->complete = true;
+    options.status->position = deals;
+    options.status->fraction = 1.0;
+  }
+}
+
+}  // namespace
+
+StreetCache::StreetCache(size_t capacity)
+    : m_capacity(capacity), m_hits(0), m_misses(0) {}
+
+const StreetCache::Entry* StreetCache::find(uint64_t query) {
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+    if (it->query == query) {
+      m_entries.splice(m_entries.begin(), m_entries, it);
+      return &m_entries.front();
+    }
+  }
+  return nullptr;
+}
+
+std::vector<EquityResult> StreetCache::calculateEquity(
+    const std::vector<CardDistribution>& dists, const CardSet& board,
+    const PokerHandEvaluator& peval, const EnumerationOptions& options) {
+  ShowdownEnumerator enumerator;
+  const size_t tocome =
+      board.size() < peval.boardSize() ? peval.boardSize() - board.size() : 0;
+  if (m_capacity == 0 || options.shard.count != 1 ||
+      !options.checkpointFile.empty() || options.distribution ||
+      tocome == 0 || tocome > 2)
+    return enumerator.calculateEquity(dists, board, peval, options);
+
+  std::vector<DenseDistribution> dense;
+  for (const CardDistribution& dist : dists)
+    dense.emplace_back(dist);
+  const size_t players = dense.size();
+
+  if (tocome == 1) {
+    // the turn, if the flop under any of its cards is kept
+    for (uint64_t cards = board.mask(); cards; cards &= cards - 1) {
+      const uint64_t turn = cards & (~cards + 1);
+      const Entry* entry = find(ShowdownEnumerator::fingerprint(
+          dense, CardSet(board.mask() ^ turn), peval));
+      if (entry) {
+        m_hits++;
+        const size_t card = static_cast<size_t>(lastbit(turn));
+        complete(options, entry->turnDeals[card]);
+        return std::vector<EquityResult>(
+            entry->turns.begin() + card * players,
+            entry->turns.begin() + (card + 1) * players);
+      }
+    }
+    m_misses++;
+    return enumerator.calculateEquity(dense, board, peval, options);
+  }
+
+  const uint64_t query = ShowdownEnumerator::fingerprint(dense, board, peval);
+  if (const Entry* entry = find(query)) {
+    m_hits++;
+    complete(options, entry->deals);
+    return entry->totals;
+  }
+  m_misses++;
+
+  // keep the flop only if the enumeration ran to the end
+  EnumerationStatus status;
+  EnumerationOptions run = options;
+  run.status = &status;
+  TurnVisitor visitor(players, board);
+  enumerator.visit(dense, board, peval, visitor, run);
+  if (options.status)
+    *options.status = status;
+  if (!status.complete)
+    return visitor.totals();
+
+  if (m_entries.size() >= m_capacity)
+    m_entries.pop_back();
+  m_entries.push_front(Entry());
+  Entry& entry = m_entries.front();
+  entry.query = query;
+  entry.deals = status.position;
+  entry.turnDeals.swap(visitor.deals());
+  entry.totals.swap(visitor.totals());
+  entry.turns.swap(visitor.turns());
+  return entry.totals;
+}
+
+}  // namespace nit
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_ENUM_STREET_CACHE_H_
+#define NIT_ENUM_STREET_CACHE_H_
+
+#include <cstdint>
+
+#include <list>
+#include <vector>
+
+#include <nit/eval/poker_hand_evaluator.h>
+
+#include "card_distribution.h"
+#include "enumeration_options.h"
+
+namespace nit {
+
+/**
+ * Answers the same hands street after street.  When a query has two
+ * board cards to come, the shares are also kept by turn card: the deals
+ * of the turn query for a card are exactly the deals of the flop query
+ * with that card on the board, so the turn is answered from the flop
+ * without dealing again, and the river, with one board to evaluate per
+ * tuple, is cheap to enumerate anyway.
+ *
+ * At most capacity flops are kept, the least recently used one is
+ * dropped first, so the memory stays bounded whatever the stream of
+ * queries.  A flop costs a few kilobytes per player.
+ */
+class StreetCache {
+ public:
+  explicit StreetCache(size_t capacity = 64);
+
+  /**
+   * the shares of ShowdownEnumerator::calculateEquity, from the cache if
+   * the query is the turn of a cached flop.  Sharded and checkpointed
+   * queries are passed straight through, and so are stopped ones and
+   * those which take an equity distribution.  A
+   * query answered from the cache reports itself complete, with the
+   * deals it would have enumerated.
+   */
+  std::vector<EquityResult> calculateEquity(
+      const std::vector<CardDistribution>& dists, const CardSet& board,
+      const PokerHandEvaluator& peval,
+      const EnumerationOptions& options = EnumerationOptions());
+
+  size_t size() const { return m_entries.size(); }  //!< flops kept
+  size_t capacity() const { return m_capacity; }
+  uint64_t hits() const { return m_hits; }
+  uint64_t misses() const { return m_misses; }
+
+  void clear() { m_entries.clear(); }
+
+ private:
+  struct Entry {
+    uint64_t query;                    // the fingerprint of the flop
+    std::vector<EquityResult> totals;  // [player]
+    std::vector<EquityResult> turns;   // [turn card * players + player]
+    uint64_t deals;                    // of the flop
+    std::vector<uint64_t> turnDeals;   // [turn card]
+  };
+
+  /// @returns the entry of a query, made the most recent, or nullptr
+  const Entry* find(uint64_t query);
+
+  size_t m_capacity;
+  std::list<Entry> m_entries;  // most recently used first
+  uint64_t m_hits;
+  uint64_t m_misses;
+};
+
+}  // namespace nit
+
+#endif  // NIT_ENUM_STREET_CACHE_H_
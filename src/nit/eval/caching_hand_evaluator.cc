@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "caching_hand_evaluator.h"
+
+#include <nit/error.h>
+
+namespace nit {
+
+namespace {
+
+const size_t kWays = 4;
+
+/// no hand has every bit set, so this marks an empty entry
+const uint64_t kEmpty = ~UINT64_C(0);
+
+}  // namespace
+
+CachingHandEvaluator::CachingHandEvaluator(const PokerHandEvaluator& inner,
+                                           size_t capacity)
+    : m_inner(inner),
+      m_mutable(nullptr),
+      m_setMask(0),
+      m_hits(0),
+      m_misses(0) {
+  size_t sets = 1;
+  while (sets * kWays < capacity)
+    sets <<= 1;
+  m_setMask = sets - 1;
+  m_entries.resize(sets * kWays);
+  clear();
+}
+
+CachingHandEvaluator::CachingHandEvaluator(PokerHandEvaluator& inner,
+                                           size_t capacity)
+    : CachingHandEvaluator(static_cast<const PokerHandEvaluator&>(inner),
+                           capacity) {
+  m_mutable = &inner;
+}
+
+void CachingHandEvaluator::setNumDraws(size_t sz) {
+  if (!m_mutable)
+    throw LogicError("the cached evaluator can not be changed");
+  m_mutable->setNumDraws(sz);
+  clear();
+}
+
+void CachingHandEvaluator::clear() {
+  for (Entry& entry : m_entries) {
+    entry.hand = kEmpty;
+    entry.board = kEmpty;
+  }
+  m_hits = 0;
+  m_misses = 0;
+}
+
+PokerHandEvaluation CachingHandEvaluator::evaluateHand(
+    const CardSet& hand, const CardSet& board) const {
+  const uint64_t h = hand.mask();
+  const uint64_t b = board.mask();
+  // the high bits of the products mix every card into the set index
+  uint64_t hash = h * UINT64_C(0x9e3779b97f4a7c15) ^
+                  b * UINT64_C(0xc2b2ae3d27d4eb4f);
+  Entry* set = &m_entries[((hash >> 32) & m_setMask) * kWays];
+
+  for (size_t w = 0; w < kWays; w++) {
+    if (set[w].hand == h && set[w].board == b) {
+      m_hits++;
+      Entry found = set[w];
+      for (; w > 0; w--)
+        set[w] = set[w - 1];
+      set[0] = found;
+      return found.eval;
+    }
+  }
+
+  m_misses++;
+  for (size_t w = kWays - 1; w > 0; w--)
+    set[w] = set[w - 1];
+  set[0].hand = h;
+  set[0].board = b;
+  set[0].eval = m_inner.evaluateHand(hand, board);
+  return set[0].eval;
+}
+
+}  // namespace nit
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_EVAL_CACHING_HAND_EVALUATOR_H_
+#define NIT_EVAL_CACHING_HAND_EVALUATOR_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include "poker_hand_evaluator.h"
+
+namespace nit {
+
+/**
+ * Remembers the evaluations of another evaluator.  An enumeration over
+ * ranges evaluates the same hand on the same board once for every tuple
+ * of the other hands, and for omaha and the universal evaluators each of
+ * those evaluations is much dearer than a lookup.
+ *
+ * The cache is set associative with four ways, and keyed on both the
+ * hand and the board masks, since in omaha the cards of the hand and the
+ * board do not play alike.  It holds a fixed number of evaluations, so
+ * its memory is bounded, and a set drops its least recently used entry.
+ * The evaluator is not thread safe, use one per thread.
+ *
+ * Every other method goes to the inner evaluator, so the cache behaves
+ * as the evaluator it wraps.  The inner evaluate, eval and setNumDraws
+ * are not const, so they are only reached when the evaluator is wrapped
+ * by a mutable reference.  Otherwise evaluate and eval go through the
+ * cache as the base class does, and setNumDraws throws LogicError.
+ */
+class CachingHandEvaluator : public PokerHandEvaluator {
+ public:
+  /// the capacity is rounded up to a whole number of sets
+  explicit CachingHandEvaluator(const PokerHandEvaluator& inner,
+                                size_t capacity = 1 << 16);
+  explicit CachingHandEvaluator(PokerHandEvaluator& inner,
+                                size_t capacity = 1 << 16);
+
+  PokerHandEvaluation evaluateHand(
+      const CardSet& hand, const CardSet& board = CardSet(0)) const override;
+
+  PokerHandEvaluation evaluate(const CardSet& hand,
+                               const CardSet& board = CardSet(0)) override {
+    return m_mutable ? m_mutable->evaluate(hand, board)
+                     : evaluateHand(hand, board);
+  }
+  PokerEvaluation eval(const CardSet& hand,
+                       const CardSet& board = CardSet(0)) override {
+    return m_mutable ? m_mutable->eval(hand, board)
+                     : evaluateHand(hand, board).high();
+  }
+
+  PokerEvaluation evaluateRanks(
+      const CardSet& hand, const CardSet& board = CardSet(0)) const override {
+    return m_inner.evaluateRanks(hand, board);
+  }
+  PokerEvaluation evaluateSuits(
+      const CardSet& hand, const CardSet& board = CardSet(0)) const override {
+    return m_inner.evaluateSuits(hand, board);
+  }
+  int highTypeBound(const CardSet& hand, const CardSet& board, size_t ncards,
+                    const CardSet& dead) const override {
+    return m_inner.highTypeBound(hand, board, ncards, dead);
+  }
+
+  size_t handSize() const override { return m_inner.handSize(); }
+  size_t boardSize() const override { return m_inner.boardSize(); }
+  size_t evaluationSize() const override { return m_inner.evaluationSize(); }
+  size_t numDraws() const override { return m_inner.numDraws(); }
+  bool usesSuits() const override { return m_inner.usesSuits(); }
+
+  /// the draws change the evaluations, so the cache is cleared
+  void setNumDraws(size_t sz) override;
+
+  const PokerHandEvaluator& inner() const { return m_inner; }
+  size_t capacity() const { return m_entries.size(); }
+  uint64_t hits() const { return m_hits; }
+  uint64_t misses() const { return m_misses; }
+
+  void clear();  //!< forget every evaluation, and reset the counters
+
+ private:
+  struct Entry {
+    uint64_t hand;
+    uint64_t board;
+    PokerHandEvaluation eval;
+  };
+
+  const PokerHandEvaluator& m_inner;
+  PokerHandEvaluator* m_mutable;  // the same as m_inner, if not const
+  uint64_t m_setMask;
+  mutable std::vector<Entry> m_entries;  // [set * ways + way], newest first
+  mutable uint64_t m_hits;
+  mutable uint64_t m_misses;
+};
+
+}  // namespace nit
+
+#endif  // NIT_EVAL_CACHING_HAND_EVALUATOR_H_
@@ -1162,6 +1162,85 @@ int CardSet::evaluateStraightOuts() const {
   return 0;
 }
 
+int CardSet::highTypeBound(size_t ncards, const CardSet& dead) const {
+  const int k = static_cast<int>(ncards);
+  const int nranks = Rank::NUM_RANK;
+  const uint64_t live = ~(m_cardmask | dead.m_cardmask) &
+                        ~(0xffffffffffffffff << STANDARD_DECK_SIZE);
+  const int suits[4] = {C(), D(), H(), S()};
+  int liveSuits[4];
+  for (int s = 0; s < 4; s++)
+    liveSuits[s] = static_cast<int>(live >> (s * nranks)) & 0x1FFF;
+  const int liveRanks =
+      liveSuits[0] | liveSuits[1] | liveSuits[2] | liveSuits[3];
+
+  // the number of cards missing from a window of five ranks, or more
+  // than ncards if one of the missing ranks has no live cards
+  auto missing = [k](int held, int avail, int window) {
+    int need = window & ~held;
+    if (need & ~avail)
+      return k + 1;
+    return static_cast<int>(nRanksTable[need]);
+  };
+  auto straight = [k, &missing](int held, int avail) {
+    // the wheel, and then five to ace high
+    if (missing(held, avail, 0x100F) <= k)
+      return true;
+    for (int window = 0x1F; window <= 0x1F00; window <<= 1)
+      if (missing(held, avail, window) <= k)
+        return true;
+    return false;
+  };
+
+  for (int s = 0; s < 4; s++)
+    if (straight(suits[s], liveSuits[s]))
+      return STRAIGHT_FLUSH;
+
+  // the cards held of each rank, and the cards needed to hold m of a rank
+  int counts[nranks];
+  int lives[nranks];
+  for (int r = 0; r < nranks; r++) {
+    counts[r] = 0;
+    lives[r] = 0;
+    for (int s = 0; s < 4; s++) {
+      counts[r] += (suits[s] >> r) & 1;
+      lives[r] += (liveSuits[s] >> r) & 1;
+    }
+  }
+  auto need = [&counts, &lives, k](int r, int m) {
+    int n = std::max(0, m - counts[r]);
+    return n <= lives[r] ? n : k + 1;
+  };
+
+  int best = NO_PAIR;
+  for (int r = 0; r < nranks; r++) {
+    if (need(r, 4) <= k)
+      return FOUR_OF_A_KIND;
+    for (int q = 0; q < nranks; q++) {
+      if (q == r)
+        continue;
+      if (need(r, 3) + need(q, 2) <= k)
+        best = FULL_HOUSE;
+      else if (need(r, 2) + need(q, 2) <= k)
+        best = std::max(best, TWO_PAIR);
+    }
+    if (need(r, 3) <= k)
+      best = std::max(best, THREE_OF_A_KIND);
+    else if (need(r, 2) <= k)
+      best = std::max(best, ONE_PAIR);
+  }
+  if (best == FULL_HOUSE)
+    return best;
+  for (int s = 0; s < 4; s++)
+    if (static_cast<int>(nRanksTable[suits[s]]) +
+            std::min(k, static_cast<int>(nRanksTable[liveSuits[s]])) >=
+        5)
+      return FLUSH;
+  if (straight(RMASK(), liveRanks))
+    return STRAIGHT;
+  return best;
+}
+
 // original version in r2488
 size_t CardSet::rankColex() const {
   size_t ret = 0;
@@ -1224,14 +1303,34 @@ CardSet canonizeToBoard(const CardSet& board, const CardSet& hand) {
 #undef RMASK
 #undef SUITMASK
 
+namespace {
+
+/// Pascal's triangle for colex indexing, n choose k for n, k <= 52.
+class BinomialTable {
+ public:
+  BinomialTable() {
+    for (size_t n = 0; n <= STANDARD_DECK_SIZE; n++) {
+      m_table[n][0] = 1;
+      for (size_t k = 1; k <= STANDARD_DECK_SIZE; k++)
+        m_table[n][k] = n == 0 ? 0 : m_table[n - 1][k - 1] + m_table[n - 1][k];
+    }
+  }
+
+  size_t operator()(size_t n, size_t k) const { return m_table[n][k]; }
+
+ private:
+  size_t m_table[STANDARD_DECK_SIZE + 1][STANDARD_DECK_SIZE + 1];
+};
+
+}  // namespace
+
 size_t CardSet::colex() const {
-  std::vector<Card> cards = this->cards();
+  static const BinomialTable choose;
+  uint64_t v = m_cardmask;
   size_t value = 0;
-  for (size_t i = 0; i < cards.size(); i++) {
-    size_t code = cards[i].code();
-    if (code >= i + 1)
-      value += static_cast<size_t>(
-          boost::math::binomial_coefficient<double>(code, i + 1));
+  for (size_t i = 1; v; i++) {
+    value += choose(lastbit(v), i);
+    v &= v - 1;  // clear the least significant bit set
   }
   return value;
 }
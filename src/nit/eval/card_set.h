@@ -159,6 +159,15 @@ class CardSet {
    */
   int evaluateStraightOuts() const;
 
+  /**
+   * An upper bound on the type of the high hand, NO_PAIR through
+   * STRAIGHT_FLUSH, these cards can make with ncards more cards, drawn
+   * from the cards in neither this set nor dead.  Each type is checked on
+   * its own against the ranks and suits still live, so it is cheap, and
+   * only ever too high.
+   */
+  int highTypeBound(size_t ncards, const CardSet& dead = CardSet()) const;
+
   // overloaded operators, syntactic sugar. It is no secret that
   // this is a bitset, so exposing bit operations should be ok.
   // one thing that should be considered is implementing the &=, etc
@@ -36,6 +36,11 @@ class HoldemHandEvaluator : public PokerHandEvaluator {
     return h.evaluateHighFlush();
   }
 
+  int highTypeBound(const CardSet& hand, const CardSet& board, size_t ncards,
+                    const CardSet& dead) const override {
+    return (hand | board).highTypeBound(ncards, dead);
+  }
+
   size_t handSize() const override { return NUM_HOLDEM_POCKET; }
   size_t boardSize() const override { return BOARD_SIZE; }
   size_t evaluationSize() const override { return 1; }
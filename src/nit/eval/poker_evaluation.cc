@@ -3,6 +3,7 @@
  */
 #include "poker_evaluation.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include <boost/format.hpp>
@@ -75,48 +76,37 @@ int PokerEvaluation::reducedCode2to7() const {
     }
 
     case THREE_OF_A_KIND: {
-      PokerEvaluation e(m_evalcode);
-      std::vector<int> ranks(3);
-      ranks[0] = botRankTable[kickerBits()];
-      ranks[1] = botRankTable[kickerBits() ^ 0x01 << ranks[0]];
-      ranks[2] = e.majorRank().code();
-      sort(ranks.begin(), ranks.end());
-      e = PokerEvaluation((TWO_PAIR << VSHIFT) ^ (ranks[2] << MAJOR_SHIFT) ^
-                          (ranks[1] << MINOR_SHIFT) ^ (0x01 << ranks[0]));
-      e.flip();
-      return e.code();
+      // the trips and the two low kickers make two pair, low to high
+      int kickers = kickerBits();
+      int low = botRankTable[kickers];
+      int next = botRankTable[kickers ^ 0x01 << low];
+      int ranks =
+          (0x01 << low) | (0x01 << next) | (0x01 << majorRank().code());
+      return flippedTwoPair(ranks);
     }
 
     case ONE_PAIR: {
-      PokerEvaluation e(m_evalcode);
-      std::vector<int> ranks(4);
-      uint16_t kickers = kickerBits();
-      ranks[0] = lastbit(kickers);
-      kickers ^= 0x01 << ranks[0];
-      ranks[1] = lastbit(kickers);
-      kickers ^= 0x01 << ranks[1];
-      ranks[2] = lastbit(kickers);
-      kickers ^= 0x01 << ranks[2];
-      ranks[3] = e.majorRank().code();
-      sort(ranks.begin(), ranks.end());
-      e = PokerEvaluation((ONE_PAIR << VSHIFT) ^ (ranks[2] << MAJOR_SHIFT) ^
-                          (0x01 << ranks[0]) ^ (0x01 << ranks[1]));
+      // the pair and the three low kickers, the third lowest plays as the pair
+      int kickers = kickerBits();
+      int ranks = 0x01 << majorRank().code();
+      for (int i = 0; i < 3; i++) {
+        int low = lastbit(static_cast<uint16_t>(kickers));
+        ranks |= 0x01 << low;
+        kickers ^= 0x01 << low;
+      }
+      int first = botRankTable[ranks];
+      int second = botRankTable[ranks ^ 0x01 << first];
+      int third = botRankTable[ranks ^ 0x01 << first ^ 0x01 << second];
+      PokerEvaluation e((ONE_PAIR << VSHIFT) ^ (third << MAJOR_SHIFT) ^
+                        (0x01 << first) ^ (0x01 << second));
       e.flip();
       return e.code();
     }
 
     case TWO_PAIR: {
-      PokerEvaluation e(m_evalcode);
-      std::vector<int> ranks(3);
-      uint16_t kickers = kickerBits();
-      ranks[0] = lastbit(kickers);
-      ranks[1] = e.minorRank().code();
-      ranks[2] = e.majorRank().code();
-      sort(ranks.begin(), ranks.end());
-      e = PokerEvaluation((TWO_PAIR << VSHIFT) ^ (ranks[2] << MAJOR_SHIFT) ^
-                          (ranks[1] << MINOR_SHIFT) ^ (0x01 << ranks[0]));
-      e.flip();
-      return e.code();
+      int ranks = (0x01 << lastbit(static_cast<uint16_t>(kickerBits()))) |
+                  (0x01 << minorRank().code()) | (0x01 << majorRank().code());
+      return flippedTwoPair(ranks);
     }
 
     case FLUSH: {
@@ -129,25 +119,19 @@ int PokerEvaluation::reducedCode2to7() const {
     }
 
     case FULL_HOUSE: {
-      PokerEvaluation e(m_evalcode);
-      std::vector<int> ranks(2);
-      ranks[0] = e.minorRank().code();
-      ranks[1] = e.majorRank().code();
-      sort(ranks.begin(), ranks.end());
-      e = PokerEvaluation((FULL_HOUSE << VSHIFT) ^ (ranks[1] << MAJOR_SHIFT) ^
-                          (ranks[0] << MINOR_SHIFT));
+      int major = majorRank().code();
+      int minor = minorRank().code();
+      PokerEvaluation e((FULL_HOUSE << VSHIFT) ^
+                        (std::max(major, minor) << MAJOR_SHIFT) ^
+                        (std::min(major, minor) << MINOR_SHIFT));
       e.flip();
       return e.code();
     }
 
     case FOUR_OF_A_KIND: {
-      PokerEvaluation e(m_evalcode);
-      std::vector<int> ranks(2);
-      uint16_t kickers = kickerBits();
-      ranks[0] = lastbit(kickers);
-      ranks[1] = e.majorRank().code();
-      e = PokerEvaluation((FOUR_OF_A_KIND << VSHIFT) ^
-                          (ranks[1] << MAJOR_SHIFT) ^ (0x01 << ranks[0]));
+      PokerEvaluation e(
+          (FOUR_OF_A_KIND << VSHIFT) ^ (majorRank().code() << MAJOR_SHIFT) ^
+          (0x01 << lastbit(static_cast<uint16_t>(kickerBits()))));
       e.flip();
       return e.code();
     }
@@ -157,6 +141,16 @@ int PokerEvaluation::reducedCode2to7() const {
   }
 }
 
+int PokerEvaluation::flippedTwoPair(int ranks) {
+  int top = topRankTable[ranks];
+  int bottom = botRankTable[ranks];
+  int middle = topRankTable[ranks ^ 0x01 << top];
+  PokerEvaluation e((TWO_PAIR << VSHIFT) ^ (top << MAJOR_SHIFT) ^
+                    (middle << MINOR_SHIFT) ^ (0x01 << bottom));
+  e.flip();
+  return e.code();
+}
+
 int PokerEvaluation::showdownCode() const {
   if (m_evalcode == 0)
     return 0;
@@ -69,6 +69,8 @@ class PokerEvaluation {
   /**
    * Reduce the showdown code significantly.  For hands which use
    * multiple kickers, only the two most significant kickers are included.
+   * The ranks are sorted with the rank tables, so this is cheap enough to
+   * use as a coarse feature in inner loops.
    */
   int reducedCode2to7() const;
 
@@ -144,6 +146,9 @@ class PokerEvaluation {
   void playAceHigh();
   bool acePlaysLow() const;
 
+  // the flipped two pair code of three distinct ranks, in a rank mask
+  static int flippedTwoPair(int ranks);
+
   // the "low" evaluations get flipped so that best hand ordering is
   // maintained
   void flip() { m_evalcode = INT_MAX - m_evalcode; }
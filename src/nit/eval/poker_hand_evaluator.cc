@@ -11,27 +11,38 @@ PokerHandEvaluator::~PokerHandEvaluator() = default;
 static double INV_LUT[] = {0,       1 / 1.0, 1 / 2.0, 1 / 3.0, 1 / 4.0, 1 / 5.0,
                            1 / 6.0, 1 / 7.0, 1 / 8.0, 1 / 9.0, 1 / 10.0};
 
-void PokerHandEvaluator::evaluateShowdown(
-    const std::vector<CardSet>& hands, const CardSet& board,
-    std::vector<PokerHandEvaluation>& evals, std::vector<EquityResult>& result,
-    double weight) const {
-  // this is a special trick we use.  the hands vector could actually
-  // contain hands [0..n],board because of the way we step through the
-  // ParitionEnumerator, however, the size evals vector *must* be equal to
-  // the number of hands, board or not.  So we use the size of the evals
-  // here, not the size of the hand vector
-  size_t hsize = evals.size();
-  size_t nevals = 1;
+uint64_t exactScale(size_t nhands, size_t nevals) {
+  uint64_t scale = 1;
+  for (uint64_t k = 2; k <= nhands; k++) {
+    uint64_t a = scale, b = k;
+    while (b != 0) {
+      uint64_t t = a % b;
+      a = b;
+      b = t;
+    }
+    scale = scale / a * k;
+  }
+  return scale * nevals;
+}
+
+namespace {
 
-  // gather all the evaluations
+/**
+ * Award the shares of a showdown of hsize evaluated hands, award(k) is
+ * the share of a k way split.
+ */
+template <class Result, class Award>
+void awardEvaluations(const PokerHandEvaluation* evals, size_t hsize,
+                      std::vector<Result>& result, const Award& award) {
+  // we track whether or not an eval is used in the nevals variable to
+  // avoid looping through the low half of split pot games when no one has
+  // a low.  This only covers games which have one or two pots.
+  size_t nevals = 1;
   for (size_t i = 0; i < hsize; i++) {
-    // we track whether or not an eval is used in the nevals
-    // variable to avoid looping through the low half of split
-    // pot games when no one has a low.  This only covers games
-    // which have one or two pots.
-    evals[i] = evaluateHand(hands[i], board);
-    if (nevals == 1 && evals[i].eval(1) > PokerEvaluation(0))
+    if (evals[i].eval(1) > PokerEvaluation(0)) {
       nevals = 2;
+      break;
+    }
   }
 
   // award share(s)
@@ -52,15 +63,58 @@ void PokerHandEvaluator::evaluateShowdown(
     }
     // award shares to the winner, or...
     if (shares == 1) {
-      result[winner].winShares += INV_LUT[nevals] * weight;
+      result[winner].winShares += award(nevals);
     }
     // award shares to those who tie
     else {
       for (size_t i = 0; i < hsize; i++)
         if (evals[i].eval(e) == maxeval)
-          result[i].tieShares += INV_LUT[shares * nevals] * weight;
+          result[i].tieShares += award(shares * nevals);
     }
   }
 }
 
+/// Evaluate the hands of a showdown, and award its shares.
+template <class Result, class Award>
+void evaluateAndAward(const PokerHandEvaluator& peval,
+                      const std::vector<CardSet>& hands, const CardSet& board,
+                      std::vector<PokerHandEvaluation>& evals,
+                      std::vector<Result>& result, const Award& award) {
+  // this is a special trick we use.  the hands vector could actually
+  // contain hands [0..n],board because of the way we step through the
+  // ParitionEnumerator, however, the size evals vector *must* be equal to
+  // the number of hands, board or not.  So we use the size of the evals
+  // here, not the size of the hand vector
+  size_t hsize = evals.size();
+  for (size_t i = 0; i < hsize; i++)
+    evals[i] = peval.evaluateHand(hands[i], board);
+  awardEvaluations(evals.data(), hsize, result, award);
+}
+
+}  // namespace
+
+void PokerHandEvaluator::evaluateShowdown(
+    const std::vector<CardSet>& hands, const CardSet& board,
+    std::vector<PokerHandEvaluation>& evals, std::vector<EquityResult>& result,
+    double weight) const {
+  evaluateAndAward(*this, hands, board, evals, result,
+                   [weight](size_t k) { return INV_LUT[k] * weight; });
+}
+
+void PokerHandEvaluator::evaluateShowdown(
+    const std::vector<CardSet>& hands, const CardSet& board,
+    std::vector<PokerHandEvaluation>& evals,
+    std::vector<ExactEquityResult>& result, const uint64_t* split) const {
+  evaluateAndAward(*this, hands, board, evals, result,
+                   [split](size_t k) { return UInt128(split[k]); });
+}
+
+void PokerHandEvaluator::awardShowdown(const PokerHandEvaluation* evals,
+                                       size_t nhands,
+                                       std::vector<EquityResult>& result,
+                                       double weight) {
+  awardEvaluations(evals, nhands, result,
+                   [weight](size_t k) { return INV_LUT[k] * weight; });
+}
+
 }  // namespace nit
@@ -10,6 +10,7 @@
 #include <boost/noncopyable.hpp>
 
 #include <nit/error.h>
+#include <nit/util/uint128.h>
 
 #include "card_set.h"
 #include "poker_hand_evaluation.h"
@@ -44,6 +45,46 @@ struct EquityResult {
   }
 };
 
+/**
+ * An equity result counted exactly in integers.  The shares are scaled
+ * by scale, a common multiple of every denominator a pot can be split
+ * into, so every share is a whole number and the sum does not depend on
+ * the order it was taken in.  Results are only added to results with the
+ * same scale.
+ */
+struct ExactEquityResult {
+  UInt128 winShares;
+  UInt128 tieShares;
+  uint64_t scale{1};
+
+  ExactEquityResult() = default;
+
+  ExactEquityResult& operator+=(const ExactEquityResult& other) {
+    winShares += other.winShares;
+    tieShares += other.tieShares;
+    return *this;
+  }
+
+  /// @returns the shares divided by the scale
+  EquityResult toEquityResult() const {
+    EquityResult result;
+    result.winShares = winShares.toDouble() / static_cast<double>(scale);
+    result.tieShares = tieShares.toDouble() / static_cast<double>(scale);
+    return result;
+  }
+
+  std::string str() const {
+    return winShares.str() + " " + tieShares.str() + " " +
+           std::to_string(scale);
+  }
+};
+
+/**
+ * @returns the least common multiple of the ways a pot can be split in a
+ * showdown of nhands hands with nevals pots, the scale of exact results
+ */
+uint64_t exactScale(size_t nhands, size_t nevals);
+
 /**
  * A base class for all simple hand evaluation classes.  All we are
  * trying to do here is to abstract the hand evaluation.  No
@@ -92,6 +133,18 @@ class PokerHandEvaluator : private boost::noncopyable {
     return evaluateHand(hand, board).eval(0);
   }
 
+  /**
+   * An upper bound on the type of the high evaluation of a hand, once
+   * ncards more board cards are dealt from the cards not in dead.  The
+   * enumerators use it to spot showdowns no runout can change.  The
+   * default knows nothing about the game, so it bounds nothing.
+   */
+  virtual int highTypeBound(const CardSet& /*hand*/, const CardSet& /*board*/,
+                            size_t /*ncards*/,
+                            const CardSet& /*dead*/) const {
+    return STRAIGHT_FLUSH;
+  }
+
   virtual bool usesSuits() const { return m_useSuits; }
 
   void useSuits(bool use) { m_useSuits = use; }
@@ -131,6 +184,28 @@ class PokerHandEvaluator : private boost::noncopyable {
                         std::vector<EquityResult>& result,
                         double weight = 1.0) const;
 
+  /**
+   * The exact version of evaluateShowdown.  Instead of a weight, split[k]
+   * holds the award for a share of a pot split k ways, for k up to the
+   * number of hands times evaluationSize().  With a whole number weight w
+   * and the scale s from exactScale, split[k] is w * s / k.
+   */
+  void evaluateShowdown(const std::vector<CardSet>& hands,
+                        const nit::CardSet& board,
+                        std::vector<PokerHandEvaluation>& evals,
+                        std::vector<ExactEquityResult>& result,
+                        const uint64_t* split) const;
+
+  /**
+   * Award the shares of a showdown whose hands are evaluated already,
+   * evals holds the evaluations of the nhands hands, in order.  This is
+   * the second half of evaluateShowdown, for callers which keep the
+   * evaluations.
+   */
+  static void awardShowdown(const PokerHandEvaluation* evals, size_t nhands,
+                            std::vector<EquityResult>& result,
+                            double weight = 1.0);
+
  protected:
   PokerHandEvaluator();
 
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "river_payoff_matrix.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include <nit/error.h>
+#include <nit/util/lastbit.h>
+
+#include "poker_evaluation.h"
+
+namespace nit {
+
+namespace {
+
+/// the hands of one side of the matrix, as the sweeps see them
+struct Side {
+  const std::vector<CardSet>& hands;
+  const std::vector<uint32_t>& strength;
+  const std::vector<uint32_t>& order;
+};
+
+/// @returns the two cards of a holding
+std::array<int, 2> cardsOf(const CardSet& hand) {
+  const uint64_t mask = hand.mask();
+  const int lo = lastbit(mask);
+  return {{lo, lastbit(mask ^ UINT64_C(1) << lo)}};
+}
+
+/**
+ * @returns for each target hand, the weight of the source hands it beats
+ * less the weight of those it loses to, leaving out the hands which share
+ * a card with it.  The sources weaker than a target are summed on the way
+ * up, the stronger ones on the way down, each in total and by card, and
+ * a source which shares both cards with a target is the same hand, so it
+ * ties and is never in either sum.
+ */
+std::vector<double> sweep(const Side& targets, const Side& sources,
+                          const std::vector<double>& weights) {
+  std::vector<double> result(targets.hands.size(), 0.0);
+  std::array<double, STANDARD_DECK_SIZE> byCard;
+
+  // up, the sources strictly weaker than each target
+  byCard.fill(0.0);
+  double total = 0.0;
+  size_t s = 0;
+  for (uint32_t t : targets.order) {
+    for (; s < sources.order.size() &&
+           sources.strength[sources.order[s]] < targets.strength[t];
+         s++) {
+      const uint32_t src = sources.order[s];
+      total += weights[src];
+      for (int c : cardsOf(sources.hands[src]))
+        byCard[c] += weights[src];
+    }
+    std::array<int, 2> cards = cardsOf(targets.hands[t]);
+    result[t] += total - byCard[cards[0]] - byCard[cards[1]];
+  }
+
+  // and down, the sources strictly stronger
+  byCard.fill(0.0);
+  total = 0.0;
+  s = sources.order.size();
+  for (size_t k = targets.order.size(); k-- > 0;) {
+    const uint32_t t = targets.order[k];
+    for (; s > 0 && sources.strength[sources.order[s - 1]] >
+                        targets.strength[t];
+         s--) {
+      const uint32_t src = sources.order[s - 1];
+      total += weights[src];
+      for (int c : cardsOf(sources.hands[src]))
+        byCard[c] += weights[src];
+    }
+    std::array<int, 2> cards = cardsOf(targets.hands[t]);
+    result[t] -= total - byCard[cards[0]] - byCard[cards[1]];
+  }
+  return result;
+}
+
+}  // namespace
+
+RiverPayoffMatrix::RiverPayoffMatrix(const CardSet& board,
+                                     const std::vector<CardSet>& rows,
+                                     const std::vector<CardSet>& cols)
+    : m_rows(rows), m_cols(cols) {
+  if (board.size() != 5)
+    throw InvalidArgument("a river board has five cards")
+        << errinfo_value(board.str());
+  for (const std::vector<CardSet>* hands : {&m_rows, &m_cols})
+    for (const CardSet& hand : *hands)
+      if (hand.size() != 2 || (hand.mask() >> STANDARD_DECK_SIZE) != 0 ||
+          hand.intersects(board))
+        throw InvalidArgument("a holding has two cards off the board")
+            << errinfo_value(hand.str());
+
+  // evaluate every hand once, and rank the evaluations of both ranges
+  auto evaluate = [&board](const std::vector<CardSet>& hands) {
+    std::vector<uint32_t> codes(hands.size());
+    for (size_t i = 0; i < hands.size(); i++)
+      codes[i] =
+          static_cast<uint32_t>((hands[i] | board).evaluateHigh().code());
+    return codes;
+  };
+  m_rowStrength = evaluate(m_rows);
+  m_colStrength = evaluate(m_cols);
+  std::vector<uint32_t> codes(m_rowStrength);
+  codes.insert(codes.end(), m_colStrength.begin(), m_colStrength.end());
+  std::sort(codes.begin(), codes.end());
+  codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+  for (std::vector<uint32_t>* strength : {&m_rowStrength, &m_colStrength})
+    for (uint32_t& code : *strength)
+      code = static_cast<uint32_t>(
+          std::lower_bound(codes.begin(), codes.end(), code) - codes.begin());
+
+  auto sorted = [](const std::vector<uint32_t>& strength) {
+    std::vector<uint32_t> order(strength.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&strength](uint32_t a, uint32_t b) {
+                       return strength[a] < strength[b];
+                     });
+    return order;
+  };
+  m_rowOrder = sorted(m_rowStrength);
+  m_colOrder = sorted(m_colStrength);
+}
+
+std::vector<int8_t> RiverPayoffMatrix::dense() const {
+  std::vector<int8_t> matrix(rows() * cols());
+  for (size_t i = 0; i < rows(); i++)
+    for (size_t j = 0; j < cols(); j++)
+      matrix[i * cols() + j] = static_cast<int8_t>(payoff(i, j));
+  return matrix;
+}
+
+std::vector<PayoffEntry> RiverPayoffMatrix::sparse() const {
+  std::vector<PayoffEntry> entries;
+  for (size_t i = 0; i < rows(); i++) {
+    for (size_t j = 0; j < cols(); j++) {
+      int p = payoff(i, j);
+      if (p != 0)
+        entries.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(j),
+                           static_cast<int8_t>(p)});
+    }
+  }
+  return entries;
+}
+
+std::vector<double> RiverPayoffMatrix::multiply(
+    const std::vector<double>& colWeights) const {
+  if (colWeights.size() != cols())
+    throw InvalidArgument("there must be a weight for every column");
+  return sweep({m_rows, m_rowStrength, m_rowOrder},
+               {m_cols, m_colStrength, m_colOrder}, colWeights);
+}
+
+std::vector<double> RiverPayoffMatrix::multiplyTransposed(
+    const std::vector<double>& rowWeights) const {
+  if (rowWeights.size() != rows())
+    throw InvalidArgument("there must be a weight for every row");
+  // the payoff to the rows is what the column hand loses
+  std::vector<double> result =
+      sweep({m_cols, m_colStrength, m_colOrder},
+            {m_rows, m_rowStrength, m_rowOrder}, rowWeights);
+  for (double& value : result)
+    value = -value;
+  return result;
+}
+
+}  // namespace nit
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_EVAL_RIVER_PAYOFF_MATRIX_H_
+#define NIT_EVAL_RIVER_PAYOFF_MATRIX_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include "card_set.h"
+
+namespace nit {
+
+/**
+ * A non zero entry of a payoff matrix.
+ */
+struct PayoffEntry {
+  uint32_t row;
+  uint32_t col;
+  int8_t payoff;
+};
+
+/**
+ * The showdown payoffs between two hold'em ranges on a river: 1 where
+ * the row hand wins, -1 where it loses, and 0 for ties and for hands
+ * which share a card.
+ *
+ * Each hand is evaluated once, and its strength is the rank of its
+ * evaluation among all the hands of both ranges, so the payoff of a pair
+ * of hands is a comparison.  The hands of each range are also kept
+ * sorted by strength, which is the compressed form of the matrix: a
+ * product with a vector is one sweep up and one down the sorted hands,
+ * with a running sum per card to take out the blocked hands, O(n)
+ * instead of the O(n^2) of the dense matrix.
+ */
+class RiverPayoffMatrix {
+ public:
+  /**
+   * throws InvalidArgument if the board is not five cards, or a hand is
+   * not two cards off the board
+   */
+  RiverPayoffMatrix(const CardSet& board, const std::vector<CardSet>& rows,
+                    const std::vector<CardSet>& cols);
+
+  size_t rows() const { return m_rows.size(); }
+  size_t cols() const { return m_cols.size(); }
+  const CardSet& row(size_t i) const { return m_rows[i]; }
+  const CardSet& col(size_t j) const { return m_cols[j]; }
+
+  /// the strengths of the hands, the higher one wins
+  uint32_t rowStrength(size_t i) const { return m_rowStrength[i]; }
+  uint32_t colStrength(size_t j) const { return m_colStrength[j]; }
+
+  /// the hands of each range, weakest first
+  const std::vector<uint32_t>& rowOrder() const { return m_rowOrder; }
+  const std::vector<uint32_t>& colOrder() const { return m_colOrder; }
+
+  /// @returns the payoff of a row hand against a column hand
+  int payoff(size_t i, size_t j) const {
+    if (m_rows[i].intersects(m_cols[j]))
+      return 0;
+    return (m_rowStrength[i] > m_colStrength[j]) -
+           (m_rowStrength[i] < m_colStrength[j]);
+  }
+
+  /// @returns the payoffs, row by row
+  std::vector<int8_t> dense() const;
+
+  /// @returns the wins and losses, row by row
+  std::vector<PayoffEntry> sparse() const;
+
+  /// @returns the payoff of each row hand against the column weights
+  std::vector<double> multiply(const std::vector<double>& colWeights) const;
+
+  /// @returns the payoff to the row hands of each column hand, against
+  /// the row weights, the product with the transposed matrix
+  std::vector<double> multiplyTransposed(
+      const std::vector<double>& rowWeights) const;
+
+ private:
+  std::vector<CardSet> m_rows;
+  std::vector<CardSet> m_cols;
+  std::vector<uint32_t> m_rowStrength;
+  std::vector<uint32_t> m_colStrength;
+  std::vector<uint32_t> m_rowOrder;
+  std::vector<uint32_t> m_colOrder;
+};
+
+}  // namespace nit
+
+#endif  // NIT_EVAL_RIVER_PAYOFF_MATRIX_H_
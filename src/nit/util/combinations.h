@@ -4,10 +4,26 @@
 #ifndef NIT_UTIL_COMBINATIONS_H_
 #define NIT_UTIL_COMBINATIONS_H_
 
+#include <cstdint>
+
 #include <string>
 
 namespace nit {
 
+/**
+ * @returns n choose k, exact for all n up to 62
+ */
+inline uint64_t choose(size_t n, size_t k) {
+  if (k > n)
+    return 0;
+  if (k > n - k)
+    k = n - k;
+  uint64_t ret = 1;
+  for (size_t i = 0; i < k; i++)
+    ret = ret * (n - i) / (i + 1);
+  return ret;
+}
+
 /**
  * Generates the set of all N choose K combinations of K
  * indices less than N.
@@ -85,6 +101,33 @@ class combinations {
 
   bool nextcomb() { return next(); }
 
+  /**
+   * jump to the combination which next() reaches after rank steps from
+   * the first combination, rank must be less than n choose k
+   */
+  void seek(uint64_t rank) {
+    reset();
+    size_t value = 0;
+    for (size_t i = 0; i < k_; i++, value++) {
+      uint64_t count;
+      while (rank >= (count = choose(n_ - value - 1, k_ - i - 1))) {
+        rank -= count;
+        value++;
+      }
+      comb_[i] = value;
+    }
+  }
+
+  /// @returns the number of steps from the first combination to this one
+  uint64_t rank() const {
+    uint64_t ret = 0;
+    size_t value = 0;
+    for (size_t i = 0; i < k_; i++, value++)
+      for (; value < comb_[i]; value++)
+        ret += choose(n_ - value - 1, k_ - i - 1);
+    return ret;
+  }
+
   size_t operator[](size_t i) const { return comb_[i]; }
 
   size_t size() const { return k_; }
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_UTIL_PARALLEL_FOR_H_
+#define NIT_UTIL_PARALLEL_FOR_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nit {
+
+/**
+ * Call work(thread, i) for every i in [0, n), on nthreads threads, the
+ * calling thread being thread 0.  The items are handed out one at a time
+ * from a shared counter, so the items can take very different times.
+ * The thread numbers are below nthreads, for state kept per thread.
+ *
+ * If work throws, no more items are handed out, and the first exception
+ * is thrown again once all the threads are done.
+ */
+template <class Work>
+void parallelFor(size_t n, size_t nthreads, Work work) {
+  nthreads = std::max<size_t>(1, std::min(nthreads, n));
+  std::atomic<size_t> next(0);
+  std::exception_ptr error;
+  std::mutex lock;
+  auto run = [&](size_t thread) {
+    try {
+      for (size_t i = next++; i < n; i = next++)
+        work(thread, i);
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (!error)
+        error = std::current_exception();
+      next = n;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < nthreads; t++)
+    threads.emplace_back(run, t);
+  run(0);
+  for (std::thread& thread : threads)
+    thread.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+}  // namespace nit
+
+#endif  // NIT_UTIL_PARALLEL_FOR_H_
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef NIT_UTIL_UINT128_H_
+#define NIT_UTIL_UINT128_H_
+
+#include <cstdint>
+
+#include <algorithm>
+#include <string>
+
+namespace nit {
+
+/**
+ * A minimal unsigned 128 bit integer, used to accumulate exact counts
+ * which can overflow 64 bits.  Only the operations the enumerators need
+ * are provided: addition, a 64 by 64 bit multiply, comparison, and
+ * conversion to double and to a decimal string.  Arithmetic wraps
+ * modulo 2^128, like the built in unsigned types.
+ */
+struct UInt128 {
+  uint64_t hi{0};
+  uint64_t lo{0};
+
+  UInt128() = default;
+  UInt128(uint64_t low) : lo(low) {}  // NOLINT
+  UInt128(uint64_t high, uint64_t low) : hi(high), lo(low) {}
+
+  UInt128& operator+=(const UInt128& other) {
+    uint64_t sum = lo + other.lo;
+    hi += other.hi + (sum < lo ? 1 : 0);
+    lo = sum;
+    return *this;
+  }
+
+  UInt128& operator-=(const UInt128& other) {
+    uint64_t diff = lo - other.lo;
+    hi -= other.hi + (diff > lo ? 1 : 0);
+    lo = diff;
+    return *this;
+  }
+
+  /// @returns the full 128 bit product of a and b
+  static UInt128 multiply(uint64_t a, uint64_t b) {
+    const uint64_t mask = UINT64_C(0xffffffff);
+    uint64_t a0 = a & mask, a1 = a >> 32;
+    uint64_t b0 = b & mask, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & mask) + (p10 & mask);
+    return UInt128(p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32),
+                   (mid << 32) | (p00 & mask));
+  }
+
+  /// divide by a 32 bit divisor in place, @returns the remainder
+  uint32_t divide(uint32_t divisor) {
+    uint64_t parts[4] = {hi >> 32, hi & 0xffffffff, lo >> 32, lo & 0xffffffff};
+    uint64_t rem = 0;
+    for (uint64_t& part : parts) {
+      uint64_t cur = (rem << 32) | part;
+      part = cur / divisor;
+      rem = cur % divisor;
+    }
+    hi = (parts[0] << 32) | parts[1];
+    lo = (parts[2] << 32) | parts[3];
+    return static_cast<uint32_t>(rem);
+  }
+
+  bool operator==(const UInt128& other) const {
+    return hi == other.hi && lo == other.lo;
+  }
+  bool operator!=(const UInt128& other) const { return !(*this == other); }
+  bool operator<(const UInt128& other) const {
+    return hi < other.hi || (hi == other.hi && lo < other.lo);
+  }
+
+  double toDouble() const {
+    return static_cast<double>(hi) * 18446744073709551616.0 +
+           static_cast<double>(lo);
+  }
+
+  /// @returns the value in decimal
+  std::string str() const {
+    if (hi == 0)
+      return std::to_string(lo);
+    std::string digits;
+    UInt128 value = *this;
+    while (value.hi != 0 || value.lo != 0)
+      digits.push_back(static_cast<char>('0' + value.divide(10)));
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+  }
+
+  /// parse a decimal string, @returns false on bad input or overflow
+  static bool parse(const std::string& s, UInt128& value) {
+    if (s.empty())
+      return false;
+    UInt128 result;
+    for (char c : s) {
+      if (c < '0' || c > '9')
+        return false;
+      UInt128 high = multiply(result.hi, 10);
+      if (high.hi != 0)
+        return false;
+      UInt128 next = multiply(result.lo, 10);
+      next.hi += high.lo;
+      if (next.hi < high.lo)
+        return false;
+      UInt128 digit(static_cast<uint64_t>(c - '0'));
+      next += digit;
+      if (next < digit)
+        return false;
+      result = next;
+    }
+    value = result;
+    return true;
+  }
+};
+
+inline UInt128 operator+(UInt128 a, const UInt128& b) { return a += b; }
+inline UInt128 operator-(UInt128 a, const UInt128& b) { return a -= b; }
+
+}  // namespace nit
+
+#endif  // NIT_UTIL_UINT128_H_
@@ -0,0 +1,153 @@
+#include "board_major_enumerator.h"
+
+#include <catch.hpp>
+
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+CardDistribution parseDistribution(const std::string& input) {
+  CardDistribution dist;
+  dist.parse(input);
+  return dist;
+}
+
+void checkAgainstShowdown(const std::string& game, const CardDistribution& hero,
+                          const CardDistribution& villain,
+                          const CardSet& board) {
+  auto peval = makeEvaluator(game);
+  RangeEquityResult result =
+      BoardMajorEnumerator().calculateEquity(hero, villain, board, *peval);
+  std::vector<EquityResult> expected =
+      ShowdownEnumerator().calculateEquity({hero, villain}, board, *peval);
+  REQUIRE(result.players.size() == 2);
+  for (size_t p = 0; p < 2; p++) {
+    CHECK(result.players[p].winShares == Approx(expected[p].winShares));
+    CHECK(result.players[p].tieShares == Approx(expected[p].tieShares));
+  }
+
+  // the hand results add up to the totals, and each matches a hand vs range
+  for (size_t p = 0; p < 2; p++) {
+    EquityResult sum;
+    for (const EquityResult& hand : result.hands[p])
+      sum += hand;
+    CHECK(sum.winShares == Approx(result.players[p].winShares));
+  }
+  std::vector<EquityResult> first = ShowdownEnumerator().calculateEquity(
+      {CardDistribution(hero[0]), villain}, board, *peval);
+  CHECK(result.hands[0][0].winShares ==
+        Approx(first[0].winShares * hero[hero[0]]));
+}
+
+void checkMultiway(const std::string& game,
+                   const std::vector<CardDistribution>& dists,
+                   const CardSet& board) {
+  auto peval = makeEvaluator(game);
+  RangeEquityResult result =
+      BoardMajorEnumerator().calculateEquity(dists, board, *peval);
+  std::vector<EquityResult> expected =
+      ShowdownEnumerator().calculateEquity(dists, board, *peval);
+  REQUIRE(result.players.size() == dists.size());
+  for (size_t p = 0; p < dists.size(); p++) {
+    CHECK(result.players[p].winShares == Approx(expected[p].winShares));
+    CHECK(result.players[p].tieShares == Approx(expected[p].tieShares));
+  }
+
+  // the first hand of each player matches that hand against the ranges
+  for (size_t p = 0; p < dists.size(); p++) {
+    std::vector<CardDistribution> single = dists;
+    single[p] = CardDistribution(dists[p][0]);
+    std::vector<EquityResult> hand =
+        ShowdownEnumerator().calculateEquity(single, board, *peval);
+    double weight = dists[p][dists[p][0]];
+    CHECK(result.hands[p][0].winShares ==
+          Approx(hand[p].winShares * weight));
+    CHECK(result.hands[p][0].tieShares ==
+          Approx(hand[p].tieShares * weight));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("holdem_ranges_on_flop", "[BoardMajorEnumerator]") {
+  checkAgainstShowdown("h", parseDistribution("AcKc,AdKd=2,QsQh=0.5,7d7h"),
+                       parseDistribution("QdQh,JcJs,7c2d,AhKd,8c9c"),
+                       CardSet("2c7cTd"));
+}
+
+TEST_CASE("holdem_hand_vs_random_on_turn", "[BoardMajorEnumerator]") {
+  CardDistribution random;
+  random.fill(2);
+  checkAgainstShowdown("h", parseDistribution("AsKs,2h2d"), random,
+                       CardSet("2c7c8s3d"));
+}
+
+TEST_CASE("omaha_ranges_on_turn", "[BoardMajorEnumerator]") {
+  checkAgainstShowdown("O", parseDistribution("AcAdKcKd,JhTh9d8d"),
+                       parseDistribution("QsQhJsJd,AhKh5c6c,4s5s6d7d"),
+                       CardSet("2c7c8s3h"));
+}
+
+TEST_CASE("board_major_takes_a_list_of_two", "[BoardMajorEnumerator]") {
+  auto peval = makeEvaluator("O");
+  std::vector<CardDistribution> dists = {
+      parseDistribution("AcAdKcKd,9h9dTsJs"), parseDistribution("QsQhJhJd")};
+  CardSet board("2c7c8s3h");
+  RangeEquityResult result =
+      BoardMajorEnumerator().calculateEquity(dists, board, *peval);
+  std::vector<EquityResult> expected =
+      ShowdownEnumerator().calculateEquity(dists, board, *peval);
+  for (size_t p = 0; p < dists.size(); p++) {
+    CHECK(result.players[p].winShares == Approx(expected[p].winShares));
+    CHECK(result.players[p].tieShares == Approx(expected[p].tieShares));
+  }
+}
+
+TEST_CASE("holdem_three_ways_on_flop", "[BoardMajorEnumerator]") {
+  checkMultiway("h",
+                {parseDistribution("AcKc,AdKd=2,QsQh=0.5,7d7h"),
+                 parseDistribution("QdQh,JcJs,7c2d,AhKd,8c9c"),
+                 parseDistribution("AsKs,TsJs,2h2d,9d8d=3")},
+                CardSet("2c7cTd"));
+}
+
+TEST_CASE("holdem_four_ways_with_ties_on_turn", "[BoardMajorEnumerator]") {
+  checkMultiway("h",
+                {parseDistribution("AcKc,AdQd,3h4h"),
+                 parseDistribution("AhKd,AsQs,5d6d"),
+                 parseDistribution("KhQh,KsJs,Ad2d"),
+                 parseDistribution("JhTh,QcJc,6h5h=2")},
+                CardSet("2c7c8s3d"));
+}
+
+TEST_CASE("omaha_three_ways_on_turn", "[BoardMajorEnumerator]") {
+  checkMultiway("O",
+                {parseDistribution("AcAdKcKd,JhTh9d8d"),
+                 parseDistribution("QsQhJsJd,AhKh5c6c,4s5s6d7d=2"),
+                 parseDistribution("9c9sTcTs,AsKsQdJc")},
+                CardSet("2c7c8s3h"));
+}
+
+TEST_CASE("board_major_needs_two_players", "[BoardMajorEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists = {parseDistribution("AcKc")};
+  CHECK_THROWS_AS(
+      BoardMajorEnumerator().calculateEquity(dists, CardSet("2c7c8s"), *peval),
+      InvalidArgument);
+}
+
+TEST_CASE("hi_lo_is_rejected", "[BoardMajorEnumerator]") {
+  auto peval = makeEvaluator("o");
+  CHECK_THROWS_AS(BoardMajorEnumerator().calculateEquity(
+                      parseDistribution("AcAd2c3d"),
+                      parseDistribution("QsQhJsJh"), CardSet("4c7c8s"), *peval),
+                  InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,102 @@
+#include "board_ranking.h"
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+#include <nit/util/combinations.h>
+
+namespace nit {
+namespace test {
+
+namespace {
+
+/// compare a hand to every opponent holding, one evaluation each
+HoldingCounts bruteForce(const CardSet& board, const CardSet& hand,
+                         const PokerHandEvaluator& peval) {
+  HoldingCounts result;
+  const int eval = peval.evaluateHand(hand, board).high().code();
+  combinations holdings(STANDARD_DECK_SIZE, peval.handSize());
+  do {
+    CardSet other(holdings.getMask());
+    if (other.intersects(board | hand))
+      continue;
+    int o = peval.evaluateHand(other, board).high().code();
+    if (o < eval)
+      result.worse++;
+    else if (o == eval)
+      result.ties++;
+    else
+      result.better++;
+  } while (holdings.next());
+  return result;
+}
+
+}  // namespace
+
+TEST_CASE("BoardRanking.Holdem", "[BoardRanking]") {
+  auto peval = makeEvaluator("h");
+  for (const char* b : {"Th9h4c", "Th9h4c2s2d"}) {
+    const CardSet board(b);
+    BoardRanking ranking(board, *peval);
+    CHECK(ranking.holdings() == choose(STANDARD_DECK_SIZE - board.size(), 2));
+    for (const char* h : {"AhKh", "QhJh", "2c2h", "TcTd", "9c4d", "7d3c"}) {
+      const CardSet hand(h);
+      if (hand.intersects(board))
+        continue;
+      HoldingCounts expected = bruteForce(board, hand, *peval);
+      HoldingCounts counts = ranking.counts(hand);
+      CHECK(counts.worse == expected.worse);
+      CHECK(counts.ties == expected.ties);
+      CHECK(counts.better == expected.better);
+      CHECK(ranking.percentile(hand) ==
+            Approx((expected.worse + expected.ties / 2.0) /
+                   expected.total()));
+    }
+  }
+
+  // on the river quads are the nuts, and nothing but the other two
+  // deuces can make them
+  BoardRanking river(CardSet("Th9h4c2s2d"), *peval);
+  CHECK(river.nutRank(CardSet("2c2h")) == 1);
+  CHECK(river.nutRank(CardSet("Td9d")) > 1);
+  CHECK(river.nutsCombos(CardSet("AsKs")) == 1);
+  CHECK(river.nutsCombos(CardSet("2cKs")) > 1);
+  CHECK(river.counts(CardSet("2c2h")).better == 0);
+
+  // the evaluator is only needed to build the ranking
+  BoardRanking kept(CardSet("Th9h4c2s2d"), *makeEvaluator("h"));
+  CHECK(kept.nutRank(CardSet("2c2h")) == 1);
+  CHECK(kept.counts(CardSet("AhKh")).worse ==
+        river.counts(CardSet("AhKh")).worse);
+}
+
+TEST_CASE("BoardRanking.Omaha", "[BoardRanking]") {
+  auto peval = makeEvaluator("O");
+  const CardSet board("Th9h4c2s2d");
+  BoardRanking ranking(board, *peval);
+  CHECK(ranking.holdings() == choose(STANDARD_DECK_SIZE - board.size(), 4));
+  for (const char* h : {"AhKhQc3d", "2c2hJsJd", "TcTd9c8s"}) {
+    const CardSet hand(h);
+    HoldingCounts expected = bruteForce(board, hand, *peval);
+    HoldingCounts counts = ranking.counts(hand);
+    CHECK(counts.worse == expected.worse);
+    CHECK(counts.ties == expected.ties);
+    CHECK(counts.better == expected.better);
+  }
+  // the other two deuces block the quads
+  CHECK(ranking.nutRank(CardSet("2c2hJsJd")) == 1);
+  CHECK(ranking.nutsCombos(CardSet("2c2hJsJd")) > 0);
+  CHECK(ranking.counts(CardSet("2c2hJsJd")).better == 0);
+}
+
+TEST_CASE("BoardRanking.Invalid", "[BoardRanking]") {
+  auto holdem = makeEvaluator("h");
+  CHECK_THROWS_AS(BoardRanking(CardSet("Th9h"), *holdem), InvalidArgument);
+  BoardRanking ranking(CardSet("Th9h4c"), *holdem);
+  CHECK_THROWS_AS(ranking.counts(CardSet("Th8h")), InvalidArgument);
+  CHECK_THROWS_AS(ranking.percentile(CardSet("AhKhQh")), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
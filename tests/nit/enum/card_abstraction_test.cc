@@ -0,0 +1,68 @@
+#include "card_abstraction.h"
+
+#include <cstdio>
+
+#include <algorithm>
+#include <fstream>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+
+#include "hand_potential_enumerator.h"
+
+namespace nit {
+namespace test {
+
+TEST_CASE("CardAbstraction.NextStrengths", "[CardAbstraction]") {
+  const CardSet turn("Th9h4c2s");
+  HandPotentialEnumerator enumerator;
+  std::vector<HandPotential> potentials = enumerator.calculate(turn);
+  std::vector<std::vector<double>> next = enumerator.nextStrengths(turn);
+  REQUIRE(next.size() == CardAbstraction::kHoldings);
+  for (const char* hand : {"AhKh", "8c7d", "2c2d", "As3d"}) {
+    const std::vector<double>& values = next[CardSet(hand).colex()];
+    REQUIRE(values.size() == 46);
+    CHECK(std::is_sorted(values.begin(), values.end()));
+    double mean = 0.0;
+    for (double value : values)
+      mean += value;
+    CHECK(mean / values.size() ==
+          Approx(potentials[CardSet(hand).colex()].ehs));
+  }
+  CHECK(next[CardSet("Th3d").colex()].empty());
+  CHECK_THROWS_AS(enumerator.nextStrengths(CardSet("Th9h4c2s3d")),
+                  InvalidArgument);
+}
+
+TEST_CASE("CardAbstraction.Features", "[CardAbstraction]") {
+  const CardSet turn("Th9h4c2s");
+  std::vector<uint16_t> features = CardAbstraction::features(turn, 4);
+  REQUIRE(features.size() == 4 * CardAbstraction::kHoldings);
+  // the quantiles of a holding rise, and a set stays above air
+  const uint16_t* set = &features[4 * CardSet("TcTd").colex()];
+  const uint16_t* air = &features[4 * CardSet("8d3c").colex()];
+  for (size_t q = 1; q < 4; q++)
+    CHECK(set[q - 1] <= set[q]);
+  CHECK(set[0] > air[3]);
+
+  std::vector<uint16_t> river =
+      CardAbstraction::features(CardSet("Th9h4c2s2d"), 16);
+  REQUIRE(river.size() == CardAbstraction::kHoldings);
+  CHECK(river[CardSet("2c2h").colex()] == 65535);
+  CHECK_THROWS_AS(CardAbstraction::features(turn, 0), InvalidArgument);
+}
+
+TEST_CASE("CardAbstraction.Invalid", "[CardAbstraction]") {
+  const char* path = "card_abstraction_test.bin";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "nit-ab01 and not much else";
+  }
+  CHECK_THROWS_AS(CardAbstraction(path), InvalidArgument);
+  std::remove(path);
+  CHECK_THROWS_AS(CardAbstraction("no/such/abstraction"), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
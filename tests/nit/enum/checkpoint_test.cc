@@ -0,0 +1,111 @@
+#include "checkpoint.h"
+
+#include <cstdio>
+
+#include <fstream>
+#include <sstream>
+
+#include <catch.hpp>
+
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+std::vector<DenseDistribution> handVsRandom(const PokerHandEvaluator& peval) {
+  CardDistribution hand;
+  hand.parse("AsKs");
+  std::vector<DenseDistribution> dists = {DenseDistribution(hand),
+                                          DenseDistribution()};
+  dists.back().fill(peval.handSize());
+  return dists;
+}
+
+}  // namespace
+
+TEST_CASE("checkpoint_round_trip", "[Checkpoint]") {
+  Checkpoint checkpoint;
+  checkpoint.query = UINT64_C(0xfedcba9876543210);
+  checkpoint.position = 123456789;
+  checkpoint.results.resize(2);
+  checkpoint.results[0].winShares = UInt128(3, 4);
+  checkpoint.results[1].tieShares = UInt128(77);
+  checkpoint.results[1].scale = 6;
+
+  std::stringstream text;
+  checkpoint.write(text);
+  Checkpoint read = Checkpoint::read(text);
+  CHECK(read.query == checkpoint.query);
+  CHECK(read.position == checkpoint.position);
+  REQUIRE(read.results.size() == 2);
+  CHECK(read.results[0].winShares == UInt128(3, 4));
+  CHECK(read.results[1].tieShares == UInt128(77));
+  CHECK(read.results[1].scale == 6);
+
+  std::stringstream truncated("nit-checkpoint 1\nquery 12\n");
+  CHECK_THROWS_AS(Checkpoint::read(truncated), ParseError);
+}
+
+TEST_CASE("checkpoint_resume", "[Checkpoint]") {
+  auto peval = makeEvaluator("h");
+  std::vector<DenseDistribution> dists = handVsRandom(*peval);
+  CardSet board("2c7c8s");
+  ShowdownEnumerator showdown;
+  std::vector<ExactEquityResult> whole =
+      showdown.calculateExactEquity(dists, board, *peval);
+
+  // the first half of the deals stands in for an interrupted run, there
+  // are 47c2 tuples of 45c2 deals each
+  const uint64_t total = 1081 * 990;
+  EnumerationOptions half;
+  half.shard = Shard(0, 2);
+  Checkpoint checkpoint;
+  checkpoint.query = ShowdownEnumerator::fingerprint(dists, board, *peval);
+  checkpoint.position = total / 2;
+  checkpoint.results = showdown.calculateExactEquity(dists, board, *peval, half);
+
+  const std::string path = "nit_checkpoint_resume.txt";
+  checkpoint.save(path);
+  EnumerationOptions options;
+  options.checkpointFile = path;
+  std::vector<ExactEquityResult> resumed =
+      showdown.calculateExactEquity(dists, board, *peval, options);
+  for (size_t i = 0; i < 2; i++) {
+    CHECK(resumed[i].winShares == whole[i].winShares);
+    CHECK(resumed[i].tieShares == whole[i].tieShares);
+  }
+  // the checkpoint is removed when the enumeration is done
+  CHECK_FALSE(std::ifstream(path).good());
+}
+
+TEST_CASE("checkpoint_saved_and_checked", "[Checkpoint]") {
+  auto peval = makeEvaluator("h");
+  std::vector<DenseDistribution> dists = handVsRandom(*peval);
+  const std::string path = "nit_checkpoint_other.txt";
+
+  // a checkpoint of another query is never resumed
+  Checkpoint other;
+  other.query = ShowdownEnumerator::fingerprint(dists, CardSet("2c7c8d"),
+                                                *peval);
+  other.results.resize(2);
+  other.save(path);
+  EnumerationOptions options;
+  options.checkpointFile = path;
+  options.checkpointInterval = 0.0;
+  CHECK_THROWS_AS(ShowdownEnumerator().calculateExactEquity(
+                      dists, CardSet("2c7c8s"), *peval, options),
+                  InvalidArgument);
+  std::remove(path.c_str());
+
+  // checkpoints need exact shares
+  CHECK_THROWS_AS(ShowdownEnumerator().calculateEquity(
+                      dists, CardSet("2c7c8s"), *peval, options),
+                  InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
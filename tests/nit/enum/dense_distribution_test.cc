@@ -0,0 +1,53 @@
+#include "dense_distribution.h"
+
+#include <catch.hpp>
+
+namespace nit {
+namespace test {
+
+TEST_CASE("dense_from_card_distribution", "[DenseDistribution]") {
+  CardDistribution dist;
+  dist.parse("AcKc=2,AdKd=0,QsQh=0.5");
+  DenseDistribution dense(dist);
+  REQUIRE(dense.size() == 2);
+  CHECK(dense[0] == CardSet("AcKc"));
+  CHECK(dense.source(1) == 2);
+  CHECK(dense.weight(CardSet("QsQh")) == 0.5);
+  CHECK(dense.weight(CardSet("AdKd")) == 0.0);
+  CHECK(dense.weight(CardSet("AdKdQc")) == 0.0);
+  CHECK(dense.weight() == 2.5);
+
+  CardDistribution back = dense.toCardDistribution();
+  REQUIRE(back.size() == 2);
+  CHECK(back[1] == CardSet("QsQh"));
+  CHECK(back[CardSet("AcKc")] == 2.0);
+}
+
+TEST_CASE("dense_fill_and_remove", "[DenseDistribution]") {
+  DenseDistribution dense;
+  REQUIRE(dense.size() == 1);
+  CHECK(dense.mask(0) == 0);
+
+  dense.fill(2);
+  CHECK(dense.size() == 1326);
+  CHECK(dense.weight(CardSet("7h2c")) == 1.0);
+
+  dense.removeCards(CardSet("AsKs"));
+  CHECK(dense.size() == 1225);
+  CHECK(dense.weight(CardSet("AsQd")) == 0.0);
+  CHECK(dense.weight(CardSet("AhQd")) == 1.0);
+  CHECK(dense.weight() == 1225);
+}
+
+TEST_CASE("dense_mixed_hand_sizes", "[DenseDistribution]") {
+  CardDistribution dist;
+  dist.parse("AcKc,QsQhJd");
+  DenseDistribution dense(dist);
+  CHECK(dense.weight(CardSet("QsQhJd")) == 1.0);
+  dense.removeCards(CardSet("Jd"));
+  CHECK(dense.weight(CardSet("QsQhJd")) == 0.0);
+  CHECK(dense.size() == 1);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,75 @@
+#include "distribution_walker.h"
+
+#include <catch.hpp>
+
+#include "odometer.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+DenseDistribution parseDistribution(const std::string& input) {
+  CardDistribution dist;
+  dist.parse(input);
+  return DenseDistribution(dist);
+}
+
+}  // namespace
+
+TEST_CASE("walker_matches_filtered_odometer", "[DistributionWalker]") {
+  std::vector<DenseDistribution> dists;
+  dists.push_back(parseDistribution("AcKc,AdKd,AhKh,QsQh"));
+  dists.push_back(parseDistribution("QdQh,QcQs,AcAd,KhKs"));
+  dists.push_back(parseDistribution("JsTs,AhKh,9c9d,Qh2c"));
+  CardSet dead("2c7c8s");
+
+  std::vector<size_t> extents = {4, 4, 4};
+  Odometer o(extents);
+  DistributionWalker walker(dists, dead);
+  int visits = 0;
+  do {
+    CardSet used = dead;
+    bool disjoint = true;
+    for (size_t i = 0; i < dists.size(); i++) {
+      disjoint = disjoint && used.disjoint(dists[i][o[i]]);
+      used |= dists[i][o[i]];
+    }
+    if (!disjoint)
+      continue;
+    REQUIRE(walker.next());
+    visits++;
+    for (size_t i = 0; i < dists.size(); i++)
+      CHECK(walker[i] == o[i]);
+    CHECK(walker.dead() == used);
+  } while (o.next());
+  CHECK_FALSE(walker.next());
+  CHECK(visits == 27);
+}
+
+TEST_CASE("walker_skips_zero_weights", "[DistributionWalker]") {
+  std::vector<DenseDistribution> dists;
+  dists.push_back(parseDistribution("AcKc=2,AdKd=0"));
+  dists.push_back(parseDistribution("QdQh=0.5,QcQs"));
+
+  DistributionWalker walker(dists);
+  REQUIRE(walker.next());
+  CHECK(walker.hand(0) == CardSet("AcKc"));
+  CHECK(walker.hand(1) == CardSet("QdQh"));
+  CHECK(walker.weight() == 1.0);
+  REQUIRE(walker.next());
+  CHECK(walker.hand(1) == CardSet("QcQs"));
+  CHECK(walker.weight() == 2.0);
+  CHECK_FALSE(walker.next());
+}
+
+TEST_CASE("walker_without_tuples", "[DistributionWalker]") {
+  std::vector<DenseDistribution> dists;
+  dists.push_back(parseDistribution("AcKc"));
+  dists.push_back(parseDistribution("AcQc,KcJd"));
+  DistributionWalker walker(dists);
+  CHECK_FALSE(walker.next());
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,162 @@
+#include "equity_distribution.h"
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+#include "street_cache.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+std::vector<CardDistribution> parseDistributions(
+    const std::vector<std::string>& inputs) {
+  std::vector<CardDistribution> dists;
+  for (const std::string& input : inputs) {
+    dists.emplace_back();
+    dists.back().parse(input);
+  }
+  return dists;
+}
+
+}  // namespace
+
+TEST_CASE("EquityDistribution.TurnCards", "[EquityDistribution]") {
+  auto peval = makeEvaluator("h");
+  const CardSet flop("2c7cTd");
+  const std::vector<CardDistribution> dists =
+      parseDistributions({"AcKc", "QdQh"});
+
+  // the equity after each turn card, one enumeration per turn
+  EquityHistogram expected;
+  expected.bins.assign(10, 0.0);
+  for (size_t card = 0; card < STANDARD_DECK_SIZE; card++) {
+    CardSet turn(UINT64_C(1) << card);
+    if (turn.intersects(flop | CardSet("AcKcQdQh")))
+      continue;
+    std::vector<EquityResult> river =
+        ShowdownEnumerator().calculateEquity(dists, flop | turn, *peval);
+    double total = river[0].winShares + river[0].tieShares +
+                   river[1].winShares + river[1].tieShares;
+    expected.add((river[0].winShares + river[0].tieShares) / total, total);
+  }
+
+  for (bool prune : {true, false}) {
+    EquityDistribution distribution;
+    distribution.bins = 10;
+    EnumerationOptions options;
+    options.distribution = &distribution;
+    options.pruneDecided = prune;
+    std::vector<EquityResult> results =
+        ShowdownEnumerator().calculateEquity(dists, flop, *peval, options);
+    REQUIRE(distribution.players.size() == 2);
+    CHECK(results[0].winShares == 539);
+    CHECK(results[1].winShares == 451);
+    CHECK(results[0].equity == Approx(539.0 / 990.0));
+    CHECK(results[1].equity == Approx(451.0 / 990.0));
+
+    const EquityHistogram& hero = distribution.players[0];
+    CHECK(hero.weight == Approx(expected.weight));
+    CHECK(hero.mean() == Approx(expected.mean()));
+    CHECK(results[0].equity2 == Approx(expected.moment2 / expected.weight));
+    CHECK(hero.variance() == Approx(expected.variance()));
+    for (size_t b = 0; b < 10; b++)
+      CHECK(hero.bins[b] == Approx(expected.bins[b]));
+    // the two players' equities mirror each other
+    const EquityHistogram& villain = distribution.players[1];
+    for (size_t b = 0; b < 10; b++)
+      CHECK(villain.bins[9 - b] == Approx(hero.bins[b]));
+  }
+}
+
+TEST_CASE("EquityDistribution.Ranges", "[EquityDistribution]") {
+  auto peval = makeEvaluator("h");
+  const std::vector<CardDistribution> dists =
+      parseDistributions({"AcAd,KhKs=0.5,AhKh", "QdQh,JcJs,7c2d"});
+  const CardSet turn("2c7cTd3s");
+  std::vector<EquityResult> plain =
+      ShowdownEnumerator().calculateEquity(dists, turn, *peval);
+
+  // the distribution over the tuples of hands, and over the showdowns
+  for (size_t cards : {0, 1}) {
+    EquityDistribution distribution;
+    distribution.cards = cards;
+    EnumerationOptions options;
+    options.distribution = &distribution;
+    std::vector<EquityResult> results =
+        ShowdownEnumerator().calculateEquity(dists, turn, *peval, options);
+    double total = 0.0;
+    for (const EquityResult& result : plain)
+      total += result.winShares + result.tieShares;
+    for (size_t i = 0; i < 2; i++) {
+      CHECK(results[i].winShares == Approx(plain[i].winShares));
+      CHECK(results[i].tieShares == Approx(plain[i].tieShares));
+      CHECK(results[i].equity ==
+            Approx((plain[i].winShares + plain[i].tieShares) / total));
+      CHECK(distribution.players[i].weight == Approx(total));
+    }
+    // a showdown is won, lost or split, so only the ends and the middle
+    if (cards == 1) {
+      const std::vector<double>& bins = distribution.players[0].bins;
+      for (size_t b = 1; b < 19; b++)
+        CHECK(bins[b] == (b == 10 ? bins[b] : 0.0));
+      CHECK(results[0].equity2 == Approx(results[0].equity -
+                                         bins[10] / total / 4));
+    }
+  }
+}
+
+TEST_CASE("EquityDistribution.Invalid", "[EquityDistribution]") {
+  auto peval = makeEvaluator("h");
+  EquityDistribution distribution;
+  EnumerationOptions options;
+  options.distribution = &distribution;
+  options.shard = Shard(0, 2);
+  CHECK_THROWS_AS(
+      ShowdownEnumerator().calculateEquity(parseDistributions({"AcKc", "QdQh"}),
+                                           CardSet("2c7cTd"), *peval, options),
+      InvalidArgument);
+  distribution.bins = 0;
+  options.shard = Shard();
+  CHECK_THROWS_AS(
+      ShowdownEnumerator().calculateEquity(parseDistributions({"AcKc", "QdQh"}),
+                                           CardSet("2c7cTd"), *peval, options),
+      InvalidArgument);
+
+  // the enumerations which can not take it say so
+  distribution.bins = 20;
+  EquityVisitor visitor(2);
+  CHECK_THROWS_AS(ShowdownEnumerator().visit(
+                      parseDistributions({"AcKc", "QdQh"}), CardSet("2c7cTd"),
+                      *peval, visitor, options),
+                  InvalidArgument);
+  CHECK_THROWS_AS(ShowdownEnumerator().calculateExactEquity(
+                      parseDistributions({"AcKc", "QdQh"}), CardSet("2c7cTd"),
+                      *peval, options),
+                  InvalidArgument);
+}
+
+TEST_CASE("EquityDistribution.StreetCache", "[EquityDistribution]") {
+  auto peval = makeEvaluator("h");
+  const std::vector<CardDistribution> dists =
+      parseDistributions({"AcKc", "QdQh,JdJh"});
+  StreetCache cache;
+  cache.calculateEquity(dists, CardSet("2c7cTd"), *peval);
+
+  // the flop and its turns are cached, but the distribution is enumerated
+  for (const CardSet& board : {CardSet("2c7cTd"), CardSet("2c7cTd3s")}) {
+    EquityDistribution distribution;
+    EnumerationOptions options;
+    options.distribution = &distribution;
+    cache.calculateEquity(dists, board, *peval, options);
+    CHECK(distribution.players.size() == 2);
+  }
+  CHECK(cache.hits() == 0);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,120 @@
+#include "equity_planner.h"
+
+#include <cmath>
+
+#include <catch.hpp>
+
+#include <nit/eval/make_evaluator.h>
+
+#include "dense_distribution.h"
+#include "monte_carlo_enumerator.h"
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+std::vector<CardDistribution> parseHands(
+    const std::vector<std::string>& hands) {
+  std::vector<CardDistribution> dists(hands.size());
+  for (size_t i = 0; i < hands.size(); i++)
+    dists[i].parse(hands[i]);
+  return dists;
+}
+
+double equity(const std::vector<EquityResult>& results, size_t i) {
+  double total = 0.0;
+  for (const EquityResult& result : results)
+    total += result.winShares + result.tieShares;
+  return (results[i].winShares + results[i].tieShares) / total;
+}
+
+}  // namespace
+
+TEST_CASE("monte_carlo_converges", "[MonteCarlo]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists = parseHands({"AcKc", "QdQh"});
+  CardSet board("2c7cTd");
+  std::vector<DenseDistribution> dense(dists.begin(), dists.end());
+
+  SampledEquity sampled =
+      MonteCarloEnumerator(7).calculateEquity(dense, board, *peval, 20000);
+  std::vector<EquityResult> exact =
+      ShowdownEnumerator().calculateEquity(dists, board, *peval);
+
+  CHECK(sampled.samples == 20000);
+  CHECK(sampled.errorBound > 0.0);
+  CHECK(sampled.errorBound < 0.01);
+  CHECK(std::fabs(equity(sampled.results, 0) - equity(exact, 0)) <
+        sampled.errorBound * 1.5);
+
+  // the same seed gives the same estimate
+  SampledEquity again =
+      MonteCarloEnumerator(7).calculateEquity(dense, board, *peval, 20000);
+  CHECK(again.results[0].winShares == sampled.results[0].winShares);
+}
+
+TEST_CASE("planner_counts_small_queries", "[EquityPlanner]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists = parseHands({"AcKc", "QdQh"});
+  EquityPlan plan = EquityPlanner(1e7).plan(dists, CardSet("2c7cTd"), *peval,
+                                            1.0);
+  CHECK(plan.counted);
+  CHECK(plan.tuples == 1.0);
+  // 45 choose 2 runouts, with two evaluations each
+  CHECK(plan.evaluations == 1980.0);
+  CHECK(plan.method != EquityMethod::MonteCarlo);
+  CHECK(plan.errorBound == 0.0);
+
+  PlannedEquity planned =
+      EquityPlanner(1e7).calculateEquity(dists, CardSet("2c7cTd"), *peval, 1.0);
+  CHECK(equity(planned.results, 0) == Approx(539.0 / 990.0));
+
+  // the evaluation cache changes nothing but the speed
+  PlannedEquity cached = EquityPlanner(1e7).calculateEquity(
+      dists, CardSet("2c7cTd"), *peval, 1.0, 256);
+  CHECK(cached.results[0].winShares == planned.results[0].winShares);
+  CHECK(cached.results[0].tieShares == planned.results[0].tieShares);
+}
+
+TEST_CASE("planner_samples_large_queries", "[EquityPlanner]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists(3);
+  for (CardDistribution& dist : dists)
+    dist.fill(peval->handSize());
+  EquityPlan plan = EquityPlanner(1e7).plan(dists, CardSet(), *peval, 0.1);
+  CHECK_FALSE(plan.counted);
+  CHECK(plan.tuples > 1e9);
+  CHECK(plan.method == EquityMethod::MonteCarlo);
+  CHECK(plan.samples == 41666);
+  CHECK(plan.errorBound < 0.01);
+  CHECK(plan.str().find("monte carlo") != std::string::npos);
+}
+
+TEST_CASE("planner_prefers_board_major", "[EquityPlanner]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists(2);
+  for (CardDistribution& dist : dists)
+    dist.fill(peval->handSize());
+  EquityPlan plan =
+      EquityPlanner(1e7).plan(dists, CardSet("2c7cTd"), *peval, 60.0);
+  CHECK(plan.method == EquityMethod::BoardMajor);
+  CHECK(plan.boardMajorCost < plan.exactCost);
+  CHECK(plan.seconds < 60.0);
+}
+
+TEST_CASE("planner_prefers_board_major_three_ways", "[EquityPlanner]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists(3);
+  for (CardDistribution& dist : dists)
+    dist.fill(peval->handSize());
+  EquityPlan plan =
+      EquityPlanner(1e7).plan(dists, CardSet("2c7cTd9s"), *peval, 600.0);
+  CHECK(plan.method == EquityMethod::BoardMajor);
+  CHECK(plan.boardMajorCost < plan.exactCost);
+  CHECK(plan.seconds < 600.0);
+}
+
+}  // namespace test
+}  // namespace nit
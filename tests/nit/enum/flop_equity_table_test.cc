@@ -0,0 +1,109 @@
+#include "flop_equity_table.h"
+
+#include <cstdio>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+namespace nit {
+namespace test {
+
+TEST_CASE("flop_classes", "[FlopEquityTable]") {
+  CHECK(FlopEquityTable::flops().size() == FlopEquityTable::kFlops);
+  CHECK(FlopEquityTable::flopIndex(CardSet("AcKc7d")) ==
+        FlopEquityTable::flopIndex(CardSet("AhKh7s")));
+  CHECK(FlopEquityTable::flopIndex(CardSet("AcKc7d")) !=
+        FlopEquityTable::flopIndex(CardSet("AcKd7h")));
+  CHECK(FlopEquityTable::holdingIndex(CardSet("3c2c")) == 0);
+  CHECK_THROWS_AS(FlopEquityTable::flopIndex(CardSet("AcKc")),
+                  InvalidArgument);
+  CHECK_THROWS_AS(FlopEquityTable::holdingIndex(CardSet("AcKcQc")),
+                  InvalidArgument);
+}
+
+TEST_CASE("flop_draw_classes", "[FlopEquityTable]") {
+  CardSet flop("9h8h2c");
+  CHECK(FlopEquityTable::drawClass(flop, CardSet("AsKd")) ==
+        FlopEquityTable::NO_DRAW);
+  CHECK(FlopEquityTable::drawClass(flop, CardSet("AhKd")) ==
+        FlopEquityTable::BACKDOOR_FLUSH);
+  CHECK(FlopEquityTable::drawClass(flop, CardSet("JsTd")) ==
+        FlopEquityTable::OPEN_ENDED);
+  CHECK(FlopEquityTable::drawClass(flop, CardSet("Ts7d")) ==
+        FlopEquityTable::OPEN_ENDED);
+  CHECK(FlopEquityTable::drawClass(flop, CardSet("QsTd")) ==
+        FlopEquityTable::GUTSHOT);
+  CHECK(FlopEquityTable::drawClass(flop, CardSet("AhKh")) ==
+        FlopEquityTable::FLUSH_DRAW);
+  CHECK(FlopEquityTable::drawClass(flop, CardSet("ThJh")) ==
+        FlopEquityTable::COMBO_DRAW);
+  // the wheel, and nothing left to draw to with a made hand
+  CHECK(FlopEquityTable::drawClass(CardSet("Ac3d4h"), CardSet("Ks5s")) ==
+        FlopEquityTable::GUTSHOT);
+  CHECK(FlopEquityTable::drawClass(CardSet("9h8h7h"), CardSet("ThJh")) ==
+        FlopEquityTable::NO_DRAW);
+  CHECK(FlopEquityTable::drawName(FlopEquityTable::FLUSH_DRAW) ==
+        "flush draw");
+  CHECK_THROWS_AS(FlopEquityTable::drawName(FlopEquityTable::NUM_DRAWS),
+                  InvalidArgument);
+}
+
+TEST_CASE("flop_table_lookup", "[FlopEquityTable]") {
+  auto peval = makeEvaluator("h");
+  CardSet flop = CardSet(FlopEquityTable::flops()[0]);
+  std::vector<FlopHoldingEntry> built = FlopEquityTable::build(flop, *peval);
+  REQUIRE(built.size() == FlopEquityTable::kHoldings);
+
+  // the holdings against each other split the pot evenly on average
+  double total = 0.0;
+  size_t holdings = 0;
+  for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++) {
+    for (size_t lo = 0; lo < hi; lo++) {
+      CardSet holding(UINT64_C(1) << hi | UINT64_C(1) << lo);
+      const FlopHoldingEntry& entry =
+          built[FlopEquityTable::holdingIndex(holding)];
+      if (holding.intersects(flop)) {
+        CHECK(entry.equity == 0.0f);
+        continue;
+      }
+      CHECK(entry.equity > 0.0f);
+      CHECK(entry.equity <= 1.0f);
+      total += entry.equity;
+      holdings++;
+    }
+  }
+  CHECK(holdings == 1176);
+  CHECK(total / holdings == Approx(0.5));
+
+  std::vector<FlopHoldingEntry> entries(FlopEquityTable::kFlops *
+                                        FlopEquityTable::kHoldings);
+  std::copy(built.begin(), built.end(), entries.begin());
+  const std::string path = "nit_flop_table.bin";
+  FlopEquityTable::write(path, entries);
+  {
+    FlopEquityTable table(path);
+    // any flop of the class and the holding with its suits rotated along
+    CardSet holding("AcKd");
+    CardSet other = flop.rotateSuits(2, 3, 0, 1);
+    const FlopHoldingEntry& entry =
+        table.get(other, holding.rotateSuits(2, 3, 0, 1));
+    CHECK(entry.equity ==
+          built[FlopEquityTable::holdingIndex(holding)].equity);
+    CHECK(entry.handClass ==
+          peval->evaluateHand(holding, flop).high().type());
+    CHECK(entry.drawClass ==
+          FlopEquityTable::drawClass(flop, holding));
+    CHECK_THROWS_AS(table.get(flop, CardSet(flop.cardSets()[0].mask() |
+                                            holding.cardSets()[0].mask())),
+                    InvalidArgument);
+  }
+  std::remove(path.c_str());
+
+  CHECK_THROWS_AS(FlopEquityTable::write(path, built), InvalidArgument);
+  CHECK_THROWS_AS(FlopEquityTable(path), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,136 @@
+#include "hand_potential_enumerator.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+#include "hand_potential_table.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+/// the potential of one holding, from every opponent on every runout
+HandPotential bruteForce(const CardSet& board, const CardSet& holding) {
+  auto peval = makeEvaluator("h");
+  const int now = peval->evaluateHand(holding, board).high().code();
+  double counts[3][3] = {{0.0}};
+  double strength[3] = {0.0};
+  HandPotential result;
+  size_t runouts = 0;
+  for (size_t card = 0; card < STANDARD_DECK_SIZE; card++) {
+    CardSet river(UINT64_C(1) << card);
+    if (river.intersects(board | holding))
+      continue;
+    const CardSet full = board | river;
+    const int later = peval->evaluateHand(holding, full).high().code();
+    double n[3] = {0.0};
+    for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++) {
+      for (size_t lo = 0; lo < hi; lo++) {
+        CardSet other(UINT64_C(1) << hi | UINT64_C(1) << lo);
+        if (other.intersects(board | holding))
+          continue;
+        int a = peval->evaluateHand(other, board).high().code();
+        int o = a < now ? 0 : a == now ? 1 : 2;
+        if (runouts == 0)
+          strength[o]++;
+        if (other.intersects(river))
+          continue;
+        int b = peval->evaluateHand(other, full).high().code();
+        int r = b < later ? 0 : b == later ? 1 : 2;
+        counts[o][r]++;
+        n[r]++;
+      }
+    }
+    double share = (n[0] + n[1] / 2) / (n[0] + n[1] + n[2]);
+    result.ehs += share;
+    result.ehs2 += share * share;
+    runouts++;
+  }
+  result.strength = (strength[0] + strength[1] / 2) /
+                    (strength[0] + strength[1] + strength[2]);
+  result.ehs /= runouts;
+  result.ehs2 /= runouts;
+  double behind = counts[2][0] + counts[2][1] + counts[2][2] +
+                  (counts[1][0] + counts[1][1] + counts[1][2]) / 2;
+  double ahead = counts[0][0] + counts[0][1] + counts[0][2] +
+                 (counts[1][0] + counts[1][1] + counts[1][2]) / 2;
+  if (behind > 0)
+    result.ppot =
+        (counts[2][0] + counts[2][1] / 2 + counts[1][0] / 2) / behind;
+  if (ahead > 0)
+    result.npot = (counts[0][2] + counts[1][2] / 2 + counts[0][1] / 2) / ahead;
+  return result;
+}
+
+}  // namespace
+
+TEST_CASE("hand_potential_matches_brute_force", "[HandPotentialEnumerator]") {
+  CardSet board("Th9h4c2s");
+  std::vector<HandPotential> all = HandPotentialEnumerator().calculate(board);
+  REQUIRE(all.size() == 1326);
+  for (const char* hand : {"AhKh", "JcQd", "TcTd", "Ts4s", "3d5d"}) {
+    CardSet holding(hand);
+    INFO(hand);
+    HandPotential expected = bruteForce(board, holding);
+    const HandPotential& got = all[holding.colex()];
+    CHECK(got.strength == Approx(expected.strength));
+    CHECK(got.ehs == Approx(expected.ehs));
+    CHECK(got.ehs2 == Approx(expected.ehs2));
+    CHECK(got.ppot == Approx(expected.ppot));
+    CHECK(got.npot == Approx(expected.npot));
+  }
+  CHECK(all[CardSet("Th2c").colex()].ehs == 0.0);
+}
+
+TEST_CASE("hand_potential_threads_and_batches", "[HandPotentialEnumerator]") {
+  CardSet turn("Th9h4c2s");
+  CardSet river("Th9h4c2s2d");
+  std::vector<HandPotential> single = HandPotentialEnumerator().calculate(turn);
+  std::vector<HandPotential> split = HandPotentialEnumerator(3).calculate(turn);
+  std::vector<std::vector<HandPotential>> batch =
+      HandPotentialEnumerator(2).calculate({river, turn});
+  REQUIRE(batch.size() == 2);
+  for (size_t i = 0; i < single.size(); i++) {
+    CHECK(split[i].ehs == Approx(single[i].ehs));
+    CHECK(split[i].ppot == Approx(single[i].ppot));
+    CHECK(batch[1][i].npot == Approx(single[i].npot));
+  }
+
+  // nothing is left to come on the river
+  const HandPotential& nuts = batch[0][CardSet("2c2h").colex()];
+  CHECK(nuts.strength == 1.0);
+  CHECK(nuts.ehs == 1.0);
+  CHECK(nuts.ppot == 0.0);
+  CHECK(nuts.npot == 0.0);
+
+  CHECK_THROWS_AS(HandPotentialEnumerator().calculate(CardSet("AcKd")),
+                  InvalidArgument);
+}
+
+TEST_CASE("hand_potential_table_boards", "[HandPotentialTable]") {
+  CHECK(HandPotentialTable::boards(3).size() == 1755);
+  CHECK(HandPotentialTable::boards(4).size() == 16432);
+  CHECK(HandPotentialTable::boardIndex(CardSet("AcKc7d")) ==
+        HandPotentialTable::boardIndex(CardSet("AsKs7h")));
+  CHECK(HandPotentialTable::boardIndex(CardSet("AcKc7d2h")) !=
+        HandPotentialTable::boardIndex(CardSet("AcKc7d2c")));
+  CHECK_THROWS_AS(HandPotentialTable::boards(2), InvalidArgument);
+
+  const std::string path = "nit_hand_potential_table.bin";
+  {
+    std::ofstream out(path);
+    out << "not a table";
+  }
+  CHECK_THROWS_AS(HandPotentialTable(path), InvalidArgument);
+  std::remove(path.c_str());
+  CHECK_THROWS_AS(HandPotentialTable(path), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
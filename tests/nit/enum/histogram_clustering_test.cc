@@ -0,0 +1,103 @@
+#include "histogram_clustering.h"
+
+#include <cmath>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+
+namespace nit {
+namespace test {
+
+TEST_CASE("HistogramClustering.Separated", "[HistogramClustering]") {
+  // three clumps of two quantile points, the middle one twice as heavy
+  const uint16_t clumps[3][2] = {{1000, 3000}, {30000, 35000}, {60000, 65000}};
+  std::vector<uint16_t> points;
+  std::vector<float> weights;
+  for (int i = 0; i < 300; i++) {
+    const uint16_t* clump = clumps[(i * 7) % 3];
+    points.push_back(static_cast<uint16_t>(clump[0] + i % 11));
+    points.push_back(static_cast<uint16_t>(clump[1] + i % 13));
+    weights.push_back((i * 7) % 3 == 1 ? 2.0f : 1.0f);
+  }
+
+  for (size_t threads : {1, 3}) {
+    HistogramClustering clustering(2, 3, threads);
+    std::vector<uint16_t> assignment = clustering.cluster(points, weights, 10);
+    REQUIRE(assignment.size() == 300);
+    for (size_t i = 0; i < assignment.size(); i++)
+      CHECK(assignment[i] == (i * 7) % 3);
+    REQUIRE(clustering.centers().size() == 6);
+    CHECK(clustering.centers()[0] < clustering.centers()[2]);
+    CHECK(clustering.centers()[2] < clustering.centers()[4]);
+    CHECK(clustering.cost() < 0.001);
+  }
+}
+
+TEST_CASE("HistogramClustering.Median", "[HistogramClustering]") {
+  // the center is the weighted median, the far point does not pull it
+  std::vector<uint16_t> points = {1000, 2000, 3000, 65535};
+  std::vector<float> weights = {1.0f, 2.0f, 1.0f, 1.0f};
+  HistogramClustering clustering(1, 1);
+  clustering.cluster(points, weights, 5);
+  REQUIRE(clustering.centers().size() == 1);
+  CHECK(clustering.centers()[0] == Approx(2000 / 65535.0));
+  CHECK(clustering.cost() == Approx((1000 + 1000 + 63535) / (5 * 65535.0)));
+}
+
+TEST_CASE("HistogramClustering.Nearest", "[HistogramClustering]") {
+  // scattered points, stopped after one move of the centers
+  std::vector<uint16_t> points;
+  std::vector<float> weights;
+  uint32_t state = 12345;
+  for (size_t i = 0; i < 10000; i++) {
+    for (size_t d = 0; d < 2; d++) {
+      state = state * 1103515245u + 12345u;
+      points.push_back(static_cast<uint16_t>(state >> 16));
+    }
+    weights.push_back(1.0f + i % 3);
+  }
+
+  HistogramClustering one(2, 5, 1);
+  std::vector<uint16_t> assignment = one.cluster(points, weights, 1);
+  const std::vector<double>& centers = one.centers();
+  size_t farther = 0;  // points with a nearer center than their own
+  for (size_t i = 0; i < weights.size(); i++) {
+    double distances[5];
+    for (size_t c = 0; c < 5; c++)
+      distances[c] = std::fabs(points[2 * i] / 65535.0 - centers[2 * c]) +
+                     std::fabs(points[2 * i + 1] / 65535.0 -
+                               centers[2 * c + 1]);
+    for (size_t c = 0; c < 5; c++)
+      if (distances[c] + 1e-12 < distances[assignment[i]]) {
+        farther++;
+        break;
+      }
+  }
+  CHECK(farther == 0);
+
+  // the threads do not change the result
+  HistogramClustering four(2, 5, 4);
+  CHECK(four.cluster(points, weights, 1) == assignment);
+  CHECK(four.centers() == centers);
+  CHECK(four.cost() == one.cost());
+}
+
+TEST_CASE("HistogramClustering.Distance", "[HistogramClustering]") {
+  const uint16_t a[2] = {0, 65535};
+  const uint16_t b[2] = {65535, 65535};
+  CHECK(HistogramClustering::distance(a, a, 2) == 0.0);
+  CHECK(HistogramClustering::distance(a, b, 2) == Approx(0.5));
+}
+
+TEST_CASE("HistogramClustering.Invalid", "[HistogramClustering]") {
+  CHECK_THROWS_AS(HistogramClustering(0, 2), InvalidArgument);
+  CHECK_THROWS_AS(HistogramClustering(2, 0), InvalidArgument);
+  HistogramClustering clustering(2, 2);
+  CHECK_THROWS_AS(clustering.cluster({1, 2, 3}, {1.0f, 1.0f}, 1),
+                  InvalidArgument);
+  CHECK_THROWS_AS(clustering.cluster({}, {}, 1), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,103 @@
+#include "incremental_equity.h"
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+std::vector<CardDistribution> parseDistributions(
+    const std::vector<std::string>& inputs) {
+  std::vector<CardDistribution> dists;
+  for (const std::string& input : inputs) {
+    dists.emplace_back();
+    dists.back().parse(input);
+  }
+  return dists;
+}
+
+/// the shares of a full enumeration of the current ranges
+void checkAgainstFull(IncrementalEquity& incremental, size_t players,
+                      const CardSet& board, const PokerHandEvaluator& peval) {
+  std::vector<CardDistribution> dists;
+  for (size_t p = 0; p < players; p++)
+    dists.push_back(incremental.range(p));
+  std::vector<EquityResult> expected =
+      ShowdownEnumerator().calculateEquity(dists, board, peval);
+  const std::vector<EquityResult>& results = incremental.results();
+  for (size_t p = 0; p < players; p++) {
+    CHECK(results[p].winShares == Approx(expected[p].winShares));
+    CHECK(results[p].tieShares == Approx(expected[p].tieShares));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("IncrementalEquity.WeightChanges", "[IncrementalEquity]") {
+  auto peval = makeEvaluator("h");
+  const CardSet board("2c7cTd");
+  const std::vector<CardDistribution> dists = parseDistributions(
+      {"AcKc,AdKd,QsQh=0.5", "QdQh,JcJs,7c2d,9s8s", "AhJh,6d6c=0.25"});
+
+  for (size_t limit : {IncrementalEquity::kDefaultMemoryLimit, size_t(0)}) {
+    IncrementalEquity incremental(dists, board, *peval, limit);
+    CHECK(incremental.retained() == (limit > 0));
+    CHECK((incremental.memoryUsage() > 0) == incremental.retained());
+    checkAgainstFull(incremental, 3, board, *peval);
+
+    incremental.setWeight(0, CardSet("QsQh"), 2.0);
+    checkAgainstFull(incremental, 3, board, *peval);
+    incremental.setWeight(1, CardSet("JcJs"), 0.0);
+    checkAgainstFull(incremental, 3, board, *peval);
+    incremental.setWeight(1, CardSet("JcJs"), 0.75);
+    incremental.setWeight(2, CardSet("6d6c"), 1.0);
+    checkAgainstFull(incremental, 3, board, *peval);
+
+    // a whole range at once, the hands it leaves out go to zero
+    CardDistribution range = parseDistributions({"AcKc=0.5,QsQh"})[0];
+    incremental.setWeights(0, range);
+    CHECK(incremental.range(0)[CardSet("AdKd")] == 0.0);
+    checkAgainstFull(incremental, 3, board, *peval);
+  }
+}
+
+TEST_CASE("IncrementalEquity.MemoryLimit", "[IncrementalEquity]") {
+  auto peval = makeEvaluator("h");
+  const CardSet board("2c7cTd");
+  const std::vector<CardDistribution> dists =
+      parseDistributions({"AcKc,AdKd,QsQh", "QdQh,JcJs,9s8s"});
+
+  // the tuples and their index take exactly what is reserved for them
+  IncrementalEquity full(dists, board, *peval);
+  REQUIRE(full.retained());
+  const size_t used = full.memoryUsage();
+  CHECK(IncrementalEquity(dists, board, *peval, used).retained());
+  CHECK(IncrementalEquity(dists, board, *peval, used).memoryUsage() == used);
+  CHECK_FALSE(IncrementalEquity(dists, board, *peval, used - 1).retained());
+}
+
+TEST_CASE("IncrementalEquity.Invalid", "[IncrementalEquity]") {
+  auto peval = makeEvaluator("h");
+  const CardSet board("2c7cTd");
+  CHECK_THROWS_AS(
+      IncrementalEquity(parseDistributions({"AcKc"}), board, *peval),
+      InvalidArgument);
+  IncrementalEquity incremental(parseDistributions({"AcKc", "QdQh"}), board,
+                                *peval);
+  CHECK_THROWS_AS(incremental.setWeight(0, CardSet("AhKh"), 1.0),
+                  InvalidArgument);
+  CHECK_THROWS_AS(incremental.setWeight(2, CardSet("AcKc"), 1.0),
+                  InvalidArgument);
+  CHECK_THROWS_AS(
+      incremental.setWeights(1, parseDistributions({"QdQh,JcJs"})[0]),
+      InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,80 @@
+#include "omaha_equity_table.h"
+
+#include <cstdio>
+
+#include <utility>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+namespace nit {
+namespace test {
+
+TEST_CASE("omaha_classes", "[OmahaEquityTable]") {
+  CHECK(OmahaEquityTable::classes().size() == OmahaEquityTable::kClasses);
+  CHECK(OmahaEquityTable::classIndex(CardSet("AcAdKcKd")) ==
+        OmahaEquityTable::classIndex(CardSet("AhAsKhKs")));
+  CHECK(OmahaEquityTable::classIndex(CardSet("AcAdKcKd")) !=
+        OmahaEquityTable::classIndex(CardSet("AcAdKhKs")));
+  size_t index = OmahaEquityTable::classIndex(CardSet("2c7d9hTs"));
+  CHECK(OmahaEquityTable::classIndex(
+            CardSet(OmahaEquityTable::classes()[index])) == index);
+  CHECK_THROWS_AS(OmahaEquityTable::classIndex(CardSet("AcAd")),
+                  InvalidArgument);
+}
+
+TEST_CASE("omaha_table_lookup", "[OmahaEquityTable]") {
+  auto high = makeEvaluator("O");
+  double bound = 0.0;
+  OmahaClassEquity aces = OmahaEquityTable::sample(
+      *high, CardSet("AcAdKcKd"), 2000, 1, bound);
+  CHECK(bound < 0.05);
+  CHECK(aces.equity > 0.6);
+  CHECK(aces.equity < 0.8);
+  CHECK(aces.high == aces.equity);
+  CHECK(aces.low == 0.0f);
+  CHECK(aces.scoop <= aces.equity);
+
+  // in omaha/8 the equity is half of each share, and the whole high
+  // share on the boards without a low
+  auto eight = makeEvaluator("o");
+  OmahaClassEquity wheel = OmahaEquityTable::sample(
+      *eight, CardSet("Ac2c3dKd"), 2000, 1, bound);
+  CHECK(wheel.low > 0.0f);
+  CHECK(wheel.equity >= (wheel.high + wheel.low) / 2);
+  CHECK(wheel.equity <= (wheel.high + wheel.low) / 2 + wheel.high / 2);
+  CHECK(wheel.scoop <= wheel.equity);
+
+  std::vector<OmahaClassEquity> entries(OmahaEquityTable::kClasses);
+  for (size_t i = 0; i < entries.size(); i++)
+    entries[i].hand = OmahaEquityTable::classes()[i];
+  size_t index = OmahaEquityTable::classIndex(CardSet("AcAdKcKd"));
+  entries[index] = aces;
+  const std::string path = "nit_omaha_table.bin";
+  OmahaEquityTable::write(path, 'O', 2000, bound, entries);
+  {
+    OmahaEquityTable table(path);
+    CHECK(table.game() == 'O');
+    CHECK(table.samples() == 2000);
+    CHECK(table.get(CardSet("AhAsKhKs")).equity == aces.equity);
+    CHECK(table.get(CardSet("AhAsKhKs")).hand == aces.hand);
+    CHECK(table.get(CardSet("2c7d9hTs")).hand ==
+          CardSet("2c7d9hTs").canonize().mask());
+    CHECK_THROWS_AS(table.get(CardSet("AcAd")), InvalidArgument);
+  }
+
+  // the entries must be in the order of their hands
+  std::swap(entries[0], entries[1]);
+  OmahaEquityTable::write(path, 'O', 2000, bound, entries);
+  CHECK_THROWS_AS(OmahaEquityTable(path), InvalidArgument);
+  std::remove(path.c_str());
+
+  CHECK_THROWS_AS(OmahaEquityTable::write(path, 'O', 1, 0.0, {aces}),
+                  InvalidArgument);
+  CHECK_THROWS_AS(OmahaEquityTable(path), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
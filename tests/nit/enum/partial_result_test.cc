@@ -0,0 +1,83 @@
+#include "partial_result.h"
+
+#include <sstream>
+
+#include <catch.hpp>
+
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+PartialResult runShard(const Shard& shard) {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists(2);
+  dists[0].parse("AsKs");
+  dists[1].fill(peval->handSize());
+  EnumerationOptions options;
+  options.shard = shard;
+
+  PartialResult partial;
+  partial.game = "h";
+  partial.board = "2c7c8s";
+  partial.hands = {"AsKs"};
+  partial.shard = shard;
+  partial.results = ShowdownEnumerator().calculateExactEquity(
+      dists, CardSet(partial.board), *peval, options);
+  return partial;
+}
+
+}  // namespace
+
+TEST_CASE("partial_result_round_trip", "[PartialResult]") {
+  PartialResult partial = runShard(Shard(1, 3));
+  partial.results[0].winShares = UInt128(7, 11);
+  std::stringstream text;
+  partial.write(text);
+
+  PartialResult read = PartialResult::read(text);
+  CHECK(read.game == "h");
+  CHECK(read.board == "2c7c8s");
+  CHECK(read.hands == partial.hands);
+  CHECK(read.shard.index == 1);
+  CHECK(read.shard.count == 3);
+  REQUIRE(read.results.size() == 2);
+  CHECK(read.results[0].winShares == UInt128(7, 11));
+  CHECK(read.results[1].tieShares == partial.results[1].tieShares);
+  CHECK(read.results[1].scale == 2);
+}
+
+TEST_CASE("partial_result_merge", "[PartialResult]") {
+  std::vector<PartialResult> partials;
+  for (size_t i = 0; i < 3; i++) {
+    std::stringstream text;
+    runShard(Shard(i, 3)).write(text);
+    partials.push_back(PartialResult::read(text));
+  }
+  PartialResult merged = mergePartialResults(partials);
+  PartialResult whole = runShard(Shard());
+  CHECK(merged.shard.count == 1);
+  for (size_t i = 0; i < 2; i++) {
+    CHECK(merged.results[i].winShares == whole.results[i].winShares);
+    CHECK(merged.results[i].tieShares == whole.results[i].tieShares);
+  }
+
+  partials.pop_back();
+  CHECK_THROWS_AS(mergePartialResults(partials), InvalidArgument);
+  partials.push_back(partials.front());
+  CHECK_THROWS_AS(mergePartialResults(partials), InvalidArgument);
+}
+
+TEST_CASE("partial_result_bad_input", "[PartialResult]") {
+  std::stringstream bad("nit-partial 1\nresult 12 x 2\n");
+  CHECK_THROWS_AS(PartialResult::read(bad), ParseError);
+  std::stringstream other("something else\n");
+  CHECK_THROWS_AS(PartialResult::read(other), ParseError);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -22,6 +22,31 @@ TEST_CASE("chinese_settings", "[PartitionEnumerator]") {
   CHECK(visits == 72072);
 }
 
+TEST_CASE("partition_seek_and_rank", "[PartitionEnumerator]") {
+  std::vector<std::size_t> partitions = {2, 0, 3, 1};
+  uint64_t total = PartitionEnumerator2::count(9, partitions);
+  CHECK(total == 36 * 35 * 4);
+
+  uint64_t steps = 0;
+  PartitionEnumerator2 walker(9, partitions);
+  do {
+    CHECK(walker.rank() == steps);
+    if (steps % 97 == 0) {
+      PartitionEnumerator2 seeker(9, partitions);
+      seeker.seek(steps);
+      for (size_t p = 0; p < partitions.size(); p++)
+        CHECK(seeker.getMask(p) == walker.getMask(p));
+      CHECK(seeker.str() == walker.str());
+      // the seeker carries on from where it was put
+      CHECK(seeker.next() == (steps + 1 < total));
+      if (steps + 1 < total)
+        CHECK(seeker.rank() == steps + 1);
+    }
+    steps++;
+  } while (walker.next());
+  CHECK(steps == total);
+}
+
 TEST_CASE("slow_all_ofcp_draws", "[.PartitionEnumerator]") {
   // ofcp = open face chinese poker
   // compute the number of possible draw sets in open face chinese poker
@@ -0,0 +1,103 @@
+#include "preflop_equity_table.h"
+
+#include <cstdio>
+
+#include <fstream>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+TEST_CASE("preflop_matchup_keys", "[PreflopEquityTable]") {
+  // the distinct heads up matchups
+  CHECK(PreflopEquityTable::keys().size() == 47008);
+
+  bool swapped = false;
+  uint32_t key = PreflopEquityTable::key(CardSet("AcAd"), CardSet("KsKh"),
+                                         swapped);
+  bool other = false;
+  CHECK(PreflopEquityTable::key(CardSet("AhAs"), CardSet("KcKd"), other) ==
+        key);
+  CHECK(other == swapped);
+  CHECK(PreflopEquityTable::key(CardSet("KcKd"), CardSet("AhAs"), other) ==
+        key);
+  CHECK(other != swapped);
+
+  CardSet a, b;
+  PreflopEquityTable::hands(key, a, b);
+  CHECK(PreflopEquityTable::key(a, b, other) == key);
+  CHECK_FALSE(other);
+
+  CHECK(PreflopEquityTable::handClass(CardSet("AcKc")) == "AKs");
+  CHECK(PreflopEquityTable::handClass(CardSet("2h9d")) == "92o");
+  CHECK(PreflopEquityTable::handClass(CardSet("7s7d")) == "77");
+}
+
+TEST_CASE("preflop_table_lookup", "[PreflopEquityTable]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists = {CardDistribution(CardSet("AcAd")),
+                                         CardDistribution(CardSet("KsKh"))};
+  std::vector<EquityResult> expected =
+      ShowdownEnumerator().calculateEquity(dists, CardSet(), *peval);
+
+  // one real matchup, and one made up to check the ranges with
+  bool swapped = false;
+  PreflopMatchup aces;
+  aces.key = PreflopEquityTable::key(CardSet("AcAd"), CardSet("KsKh"),
+                                     swapped);
+  aces.wins = static_cast<uint32_t>(expected[swapped ? 1 : 0].winShares);
+  aces.losses = static_cast<uint32_t>(expected[swapped ? 0 : 1].winShares);
+  aces.ties = static_cast<uint32_t>(expected[0].tieShares * 2.0);
+  PreflopMatchup other;
+  other.key = PreflopEquityTable::key(CardSet("AcAd"), CardSet("AhKs"),
+                                      swapped);
+  other.wins = 10;
+  other.losses = 20;
+  other.ties = 4;
+  const std::string path = "nit_preflop_table.bin";
+  PreflopEquityTable::write(path, {other, aces});
+
+  {
+    PreflopEquityTable table(path);
+    CHECK(table.size() == 2);
+    std::vector<EquityResult> results =
+        table.calculateEquity(CardSet("KdKc"), CardSet("AsAh"));
+    CHECK(results[0].winShares == expected[1].winShares);
+    CHECK(results[1].winShares == expected[0].winShares);
+    CHECK(results[0].tieShares == expected[0].tieShares);
+
+    // the pairs of a range add up
+    CardDistribution hero, villain;
+    hero.parse("AcAd");
+    villain.parse("KsKh,AhKs");
+    std::vector<EquityResult> ranges = table.calculateEquity(hero, villain);
+    const double win = swapped ? 20 : 10;
+    CHECK(ranges[0].winShares == Approx(expected[0].winShares + win));
+    CHECK(ranges[0].tieShares == Approx(expected[0].tieShares + 2));
+
+    // card removal, AhKs can not meet AsAh
+    hero.parse("AcAd,AsAh");
+    villain.parse("AhKs");
+    ranges = table.calculateEquity(hero, villain);
+    CHECK(ranges[0].winShares == Approx(win));
+
+    CHECK_THROWS_AS(table.calculateEquity(CardSet("QcQd"), CardSet("KsKh")),
+                    DomainError);
+    CHECK_THROWS_AS(table.calculateEquity(CardSet("AcKd"), CardSet("KdKh")),
+                    InvalidArgument);
+  }
+  std::remove(path.c_str());
+
+  std::ofstream(path) << "not a table";
+  CHECK_THROWS_AS(PreflopEquityTable(path), InvalidArgument);
+  std::remove(path.c_str());
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,96 @@
+#include "random_opponents_table.h"
+
+#include <cstdio>
+
+#include <sstream>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+
+#include "preflop_equity_table.h"
+
+namespace nit {
+namespace test {
+
+TEST_CASE("starting_hand_classes", "[RandomOpponentsTable]") {
+  std::vector<size_t> combos(RandomOpponentsTable::kClasses);
+  for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++)
+    for (size_t lo = 0; lo < hi; lo++)
+      combos[RandomOpponentsTable::classIndex(
+          CardSet(UINT64_C(1) << hi | UINT64_C(1) << lo))]++;
+  for (size_t cls = 0; cls < RandomOpponentsTable::kClasses; cls++) {
+    std::string name = RandomOpponentsTable::className(cls);
+    CHECK(RandomOpponentsTable::classIndex(name) == cls);
+    CHECK(RandomOpponentsTable::classIndex(
+              RandomOpponentsTable::classHand(cls)) == cls);
+    CHECK(combos[cls] == (name.size() == 2 ? 6u : name[2] == 's' ? 4u : 12u));
+  }
+  CHECK(RandomOpponentsTable::className(0) == "AA");
+  CHECK(RandomOpponentsTable::className(1) == "AKs");
+  CHECK(RandomOpponentsTable::className(13) == "AKo");
+  CHECK(RandomOpponentsTable::classIndex(CardSet("7h2c")) ==
+        RandomOpponentsTable::classIndex("72o"));
+  CHECK_THROWS_AS(RandomOpponentsTable::classIndex("AAs"), InvalidArgument);
+}
+
+TEST_CASE("random_opponents_lookup", "[RandomOpponentsTable]") {
+  RandomOpponentsTable table;
+  CHECK_FALSE(table.complete());
+  CHECK_THROWS_AS(table.equity(CardSet("AcAd"), 1), DomainError);
+
+  // aces win about 85.2% heads up against a random hand
+  RandomOpponentsEquity aces =
+      RandomOpponentsTable::sample(RandomOpponentsTable::classIndex("AA"), 1,
+                                   100000);
+  CHECK(aces.samples == 100000);
+  CHECK(aces.errorBound < 0.003);
+  CHECK(aces.equity == Approx(0.852).margin(aces.errorBound * 1.5));
+  table.set(0, 1, aces);
+  CHECK(table.equity(CardSet("AhAs"), 1) == aces.equity);
+  CHECK_THROWS_AS(table.equity(CardSet("AhAs"), 10), InvalidArgument);
+
+  std::stringstream text;
+  table.write(text);
+  RandomOpponentsTable back = RandomOpponentsTable::read(text);
+  CHECK(back.get(0, 1).equity == aces.equity);
+  CHECK(back.get(0, 1).samples == aces.samples);
+  CHECK_THROWS_AS(back.get(0, 2), DomainError);
+
+  std::stringstream bad("nit-random-opponents 1\nAAx 1 0.5 0 0\n");
+  CHECK_THROWS_AS(RandomOpponentsTable::read(bad), ParseError);
+}
+
+TEST_CASE("random_opponent_exact", "[RandomOpponentsTable]") {
+  // a made up table in which aces win every board, but against aces
+  std::vector<PreflopMatchup> entries;
+  for (uint32_t key : PreflopEquityTable::keys()) {
+    CardSet a, b;
+    PreflopEquityTable::hands(key, a, b);
+    bool first = PreflopEquityTable::handClass(a) == "AA";
+    bool second = PreflopEquityTable::handClass(b) == "AA";
+    if (!first && !second)
+      continue;
+    PreflopMatchup entry;
+    entry.key = key;
+    if (first && second)
+      entry.ties = 1712304;
+    else
+      (first ? entry.wins : entry.losses) = 1712304;
+    entries.push_back(entry);
+  }
+  const std::string path = "nit_random_opponents.bin";
+  PreflopEquityTable::write(path, entries);
+  {
+    PreflopEquityTable table(path);
+    RandomOpponentsEquity aces = RandomOpponentsTable::exact(table, 0);
+    // AcAd meets 1225 hands, and splits with AhAs
+    CHECK(aces.equity == Approx(1224.5 / 1225));
+    CHECK(aces.samples == 0);
+    CHECK_THROWS_AS(RandomOpponentsTable::exact(table, 1), DomainError);
+  }
+  std::remove(path.c_str());
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,288 @@
+#include "showdown_enumerator.h"
+
+#include <atomic>
+#include <chrono>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+namespace nit {
+namespace test {
+
+namespace {
+
+std::vector<CardDistribution> parseDistributions(
+    const std::vector<std::string>& inputs) {
+  std::vector<CardDistribution> dists;
+  for (const std::string& input : inputs) {
+    dists.emplace_back();
+    dists.back().parse(input);
+  }
+  return dists;
+}
+
+}  // namespace
+
+TEST_CASE("holdem_hand_vs_hand", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<EquityResult> results = ShowdownEnumerator().calculateEquity(
+      parseDistributions({"AcKc", "QdQh"}), CardSet("2c7cTd"), *peval);
+  REQUIRE(results.size() == 2);
+  CHECK(results[0].winShares == 539);
+  CHECK(results[1].winShares == 451);
+  CHECK(results[0].tieShares == 0);
+}
+
+TEST_CASE("holdem_weighted_ranges", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<EquityResult> results = ShowdownEnumerator().calculateEquity(
+      parseDistributions({"AcKc,AdKd,QsQh=0.5", "QdQh,JcJs,7c2d"}),
+      CardSet("2c7cTd"), *peval);
+  CHECK(results[0].winShares == 2029);
+  CHECK(results[1].winShares == 2426);
+}
+
+TEST_CASE("holdem_three_way_ranges", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<EquityResult> results = ShowdownEnumerator().calculateEquity(
+      parseDistributions({"AcKc,AdKd", "QdQh,QcQs,JcJd", "JsTs,9s8s,AhKh"}),
+      CardSet("2c7c8s3d"), *peval);
+  CHECK(results[0].winShares == 86);
+  CHECK(results[0].tieShares == 12);
+  CHECK(results[1].winShares == 373);
+  CHECK(results[2].winShares == 21);
+  CHECK(results[2].tieShares == 12);
+}
+
+TEST_CASE("omaha_hand_vs_hand", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("O");
+  std::vector<EquityResult> results = ShowdownEnumerator().calculateEquity(
+      parseDistributions({"AcAdKcKd", "QsQhJsJh"}), CardSet("2c7c8s"), *peval);
+  CHECK(results[0].winShares == 696);
+  CHECK(results[1].winShares == 124);
+}
+
+TEST_CASE("holdem_hand_vs_random", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists = parseDistributions({"AsKs"});
+  dists.emplace_back();
+  dists.back().fill(peval->handSize());
+  std::vector<EquityResult> results = ShowdownEnumerator().calculateEquity(
+      dists, CardSet("2c7c8s3d"), *peval);
+  CHECK(results[0].winShares == 20905);
+  CHECK(results[0].tieShares == 193.5);
+  CHECK(results[1].winShares == 24248);
+}
+
+TEST_CASE("exact_three_way_ranges", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<ExactEquityResult> results =
+      ShowdownEnumerator().calculateExactEquity(
+          parseDistributions(
+              {"AcKc,AdKd", "QdQh,QcQs,JcJd", "JsTs,9s8s,AhKh"}),
+          CardSet("2c7c8s3d"), *peval);
+  REQUIRE(results.size() == 3);
+  CHECK(results[0].scale == 6);
+  CHECK(results[0].winShares == UInt128(86 * 6));
+  CHECK(results[0].tieShares == UInt128(12 * 6));
+  CHECK(results[2].tieShares == UInt128(12 * 6));
+  CHECK(results[1].toEquityResult().winShares == 373);
+}
+
+TEST_CASE("exact_matches_double_hi_lo", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("o");
+  std::vector<CardDistribution> dists =
+      parseDistributions({"AcAd2c3d,AhAs2h3h=3", "QsQhJsJh,KcKdQdJd"});
+  std::vector<EquityResult> approx =
+      ShowdownEnumerator().calculateEquity(dists, CardSet("4c7c8s"), *peval);
+  std::vector<ExactEquityResult> exact =
+      ShowdownEnumerator().calculateExactEquity(dists, CardSet("4c7c8s"),
+                                                *peval);
+  CHECK(exact[0].scale == 4);
+  for (size_t i = 0; i < 2; i++) {
+    CHECK(exact[i].toEquityResult().winShares == Approx(approx[i].winShares));
+    CHECK(exact[i].toEquityResult().tieShares == Approx(approx[i].tieShares));
+  }
+}
+
+TEST_CASE("exact_needs_whole_weights", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  CHECK_THROWS_AS(
+      ShowdownEnumerator().calculateExactEquity(
+          parseDistributions({"AcKc,QsQh=0.5", "QdQh"}), CardSet(), *peval),
+      InvalidArgument);
+}
+
+TEST_CASE("sharded_enumeration_adds_up", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists =
+      parseDistributions({"AcKc,AdKd,QsQh", "QdQh,JcJs,7c2d"});
+  CardSet board("2c7cTd");
+  std::vector<ExactEquityResult> whole =
+      ShowdownEnumerator().calculateExactEquity(dists, board, *peval);
+
+  // more shards than tuples, so shards start inside a tuple
+  for (size_t count : {1, 2, 7, 100}) {
+    std::vector<ExactEquityResult> sum(2);
+    for (size_t index = 0; index < count; index++) {
+      EnumerationOptions options;
+      options.shard = Shard(index, count);
+      std::vector<ExactEquityResult> part =
+          ShowdownEnumerator().calculateExactEquity(dists, board, *peval,
+                                                    options);
+      for (size_t i = 0; i < 2; i++) {
+        sum[i].scale = part[i].scale;
+        sum[i] += part[i];
+      }
+    }
+    for (size_t i = 0; i < 2; i++) {
+      CHECK(sum[i].winShares == whole[i].winShares);
+      CHECK(sum[i].tieShares == whole[i].tieShares);
+    }
+  }
+}
+
+TEST_CASE("shard_parse", "[ShowdownEnumerator]") {
+  Shard shard = Shard::parse("3/8");
+  CHECK(shard.index == 3);
+  CHECK(shard.count == 8);
+  CHECK(shard.str() == "3/8");
+  CHECK_THROWS_AS(Shard::parse("8/8"), InvalidArgument);
+  CHECK_THROWS_AS(Shard::parse("1/"), InvalidArgument);
+  CHECK_THROWS_AS(Shard::parse("-1/4"), InvalidArgument);
+}
+
+TEST_CASE("decided_pruning_is_exact", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  EnumerationOptions full;
+  full.pruneDecided = false;
+  std::vector<std::pair<std::vector<std::string>, std::string>> spots = {
+      {{"AcAd", "7h2s"}, "AsAhKdKc"},
+      {{"AcAd", "KhKs,7h2s,9c8c"}, "AsAhKd"},
+      {{"QdQc", "JsTs", "8h8s"}, "Qh7c2d3s"},
+      {{"AcKc,AdKd", "QdQh,QsQc"}, "2c7cTh"}};
+  for (const auto& spot : spots) {
+    std::vector<CardDistribution> dists = parseDistributions(spot.first);
+    if (dists.size() == 2)
+      dists.emplace_back();
+    dists.back().fill(peval->handSize());
+    CardSet board(spot.second);
+    std::vector<ExactEquityResult> pruned =
+        ShowdownEnumerator().calculateExactEquity(dists, board, *peval);
+    std::vector<ExactEquityResult> visited =
+        ShowdownEnumerator().calculateExactEquity(dists, board, *peval, full);
+    REQUIRE(pruned.size() == visited.size());
+    for (size_t i = 0; i < pruned.size(); i++) {
+      CHECK(pruned[i].winShares == visited[i].winShares);
+      CHECK(pruned[i].tieShares == visited[i].tieShares);
+    }
+  }
+}
+
+TEST_CASE("run_it_twice", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists =
+      parseDistributions({"AcKc", "QdQh"});
+  CardSet turn("2c7cTdJh");
+  std::vector<EquityResult> once =
+      ShowdownEnumerator().calculateEquity(dists, turn, *peval);
+  MultiBoardResult twice = ShowdownEnumerator().calculateMultiBoardEquity(
+      dists, {turn, turn}, *peval);
+
+  // 44 * 43 ordered pairs of rivers, and each board sees every river 43
+  // times, so each board alone has the equity of running it once
+  REQUIRE(twice.boards.size() == 2);
+  for (const std::vector<EquityResult>& board : twice.boards) {
+    CHECK(board[0].winShares == Approx(once[0].winShares * 43));
+    CHECK(board[1].winShares == Approx(once[1].winShares * 43));
+  }
+  CHECK(twice.combined[0].winShares + twice.combined[1].winShares ==
+        Approx(44.0 * 43));
+  CHECK(twice.combined[0].winShares == Approx(once[0].winShares * 43));
+
+  // two different flops, 42c2 * 40c2 deals
+  MultiBoardResult doubled = ShowdownEnumerator().calculateMultiBoardEquity(
+      dists, {CardSet("2c7cTd"), CardSet("3h8sJc")}, *peval);
+  for (const std::vector<EquityResult>& board : doubled.boards)
+    CHECK(board[0].winShares + board[0].tieShares + board[1].winShares +
+              board[1].tieShares ==
+          Approx(861.0 * 780));
+
+  CHECK_THROWS_AS(
+      ShowdownEnumerator().calculateMultiBoardEquity(dists, {}, *peval),
+      InvalidArgument);
+}
+
+TEST_CASE("evaluation_cache_is_exact", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("O");
+  std::vector<CardDistribution> dists =
+      parseDistributions({"AcAdKcKd", "QsQhJsJh,TsTh9s9h,8c8d7c7d"});
+  CardSet flop("2c7h8s");
+  std::vector<EquityResult> plain =
+      ShowdownEnumerator().calculateEquity(dists, flop, *peval);
+  EnumerationOptions options;
+  options.evaluationCache = 4096;
+  std::vector<EquityResult> cached =
+      ShowdownEnumerator().calculateEquity(dists, flop, *peval, options);
+  for (size_t i = 0; i < dists.size(); i++) {
+    CHECK(cached[i].winShares == plain[i].winShares);
+    CHECK(cached[i].tieShares == plain[i].tieShares);
+  }
+}
+
+TEST_CASE("enumeration_progress", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<double> reports;
+  EnumerationStatus status;
+  EnumerationOptions options;
+  options.progress = [&reports](double fraction) {
+    reports.push_back(fraction);
+  };
+  options.status = &status;
+  std::vector<EquityResult> results = ShowdownEnumerator().calculateEquity(
+      parseDistributions({"AcKc", "QdQh"}), CardSet("2c7c"), *peval, options);
+  CHECK(status.complete);
+  CHECK(status.position == 15180);  // 46c3
+  REQUIRE(reports.size() == 15180 / 4096 + 1);
+  for (size_t i = 1; i < reports.size(); i++)
+    CHECK(reports[i] > reports[i - 1]);
+  CHECK(reports[0] == Approx(4096.0 / 15180));
+  CHECK(reports.back() == 1.0);
+}
+
+TEST_CASE("enumeration_cancel", "[ShowdownEnumerator]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists =
+      parseDistributions({"AcKc,AdKd", "QdQh,QsQc"});
+  std::atomic<bool> cancel(false);
+  EnumerationStatus status;
+  EnumerationOptions options;
+  options.cancel = &cancel;
+  options.status = &status;
+  // cancel from the second block on
+  size_t blocks = 0;
+  options.progress = [&cancel, &blocks](double) { cancel = ++blocks == 2; };
+  std::vector<ExactEquityResult> partial =
+      ShowdownEnumerator().calculateExactEquity(dists, CardSet("2c7c"), *peval,
+                                                options);
+  CHECK(blocks == 2);
+  CHECK_FALSE(status.complete);
+  CHECK(status.position == 2 * 4096);
+  CHECK(status.fraction == Approx(2 * 4096.0 / (4 * 15180)));
+  UInt128 shares = partial[0].winShares + partial[0].tieShares +
+                   partial[1].winShares + partial[1].tieShares;
+  CHECK(shares == UInt128(2 * 4096 * 2));
+
+  // a deadline in the past stops at the end of the first block
+  EnumerationOptions late;
+  late.deadline = std::chrono::steady_clock::now();
+  late.status = &status;
+  ShowdownEnumerator().calculateEquity(dists, CardSet("2c7c"), *peval, late);
+  CHECK_FALSE(status.complete);
+  CHECK(status.position == 4096);
+}
+
+}  // namespace test
+}  // namespace nit
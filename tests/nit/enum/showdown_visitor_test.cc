@@ -0,0 +1,93 @@
+#include "showdown_visitor.h"
+
+#include <map>
+
+#include <catch.hpp>
+
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+/// the equity of the first player by turn card, and the block sizes
+class TurnVisitor : public ShowdownVisitor {
+ public:
+  TurnVisitor(const PokerHandEvaluator& peval, const CardSet& flop)
+      : m_peval(peval), m_flop(flop) {}
+
+  void visit(const ShowdownBlock& block) override {
+    sizes.push_back(block.size());
+    for (size_t d = 0; d < block.size(); d++) {
+      CHECK(block.evaluation(d, 1).high() ==
+            m_peval.evaluateHand(block.hand(d, 1), block.board(d)).high());
+      std::vector<EquityResult> shares(block.players());
+      PokerHandEvaluator::awardShowdown(block.evaluations(d), block.players(),
+                                        shares, block.weight(d));
+      CardSet rest = block.board(d) ^ m_flop;
+      for (size_t c = 0; c < STANDARD_DECK_SIZE; c++)
+        if (rest.intersects(CardSet(UINT64_C(1) << c)))
+          byCard[c] += shares[0].winShares + shares[0].tieShares;
+      total += shares[0].winShares + shares[0].tieShares;
+    }
+  }
+
+  std::vector<size_t> sizes;
+  std::map<size_t, double> byCard;
+  double total{0.0};
+
+ private:
+  const PokerHandEvaluator& m_peval;
+  CardSet m_flop;
+};
+
+std::vector<CardDistribution> parseHands(
+    const std::vector<std::string>& hands) {
+  std::vector<CardDistribution> dists(hands.size());
+  for (size_t i = 0; i < hands.size(); i++)
+    dists[i].parse(hands[i]);
+  return dists;
+}
+
+}  // namespace
+
+TEST_CASE("visitor_sees_every_deal", "[ShowdownVisitor]") {
+  auto peval = makeEvaluator("h");
+  CardSet flop("2c7cTd");
+  std::vector<CardDistribution> dists = parseHands({"AcKc", "QdQh"});
+  TurnVisitor visitor(*peval, flop);
+  ShowdownEnumerator().visit(dists, flop, *peval, visitor);
+
+  // 45c2 deals, in blocks of 256
+  CHECK(visitor.sizes == std::vector<size_t>({256, 256, 256, 222}));
+  CHECK(visitor.total == 539.0);
+  // each runout has two cards, so every share is counted twice by card
+  double sum = 0.0;
+  for (const auto& card : visitor.byCard)
+    sum += card.second;
+  CHECK(sum == 2 * 539.0);
+  CHECK(visitor.byCard.size() == 45);
+}
+
+TEST_CASE("equity_visitor_takes_decided_tuples", "[ShowdownVisitor]") {
+  auto peval = makeEvaluator("h");
+  CardSet turn("AsAhKdKc");
+  std::vector<CardDistribution> dists = parseHands({"AcAd", "7h2s"});
+
+  // a visitor which declines decided tuples sees all 44 rivers
+  TurnVisitor all(*peval, turn);
+  ShowdownEnumerator().visit(dists, turn, *peval, all);
+  CHECK(all.total == 44.0);
+  CHECK(all.sizes == std::vector<size_t>({44}));
+
+  EquityVisitor equity(2);
+  ShowdownEnumerator().visit(dists, turn, *peval, equity);
+  CHECK(equity.results()[0].winShares == 44.0);
+  CHECK(equity.results()[1].winShares == 0.0);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,85 @@
+#include "side_pot_visitor.h"
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+TEST_CASE("side_pots_in_one_pass", "[SidePotVisitor]") {
+  auto peval = makeEvaluator("h");
+  std::vector<std::string> hands = {"AcKc", "QdQh", "JsTs"};
+  std::vector<CardDistribution> dists(hands.size());
+  for (size_t i = 0; i < hands.size(); i++)
+    dists[i].parse(hands[i]);
+  CardSet flop("2c7c8s");
+
+  Pot main;
+  main.amount = 300.0;
+  main.players = {0, 1, 2};
+  Pot side;
+  side.amount = 100.0;
+  side.players = {0, 1};
+  std::vector<std::vector<EquityResult>> pots =
+      ShowdownEnumerator().calculatePotEquity(dists, flop, *peval,
+                                              {main, side});
+  REQUIRE(pots.size() == 2);
+
+  // the main pot is the plain three way showdown
+  std::vector<EquityResult> all =
+      ShowdownEnumerator().calculateEquity(dists, flop, *peval);
+  for (size_t i = 0; i < hands.size(); i++) {
+    CHECK(pots[0][i].winShares == Approx(all[i].winShares));
+    CHECK(pots[0][i].tieShares == Approx(all[i].tieShares));
+  }
+
+  // the side pot goes to the better of the first two on each runout
+  CardSet dead = flop | CardSet("AcKcQdQhJsTs");
+  double wins[2] = {0.0, 0.0};
+  double deals = 0.0;
+  for (size_t a = 0; a < STANDARD_DECK_SIZE; a++) {
+    for (size_t b = 0; b < a; b++) {
+      CardSet runout(UINT64_C(1) << a | UINT64_C(1) << b);
+      if (runout.intersects(dead))
+        continue;
+      CardSet board = flop | runout;
+      PokerEvaluation e0 = peval->evaluateHand(CardSet("AcKc"), board).high();
+      PokerEvaluation e1 = peval->evaluateHand(CardSet("QdQh"), board).high();
+      wins[0] += e0 > e1 ? 1.0 : e0 == e1 ? 0.5 : 0.0;
+      wins[1] += e1 > e0 ? 1.0 : e0 == e1 ? 0.5 : 0.0;
+      deals += 1.0;
+    }
+  }
+  CHECK(deals == 903.0);  // 43c2
+  CHECK(pots[1][0].winShares + pots[1][0].tieShares == Approx(wins[0]));
+  CHECK(pots[1][1].winShares + pots[1][1].tieShares == Approx(wins[1]));
+  CHECK(pots[1][2].winShares + pots[1][2].tieShares == 0.0);
+
+  SidePotVisitor visitor({main, side}, hands.size());
+  ShowdownEnumerator().visit(dists, flop, *peval, visitor);
+  std::vector<double> won = visitor.winnings();
+  CHECK(won[0] + won[1] + won[2] == Approx(400.0));
+  CHECK(won[0] == Approx(300.0 * (all[0].winShares + all[0].tieShares) /
+                             deals +
+                         100.0 * wins[0] / deals));
+}
+
+TEST_CASE("side_pots_need_players", "[SidePotVisitor]") {
+  Pot pot;
+  CHECK_THROWS_AS(SidePotVisitor({pot}, 2), InvalidArgument);
+  pot.players = {0, 2};
+  CHECK_THROWS_AS(SidePotVisitor({pot}, 2), InvalidArgument);
+  CHECK_THROWS_AS(SidePotVisitor({}, 2), InvalidArgument);
+  // a repeated player would overrun the buffers of the award
+  pot.players = {0, 0};
+  CHECK_THROWS_AS(SidePotVisitor({pot}, 2), InvalidArgument);
+  pot.players = {0, 1, 0, 1};
+  CHECK_THROWS_AS(SidePotVisitor({pot}, 2), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,111 @@
+#include "street_cache.h"
+
+#include <catch.hpp>
+
+#include <nit/eval/make_evaluator.h>
+
+#include "showdown_enumerator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+std::vector<CardDistribution> parseHands(
+    const std::vector<std::string>& hands) {
+  std::vector<CardDistribution> dists(hands.size());
+  for (size_t i = 0; i < hands.size(); i++)
+    dists[i].parse(hands[i]);
+  return dists;
+}
+
+}  // namespace
+
+TEST_CASE("turns_from_the_flop", "[StreetCache]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists =
+      parseHands({"AcKc", "QdQh,JdJh,AsQs", "Th"});
+  CardSet flop("2c7c8s");
+  StreetCache cache;
+
+  std::vector<EquityResult> onflop = cache.calculateEquity(dists, flop, *peval);
+  std::vector<EquityResult> expected =
+      ShowdownEnumerator().calculateEquity(dists, flop, *peval);
+  for (size_t i = 0; i < dists.size(); i++) {
+    CHECK(onflop[i].winShares == Approx(expected[i].winShares));
+    CHECK(onflop[i].tieShares == Approx(expected[i].tieShares));
+  }
+  CHECK(cache.misses() == 1);
+
+  // every turn is the enumeration of the turn, without dealing again
+  for (size_t c = 0; c < STANDARD_DECK_SIZE; c++) {
+    CardSet turn(UINT64_C(1) << c);
+    if (flop.contains(turn))
+      continue;
+    CardSet board = flop | turn;
+    std::vector<EquityResult> cached =
+        cache.calculateEquity(dists, board, *peval);
+    expected = ShowdownEnumerator().calculateEquity(dists, board, *peval);
+    for (size_t i = 0; i < dists.size(); i++) {
+      CHECK(cached[i].winShares == Approx(expected[i].winShares));
+      CHECK(cached[i].tieShares == Approx(expected[i].tieShares));
+    }
+  }
+  CHECK(cache.hits() == STANDARD_DECK_SIZE - 3);
+  CHECK(cache.misses() == 1);
+
+  // the river is enumerated
+  cache.calculateEquity(dists, CardSet("2c7c8sTdJh"), *peval);
+  CHECK(cache.misses() == 1);
+}
+
+TEST_CASE("street_cache_hits_report_their_status", "[StreetCache]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists = parseHands({"AcKc", "QdQh,JdJh"});
+  CardSet flop("2c7c8s");
+  StreetCache cache;
+  EnumerationStatus status;
+  EnumerationOptions options;
+  options.status = &status;
+  cache.calculateEquity(dists, flop, *peval, options);
+  const uint64_t flopDeals = status.position;
+
+  for (const CardSet& board : {flop, CardSet("2c7c8sTd")}) {
+    EnumerationStatus expected;
+    EnumerationOptions direct;
+    direct.status = &expected;
+    ShowdownEnumerator().calculateEquity(dists, board, *peval, direct);
+    status = EnumerationStatus();
+    status.complete = false;
+    cache.calculateEquity(dists, board, *peval, options);
+    CHECK(status.complete);
+    CHECK(status.position == expected.position);
+    CHECK(status.fraction == 1.0);
+  }
+  CHECK(cache.hits() == 2);
+  CHECK(flopDeals == 2 * 990);  // 45c2 for each tuple
+}
+
+TEST_CASE("street_cache_is_bounded", "[StreetCache]") {
+  auto peval = makeEvaluator("h");
+  std::vector<CardDistribution> dists = parseHands({"AcKc", "QdQh"});
+  StreetCache cache(2);
+  cache.calculateEquity(dists, CardSet("2c7c8s"), *peval);
+  cache.calculateEquity(dists, CardSet("2d7d8h"), *peval);
+  cache.calculateEquity(dists, CardSet("2c7c8s"), *peval);
+  cache.calculateEquity(dists, CardSet("3s4s5s"), *peval);
+  CHECK(cache.size() == 2);
+  CHECK(cache.hits() == 1);
+
+  // the least recently used flop was dropped
+  cache.calculateEquity(dists, CardSet("2d7d8hTs"), *peval);
+  cache.calculateEquity(dists, CardSet("2c7c8sTs"), *peval);
+  CHECK(cache.hits() == 2);
+  CHECK(cache.misses() == 4);
+
+  cache.clear();
+  CHECK(cache.size() == 0);
+}
+
+}  // namespace test
+}  // namespace nit
@@ -0,0 +1,97 @@
+#include "caching_hand_evaluator.h"
+
+#include <random>
+#include <utility>
+
+#include <catch.hpp>
+
+#include <nit/error.h>
+
+#include "deuce_to_seven_hand_evaluator.h"
+#include "omaha_high_hand_evaluator.h"
+
+namespace nit {
+namespace test {
+
+TEST_CASE("caching_matches_inner", "[CachingHandEvaluator]") {
+  OmahaHighHandEvaluator omaha;
+  CachingHandEvaluator cached(omaha, 64);
+  CHECK(cached.capacity() == 64);
+  CHECK(cached.handSize() == omaha.handSize());
+  CHECK(cached.boardSize() == omaha.boardSize());
+
+  // a few hands on a few boards, each evaluated many times over
+  std::mt19937_64 rng(7);
+  std::vector<size_t> deck(STANDARD_DECK_SIZE);
+  for (size_t c = 0; c < deck.size(); c++)
+    deck[c] = c;
+  std::vector<CardSet> hands(8), boards(8);
+  for (size_t i = 0; i < hands.size(); i++) {
+    for (size_t c = 0; c < 9; c++) {
+      std::swap(deck[c], deck[c + rng() % (deck.size() - c)]);
+      (c < 4 ? hands[i] : boards[i]) |= CardSet(UINT64_C(1) << deck[c]);
+    }
+  }
+  for (size_t round = 0; round < 3; round++)
+    for (size_t i = 0; i < hands.size(); i++)
+      CHECK(cached.evaluateHand(hands[i], boards[i]).high() ==
+            omaha.evaluateHand(hands[i], boards[i]).high());
+  CHECK(cached.misses() == hands.size());
+  CHECK(cached.hits() == 2 * hands.size());
+
+  // the hand and the board are told apart
+  CardSet hand("AcKcQcJc");
+  CardSet board("2d3d4h5s6s");
+  CHECK(cached.evaluateHand(hand, board).high() !=
+        cached.evaluateHand(board, hand).high());
+
+  cached.clear();
+  CHECK(cached.hits() == 0);
+  CHECK(cached.misses() == 0);
+}
+
+TEST_CASE("caching_is_bounded", "[CachingHandEvaluator]") {
+  OmahaHighHandEvaluator omaha;
+  CachingHandEvaluator cached(omaha, 1);
+  CHECK(cached.capacity() == 4);  // one set of four ways
+
+  CardSet board("2d3d4h5s6s");
+  std::vector<CardSet> hands = {CardSet("AcKcQcJc"), CardSet("AhKhQhJh"),
+                                CardSet("AsKsQsJs"), CardSet("TcTh9c9h"),
+                                CardSet("8c8h7c7h")};
+  for (const CardSet& hand : hands)
+    cached.evaluateHand(hand, board);
+  CHECK(cached.misses() == 5);
+
+  // the first hand was dropped, the last four are kept
+  for (size_t i = 1; i < hands.size(); i++)
+    cached.evaluateHand(hands[i], board);
+  CHECK(cached.hits() == 4);
+  cached.evaluateHand(hands[0], board);
+  CHECK(cached.misses() == 6);
+}
+
+TEST_CASE("caching_forwards_to_inner", "[CachingHandEvaluator]") {
+  DeuceToSevenHandEvaluator lowball;
+  CachingHandEvaluator cached(lowball, 64);
+  CardSet hand("7c5d4h3s2c");
+  CHECK(cached.eval(hand) == lowball.eval(hand));
+  CHECK(cached.evaluate(hand).high() == lowball.evaluate(hand).high());
+
+  // the draws are the inner evaluator's, and clear the cache
+  cached.evaluateHand(hand);
+  cached.setNumDraws(3);
+  CHECK(lowball.numDraws() == 3);
+  CHECK(cached.numDraws() == 3);
+  CHECK(cached.misses() == 0);
+
+  // a const evaluator can not be changed through the cache
+  const DeuceToSevenHandEvaluator& fixed = lowball;
+  CachingHandEvaluator readonly(fixed, 64);
+  CHECK(readonly.eval(hand) == lowball.eval(hand));
+  CHECK_THROWS_AS(readonly.setNumDraws(1), LogicError);
+  CHECK(lowball.numDraws() == 3);
+}
+
+}  // namespace test
+}  // namespace nit
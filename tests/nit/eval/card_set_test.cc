@@ -1,7 +1,12 @@
 #include "card_set.h"
 
+#include <algorithm>
+
 #include <catch.hpp>
 
+#include "card.h"
+#include "poker_evaluation.h"
+
 namespace nit {
 namespace test {
 
@@ -71,5 +76,49 @@ TEST_CASE("fill", "[CardSetTest]") {
   CHECK(all.size() == STANDARD_DECK_SIZE);
 }
 
+TEST_CASE("colex", "[CardSetTest]") {
+  CHECK(CardSet().colex() == 0);
+  CHECK(CardSet("2c3c").colex() == 0);
+  CHECK(CardSet("Ac").colex() == 12);
+  CHECK(CardSet("AsKs").colex() == 1325);
+  CHECK(CardSet("QsKsAs").colex() == 22099);
+
+  // colex is a perfect index of the two card hands
+  std::vector<int> seen(1326, 0);
+  for (uint8_t i = 0; i < STANDARD_DECK_SIZE; i++)
+    for (uint8_t j = 0; j < i; j++)
+      seen.at(CardSet(Card(i)).insert(Card(j)).colex())++;
+  CHECK(std::count(seen.begin(), seen.end(), 1) == 1326);
+}
+
+TEST_CASE("highTypeBound", "[CardSetTest]") {
+  // with the other aces dead, one card only makes two pair, and another
+  // king on the board makes a full house possible
+  CHECK(CardSet("7h2sAsAhKd").highTypeBound(1, CardSet("AcAdKc")) ==
+        TWO_PAIR);
+  CHECK(CardSet("7h2sAsAhKdKc").highTypeBound(1, CardSet("AcAd")) ==
+        FULL_HOUSE);
+  CHECK(CardSet("2c3d9hJsKd").highTypeBound(0) == NO_PAIR);
+  CHECK(CardSet("2c3d4h5sKd").highTypeBound(1) == STRAIGHT);
+  CHECK(CardSet("2c3c4c5cKd").highTypeBound(1) == STRAIGHT_FLUSH);
+  CHECK(CardSet("2c3c4c5cKd").highTypeBound(1, CardSet("6cAc")) == FLUSH);
+
+  // the bound is never below the best hand of any runout
+  std::vector<CardSet> sets = {CardSet("7h2sAsAhKd"), CardSet("9c8cTd2h3s"),
+                               CardSet("QsJs4s4d8h"), CardSet("2c3d9hJsKdQc")};
+  CardSet dead("AcKs");
+  for (const CardSet& cards : sets) {
+    int bound = cards.highTypeBound(1, dead);
+    int best = -1;
+    for (uint8_t c = 0; c < STANDARD_DECK_SIZE; c++) {
+      CardSet card{Card(c)};
+      if (card.intersects(cards) || card.intersects(dead))
+        continue;
+      best = std::max(best, (cards | card).evaluateHigh().type());
+    }
+    CHECK(best <= bound);
+  }
+}
+
 }  // namespace test
 }  // namespace nit
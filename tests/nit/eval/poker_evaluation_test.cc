@@ -0,0 +1,164 @@
+#include "poker_evaluation.h"
+
+#include <algorithm>
+#include <climits>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+
+#include <nit/util/combinations.h>
+#include <nit/util/lastbit.h>
+
+#include "make_evaluator.h"
+#include "poker_evaluation_tables.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+int reduced(const char* hand) {
+  static auto peval = makeEvaluator("h");
+  return peval->evaluateHand(CardSet(hand), CardSet()).high().reducedCode2to7();
+}
+
+/// @returns the flipped code of a hand type with major, minor and kickers
+int flipped(int type, int major, int minor, int kickers) {
+  return INT_MAX - ((type << VSHIFT) ^ (major << MAJOR_SHIFT) ^
+                    (minor << MINOR_SHIFT) ^ kickers);
+}
+
+/// reducedCode2to7 as it was, with the ranks sorted in vectors
+int reducedCode2to7Vectors(const PokerEvaluation& e) {
+  const int code = e.code();
+  if (code == 0)
+    return 0;
+  const int kickers = e.kickerBits();
+  const int major = code >> MAJOR_SHIFT & 0x0F;
+  const int minor = code >> MINOR_SHIFT & 0x0F;
+  switch (e.type()) {
+    case NO_PAIR: {
+      int kick1 = topRankTable[kickers];
+      int kick2 = topRankTable[kickers ^ 0x01 << kick1];
+      int kick3 = topRankTable[kickers ^ 0x01 << kick1 ^ 0x01 << kick2];
+      int kbits = (0x01 << kick1) | (0x01 << kick2);
+      if (kick1 < 10)
+        kbits |= (0x01 << kick3);
+      return INT_MAX - ((code & ~0x1FFF) | kbits);
+    }
+
+    case THREE_OF_A_KIND: {
+      std::vector<int> ranks(3);
+      ranks[0] = botRankTable[kickers];
+      ranks[1] = botRankTable[kickers ^ 0x01 << ranks[0]];
+      ranks[2] = major;
+      std::sort(ranks.begin(), ranks.end());
+      return flipped(TWO_PAIR, ranks[2], ranks[1], 0x01 << ranks[0]);
+    }
+
+    case ONE_PAIR: {
+      std::vector<int> ranks(4);
+      uint16_t rest = static_cast<uint16_t>(kickers);
+      for (int i = 0; i < 3; i++) {
+        ranks[i] = lastbit(rest);
+        rest ^= 0x01 << ranks[i];
+      }
+      ranks[3] = major;
+      std::sort(ranks.begin(), ranks.end());
+      return flipped(ONE_PAIR, ranks[2], 0, (0x01 << ranks[0]) ^
+                                                (0x01 << ranks[1]));
+    }
+
+    case TWO_PAIR: {
+      std::vector<int> ranks(3);
+      ranks[0] = lastbit(static_cast<uint16_t>(kickers));
+      ranks[1] = minor;
+      ranks[2] = major;
+      std::sort(ranks.begin(), ranks.end());
+      return flipped(TWO_PAIR, ranks[2], ranks[1], 0x01 << ranks[0]);
+    }
+
+    case FLUSH:
+      return INT_MAX - ((code & ~0x1FFF) | 0x01 << topRankTable[kickers]);
+
+    case FULL_HOUSE:
+      return flipped(FULL_HOUSE, std::max(major, minor),
+                     std::min(major, minor), 0);
+
+    case FOUR_OF_A_KIND:
+      return flipped(FOUR_OF_A_KIND, major, 0,
+                     0x01 << lastbit(static_cast<uint16_t>(kickers)));
+
+    default:
+      return code;
+  }
+}
+
+}  // namespace
+
+TEST_CASE("PokerEvaluation.ReducedCode2to7", "[PokerEvaluation]") {
+  // the better deuce to seven hand has the higher code
+  CHECK(reduced("7c5d4h3s2c") > reduced("8c6d4h3s2c"));
+  CHECK(reduced("8c6d4h3s2c") > reduced("Kc5d4h3s2c"));
+  CHECK(reduced("Kc5d4h3s2c") > reduced("8c8d4h3s2c"));
+  CHECK(reduced("8c8d4h3s2c") > reduced("Ac9c7c5c3c"));
+  CHECK(reduced("Ac9c7c5c3c") > reduced("8c8d8h3s3c"));
+  CHECK(reduced("8c8d8h3s3c") > reduced("6c5d4h3s2c"));
+
+  // a pair only keeps the ranks of its three lowest cards
+  CHECK(reduced("2c2d4h3s7c") == reduced("8c8d4h3s2c"));
+  CHECK(reduced("2c2d2h3s4c") > reduced("8c8d4h4s2c"));
+  CHECK(PokerEvaluation().reducedCode2to7() == 0);
+}
+
+TEST_CASE("PokerEvaluation.ReducedCode2to7Unchanged", "[PokerEvaluation]") {
+  // the ranks of a five card hand make its code, along with a flush, so
+  // every code is made by one hand per multiset of ranks, with the suits
+  // dealt in turn, and by every flush
+  const char* ranks = "23456789TJQKA";
+  const char* suits = "cdhs";
+  std::vector<CardSet> hands;
+  combinations multisets(13 + 4, 5);
+  do {
+    std::string hand;
+    int i = 0;
+    for (uint64_t bits = multisets.getMask(); bits; bits &= bits - 1, i++) {
+      hand += ranks[lastbit(bits) - i];
+      hand += suits[i % 4];
+    }
+    CardSet cards(hand);
+    if (cards.size() == 5)
+      hands.push_back(cards);
+  } while (multisets.next());
+  combinations flushes(13, 5);
+  do {
+    std::string hand;
+    for (uint64_t bits = flushes.getMask(); bits; bits &= bits - 1)
+      hand += std::string(1, ranks[lastbit(bits)]) + "c";
+    hands.push_back(CardSet(hand));
+  } while (flushes.next());
+
+  std::set<int> codes;
+  for (const char* game : {"h", "k"}) {
+    auto peval = makeEvaluator(game);
+    for (const CardSet& hand : hands) {
+      PokerHandEvaluation e = peval->evaluateHand(hand, CardSet());
+      codes.insert(e.high().code());
+      codes.insert(e.low().code());
+    }
+  }
+
+  size_t mismatches = 0;
+  for (int code : codes) {
+    PokerEvaluation e(code);
+    if (e.reducedCode2to7() != reducedCode2to7Vectors(e))
+      mismatches++;
+  }
+  CHECK(codes.size() == 14925);
+  CHECK(mismatches == 0);
+}
+
+}  // namespace test
+}  // namespace nit
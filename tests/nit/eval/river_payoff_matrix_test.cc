@@ -0,0 +1,111 @@
+#include "river_payoff_matrix.h"
+
+#include <catch.hpp>
+
+#include "holdem_hand_evaluator.h"
+
+namespace nit {
+namespace test {
+
+namespace {
+
+/// every holding off the board whose colex index is a multiple of step
+std::vector<CardSet> someHoldings(const CardSet& board, size_t step,
+                                  size_t offset) {
+  std::vector<CardSet> hands;
+  for (size_t hi = 1; hi < STANDARD_DECK_SIZE; hi++) {
+    for (size_t lo = 0; lo < hi; lo++) {
+      CardSet hand(UINT64_C(1) << hi | UINT64_C(1) << lo);
+      if (!hand.intersects(board) && (hand.colex() + offset) % step == 0)
+        hands.push_back(hand);
+    }
+  }
+  return hands;
+}
+
+}  // namespace
+
+TEST_CASE("RiverPayoffMatrix.Payoffs", "[RiverPayoffMatrix]") {
+  // the board plays for a lot of hands, so there are plenty of ties
+  const CardSet board("AsKsQsJsTs");
+  const CardSet river("Th9h4c2s2d");
+  HoldemHandEvaluator peval;
+  for (const CardSet& b : {board, river}) {
+    const std::vector<CardSet> rows = someHoldings(b, 3, 0);
+    const std::vector<CardSet> cols = someHoldings(b, 5, 1);
+    RiverPayoffMatrix matrix(b, rows, cols);
+    REQUIRE(matrix.rows() == rows.size());
+    REQUIRE(matrix.cols() == cols.size());
+
+    std::vector<int8_t> dense = matrix.dense();
+    size_t nonzero = 0;
+    for (size_t i = 0; i < rows.size(); i += 7) {
+      PokerEvaluation r = peval.evaluateHand(rows[i], b).high();
+      for (size_t j = 0; j < cols.size(); j++) {
+        PokerEvaluation c = peval.evaluateHand(cols[j], b).high();
+        int expected =
+            rows[i].intersects(cols[j]) ? 0 : r > c ? 1 : r < c ? -1 : 0;
+        CHECK(dense[i * cols.size() + j] == expected);
+      }
+    }
+    for (int8_t p : dense)
+      nonzero += p != 0;
+    std::vector<PayoffEntry> sparse = matrix.sparse();
+    CHECK(sparse.size() == nonzero);
+    for (const PayoffEntry& e : sparse)
+      CHECK(dense[e.row * cols.size() + e.col] == e.payoff);
+
+    // the sorted sweeps agree with the dense products
+    std::vector<double> x(cols.size()), y(rows.size());
+    for (size_t j = 0; j < x.size(); j++)
+      x[j] = 1.0 + j % 7;
+    for (size_t i = 0; i < y.size(); i++)
+      y[i] = 0.5 + i % 3;
+    std::vector<double> mx = matrix.multiply(x);
+    std::vector<double> my = matrix.multiplyTransposed(y);
+    for (size_t i = 0; i < rows.size(); i++) {
+      double sum = 0.0;
+      for (size_t j = 0; j < cols.size(); j++)
+        sum += dense[i * cols.size() + j] * x[j];
+      CHECK(mx[i] == Approx(sum).margin(1e-9));
+    }
+    for (size_t j = 0; j < cols.size(); j++) {
+      double sum = 0.0;
+      for (size_t i = 0; i < rows.size(); i++)
+        sum += dense[i * cols.size() + j] * y[i];
+      CHECK(my[j] == Approx(sum).margin(1e-9));
+    }
+  }
+}
+
+TEST_CASE("RiverPayoffMatrix.SameRange", "[RiverPayoffMatrix]") {
+  // a hand against itself is blocked, and the matrix is antisymmetric
+  const CardSet board("Th9h4c2s2d");
+  const std::vector<CardSet> hands = someHoldings(board, 4, 0);
+  RiverPayoffMatrix matrix(board, hands, hands);
+  for (size_t i = 0; i < hands.size(); i++) {
+    CHECK(matrix.payoff(i, i) == 0);
+    for (size_t j = 0; j < i; j++)
+      CHECK(matrix.payoff(i, j) == -matrix.payoff(j, i));
+  }
+  const std::vector<uint32_t>& order = matrix.rowOrder();
+  for (size_t k = 1; k < order.size(); k++)
+    CHECK(matrix.rowStrength(order[k - 1]) <= matrix.rowStrength(order[k]));
+}
+
+TEST_CASE("RiverPayoffMatrix.Invalid", "[RiverPayoffMatrix]") {
+  const CardSet board("Th9h4c2s2d");
+  CHECK_THROWS_AS(RiverPayoffMatrix(CardSet("Th9h4c2s"), {}, {}),
+                  InvalidArgument);
+  CHECK_THROWS_AS(RiverPayoffMatrix(board, {CardSet("ThAs")}, {}),
+                  InvalidArgument);
+  CHECK_THROWS_AS(RiverPayoffMatrix(board, {}, {CardSet("AsKsQs")}),
+                  InvalidArgument);
+  RiverPayoffMatrix matrix(board, {CardSet("AsKs")}, {CardSet("QsJs")});
+  CHECK(matrix.payoff(0, 0) == 1);
+  CHECK_THROWS_AS(matrix.multiply({}), InvalidArgument);
+  CHECK_THROWS_AS(matrix.multiplyTransposed({1.0, 2.0}), InvalidArgument);
+}
+
+}  // namespace test
+}  // namespace nit
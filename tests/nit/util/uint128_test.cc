@@ -0,0 +1,40 @@
+#include "uint128.h"
+
+#include <catch.hpp>
+
+namespace nit {
+namespace test {
+
+TEST_CASE("uint128_add_carry", "[UInt128]") {
+  UInt128 a(UINT64_MAX);
+  a += UInt128(1);
+  CHECK(a.hi == 1);
+  CHECK(a.lo == 0);
+  a -= UInt128(1);
+  CHECK(a == UInt128(UINT64_MAX));
+  CHECK(UInt128(1) < a);
+}
+
+TEST_CASE("uint128_multiply", "[UInt128]") {
+  UInt128 p = UInt128::multiply(UINT64_MAX, UINT64_MAX);
+  CHECK(p.hi == UINT64_MAX - 1);
+  CHECK(p.lo == 1);
+  CHECK(UInt128::multiply(1u << 20, 1u << 20) == UInt128(UINT64_C(1) << 40));
+}
+
+TEST_CASE("uint128_decimal", "[UInt128]") {
+  UInt128 big(1, 0);
+  CHECK(big.str() == "18446744073709551616");
+  CHECK(UInt128().str() == "0");
+  CHECK(big.toDouble() == 18446744073709551616.0);
+
+  UInt128 parsed;
+  REQUIRE(UInt128::parse("340282366920938463463374607431768211455", parsed));
+  CHECK(parsed == UInt128(UINT64_MAX, UINT64_MAX));
+  CHECK_FALSE(UInt128::parse("340282366920938463463374607431768211456", parsed));
+  CHECK_FALSE(UInt128::parse("12x", parsed));
+  CHECK_FALSE(UInt128::parse("", parsed));
+}
+
+}  // namespace test
+}  // namespace nit